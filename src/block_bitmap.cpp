@@ -0,0 +1,143 @@
+#include "block_bitmap.hpp"
+
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/helper.hpp"
+
+#include <bitset>
+
+namespace duckdb {
+
+namespace {
+
+idx_t PopCount(uint64_t word) {
+	return std::bitset<64>(word).count();
+}
+
+// Index of the lowest set bit, word must not be 0
+idx_t CountTrailingZeros(uint64_t word) {
+	D_ASSERT(word != 0);
+	return PopCount((word & (~word + 1)) - 1);
+}
+
+} // namespace
+
+BlockBitmap::BlockBitmap(idx_t capacity) {
+	Reserve(capacity);
+}
+
+void BlockBitmap::Reserve(idx_t capacity) {
+	const idx_t word_count = (capacity + BITS_PER_WORD - 1) / BITS_PER_WORD;
+	if (word_count > words.size()) {
+		words.resize(word_count, 0);
+	}
+}
+
+bool BlockBitmap::Set(block_id_t block_id) {
+	D_ASSERT(block_id >= 0);
+	const auto block_idx = static_cast<idx_t>(block_id);
+	const idx_t word_idx = block_idx / BITS_PER_WORD;
+	if (word_idx >= words.size()) {
+		// Grow geometrically, so blocks beyond the initial estimate don't resize on every call
+		Reserve(MaxValue<idx_t>((word_idx + 1) * BITS_PER_WORD, Capacity() * 2));
+	}
+
+	const uint64_t mask = uint64_t(1) << (block_idx % BITS_PER_WORD);
+	auto &word = words[word_idx];
+	if (word & mask) {
+		return false;
+	}
+	word |= mask;
+	++count;
+
+	if (touched_begin == touched_end) {
+		touched_begin = word_idx;
+		touched_end = word_idx + 1;
+	} else {
+		touched_begin = MinValue(touched_begin, word_idx);
+		touched_end = MaxValue(touched_end, word_idx + 1);
+	}
+	return true;
+}
+
+bool BlockBitmap::Test(block_id_t block_id) const {
+	if (block_id < 0) {
+		return false;
+	}
+	const auto block_idx = static_cast<idx_t>(block_id);
+	const idx_t word_idx = block_idx / BITS_PER_WORD;
+	if (word_idx >= words.size()) {
+		return false;
+	}
+	return (words[word_idx] >> (block_idx % BITS_PER_WORD)) & 1;
+}
+
+void BlockBitmap::Clear() {
+	for (idx_t word_idx = touched_begin; word_idx < touched_end; ++word_idx) {
+		words[word_idx] = 0;
+	}
+	count = 0;
+	touched_begin = 0;
+	touched_end = 0;
+}
+
+void BlockBitmap::Union(const BlockBitmap &other) {
+	if (other.touched_begin == other.touched_end) {
+		return;
+	}
+	Reserve(other.touched_end * BITS_PER_WORD);
+	for (idx_t word_idx = other.touched_begin; word_idx < other.touched_end; ++word_idx) {
+		words[word_idx] |= other.words[word_idx];
+	}
+	if (touched_begin == touched_end) {
+		touched_begin = other.touched_begin;
+		touched_end = other.touched_end;
+	} else {
+		touched_begin = MinValue(touched_begin, other.touched_begin);
+		touched_end = MaxValue(touched_end, other.touched_end);
+	}
+	RecountTouchedRange();
+}
+
+void BlockBitmap::Intersect(const BlockBitmap &other) {
+	for (idx_t word_idx = touched_begin; word_idx < touched_end; ++word_idx) {
+		words[word_idx] &= word_idx < other.words.size() ? other.words[word_idx] : 0;
+	}
+	RecountTouchedRange();
+}
+
+idx_t BlockBitmap::IntersectionCount(const BlockBitmap &other) const {
+	const idx_t begin = MaxValue(touched_begin, other.touched_begin);
+	const idx_t end = MinValue(touched_end, other.touched_end);
+	idx_t result = 0;
+	for (idx_t word_idx = begin; word_idx < end; ++word_idx) {
+		result += PopCount(words[word_idx] & other.words[word_idx]);
+	}
+	return result;
+}
+
+idx_t BlockBitmap::FindNext(idx_t start, idx_t end, bool value) const {
+	idx_t position = start;
+	while (position < end) {
+		const idx_t word_idx = position / BITS_PER_WORD;
+		uint64_t word = word_idx < words.size() ? words[word_idx] : 0;
+		if (!value) {
+			word = ~word;
+		}
+		// Ignore the bits before position
+		word &= ~uint64_t(0) << (position % BITS_PER_WORD);
+		if (word != 0) {
+			return MinValue(word_idx * BITS_PER_WORD + CountTrailingZeros(word), end);
+		}
+		position = (word_idx + 1) * BITS_PER_WORD;
+	}
+	return end;
+}
+
+void BlockBitmap::RecountTouchedRange() {
+	count = 0;
+	for (idx_t word_idx = touched_begin; word_idx < touched_end; ++word_idx) {
+		count += PopCount(words[word_idx]);
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,190 @@
+#include "block_usage.hpp"
+#include "index_storage.hpp"
+#include "inspection_profile.hpp"
+#include "util.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/catalog/default/default_schemas.hpp"
+#include "duckdb/storage/table_storage_info.hpp"
+
+#include <cmath>
+
+namespace duckdb {
+
+namespace {
+
+// Extrapolates the table data bytes of a table from a sample of its row groups. Sampled row groups are measured by
+// the blocks they add to the catalog-wide table blocks, as unsampled inspections count them, so sampling every row
+// group reproduces the exact figure.
+SampleEstimate EstimateTableData(const SegmentSnapshot::SampledSegments &sampled, idx_t block_alloc_size,
+                                 BlockBitmap &table_blocks) {
+	const auto sampled_values = MeasureSampledBlocks(sampled.sample, sampled.segments, block_alloc_size, table_blocks);
+	return ExtrapolateTotal(sampled.sample, sampled_values, sampled.row_group_count);
+}
+
+// Count physical metadata blocks
+// Each MetadataBlockInfo entry represents one physical block.
+idx_t CountMetadataBlocks(const vector<MetadataBlockInfo> &metadata_info) {
+	return metadata_info.size();
+}
+
+} // namespace
+
+BlockUsageInspection::BlockUsageInspection(RowGroupSampling sampling_p, InspectionDeadline deadline_p,
+                                           optional_ptr<InspectionProfile> profile_p)
+    : sampling(sampling_p), deadline(deadline_p), profile(profile_p) {
+}
+
+CachedBlockUsageResult::ResultPtr BlockUsageInspection::Prepare(ClientContext &context, Catalog &catalog_p) {
+	// Between checkpoints and schema changes the breakdown cannot change, serve it from the cache
+	version = ResultVersion::Get(context, catalog_p);
+	if (!sampling.IsEnabled()) {
+		ScopedPhaseTimer timer(profile, InspectionPhase::RESULT_CACHE);
+		auto cached_result = CachedBlockUsageResult::Lookup(context, catalog_p, version);
+		if (cached_result) {
+			if (profile) {
+				profile->Add(InspectionCounter::RESULT_CACHE_HITS, 1);
+			}
+			return cached_result;
+		}
+	}
+
+	catalog = &catalog_p;
+	ScopedPhaseTimer catalog_timer(profile, InspectionPhase::CATALOG_SCAN);
+
+	// Get database size info
+	database_size = catalog->GetDatabaseSize(context);
+
+	// Count metadata blocks
+	const auto metadata_info = catalog->GetMetadataInfo(context);
+	metadata_blocks = CountMetadataBlocks(metadata_info);
+
+	// Collect all tables, they're inspected in Compute()
+	snapshot = SegmentSnapshot::Get(context, *catalog);
+	auto schemas = catalog->GetSchemas(context);
+	for (auto &schema_ref : schemas) {
+		auto &schema = schema_ref.get();
+
+		// Skip internal schemas
+		if (DefaultSchemaGenerator::IsDefaultSchema(schema.name)) {
+			continue;
+		}
+
+		schema.Scan(context, CatalogType::TABLE_ENTRY,
+		            [&](CatalogEntry &entry) { tables.emplace_back(entry.Cast<TableCatalogEntry>()); });
+	}
+	return nullptr;
+}
+
+// Collects the blocks used by table data and by indexes across all tables.
+// Small segments and index buffers of different tables can share a block, so both are collected catalog-wide.
+// With sampling, only the blocks of sampled row groups are collected, and the table data estimate of all tables
+// is summed into table_data. Returns false if tables were skipped because the deadline passed.
+bool BlockUsageInspection::CollectDataBlocks(ClientContext &context, BlockBitmap &table_blocks,
+                                             BlockBitmap &index_blocks, SampleEstimate &table_data) {
+	const idx_t block_alloc_size = database_size.block_size;
+	for (auto &table_ref : tables) {
+		CheckInterrupted(context);
+		if (deadline.Passed()) {
+			return false;
+		}
+
+		auto &table = table_ref.get();
+		// Sampled inspections only walk the segments of the sampled row groups
+		idx_t segment_count;
+		if (sampling.IsEnabled()) {
+			SegmentSnapshot::SampledSegments sampled;
+			{
+				ScopedPhaseTimer timer(profile, InspectionPhase::SEGMENT_COLLECTION);
+				sampled = snapshot->GetSampledSegments(context, table, sampling);
+			}
+			ScopedPhaseTimer timer(profile, InspectionPhase::BLOCK_COUNTING);
+			table_data.Add(EstimateTableData(sampled, block_alloc_size, table_blocks));
+			segment_count = sampled.segments.size();
+		} else {
+			SegmentSnapshot::TableSegments segment_info;
+			{
+				ScopedPhaseTimer timer(profile, InspectionPhase::SEGMENT_COLLECTION);
+				segment_info = snapshot->GetTableSegments(context, table);
+			}
+			ScopedPhaseTimer timer(profile, InspectionPhase::BLOCK_COUNTING);
+			CollectSegmentBlocks(*segment_info, table_blocks);
+			segment_count = segment_info->size();
+		}
+		{
+			ScopedPhaseTimer timer(profile, InspectionPhase::INDEX_WALK);
+			CollectIndexBlocks(table, index_blocks);
+		}
+		if (profile) {
+			profile->Add(InspectionCounter::TABLES_VISITED, 1);
+			profile->Add(InspectionCounter::SEGMENTS_VISITED, segment_count);
+		}
+	}
+	return true;
+}
+
+shared_ptr<BlockUsageResult> BlockUsageInspection::Compute(ClientContext &context) {
+	D_ASSERT(catalog);
+	const idx_t total_blocks = database_size.total_blocks;
+	const idx_t free_blocks = database_size.free_blocks;
+	const idx_t block_alloc_size = database_size.block_size;
+
+	// Count table data and index blocks (unique block IDs across all tables).
+	// A block shared by table data and an index buffer is attributed to table data.
+	BlockBitmap table_blocks(total_blocks);
+	BlockBitmap index_blocks(total_blocks);
+	SampleEstimate table_data;
+	const bool complete = CollectDataBlocks(context, table_blocks, index_blocks, table_data);
+	if (profile) {
+		profile->Add(InspectionCounter::UNIQUE_BLOCKS, table_blocks.Count() + index_blocks.Count());
+		profile->Add(InspectionCounter::BLOCK_SET_BYTES, (table_blocks.Capacity() + index_blocks.Capacity()) / 8);
+	}
+	const idx_t index_only_blocks = index_blocks.Count() - index_blocks.IntersectionCount(table_blocks);
+	BlockUsageEntry table_data_entry("table_data", table_blocks.Count());
+	if (sampling.IsEnabled()) {
+		const auto to_blocks = [&](double bytes) {
+			return static_cast<idx_t>(std::llround(bytes / static_cast<double>(block_alloc_size)));
+		};
+		table_data_entry.block_count = to_blocks(table_data.estimate);
+		table_data_entry.has_interval = table_data.has_variance;
+		if (table_data.has_variance) {
+			table_data_entry.low_blocks = to_blocks(table_data.Low());
+			table_data_entry.high_blocks = to_blocks(table_data.High());
+		}
+	}
+
+	// Blocks referenced by no component. Counts are measured independently, so they can exceed the total if the
+	// storage reports inconsistent information; unaccounted is then zero rather than wrapping around.
+	const idx_t other_blocks = index_only_blocks + metadata_blocks + free_blocks;
+	const auto unaccounted_blocks = [&](idx_t table_data_blocks) {
+		const idx_t used_blocks = table_data_blocks + other_blocks;
+		return used_blocks < total_blocks ? total_blocks - used_blocks : 0;
+	};
+	BlockUsageEntry unaccounted_entry("unaccounted", unaccounted_blocks(table_data_entry.block_count));
+	// More table data leaves fewer blocks unaccounted, so the bounds swap
+	unaccounted_entry.has_interval = table_data_entry.has_interval;
+	unaccounted_entry.low_blocks = unaccounted_blocks(table_data_entry.high_blocks);
+	unaccounted_entry.high_blocks = unaccounted_blocks(table_data_entry.low_blocks);
+
+	// Build entries
+	auto usage = make_shared_ptr<BlockUsageResult>();
+	usage->total_blocks = total_blocks;
+	usage->block_alloc_size = block_alloc_size;
+	usage->timed_out = !complete;
+	usage->entries.reserve(6);
+	usage->entries.push_back(table_data_entry);
+	usage->entries.emplace_back("index", index_only_blocks);
+	usage->entries.emplace_back("metadata", metadata_blocks);
+	usage->entries.emplace_back("free_blocks", free_blocks);
+	usage->entries.push_back(unaccounted_entry);
+	usage->entries.emplace_back("total", total_blocks);
+
+	if (!sampling.IsEnabled() && complete) {
+		CachedBlockUsageResult::Store(context, *catalog, version, usage);
+	}
+	return usage;
+}
+
+} // namespace duckdb
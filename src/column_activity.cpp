@@ -0,0 +1,206 @@
+#include "column_activity.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/common/types/vector.hpp"
+#include "duckdb/function/table/table_scan.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/optimizer/optimizer_extension.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
+
+namespace duckdb {
+
+namespace {
+
+bool IsTrackingEnabled(ClientContext &context) {
+	Value enabled;
+	if (!context.TryGetCurrentSetting(TRACK_COLUMN_ACTIVITY_SETTING, enabled) || enabled.IsNull()) {
+		return false;
+	}
+	return BooleanValue::Get(enabled);
+}
+
+// The regular table scan, which the counting wrapper calls
+table_function_t GetTableScan() {
+	static const table_function_t table_scan = TableScanFunction::GetFunction().function;
+	return table_scan;
+}
+
+// Bind data of a counting table scan: the table scan's own bind data, and the counters of its output columns in
+// output order, null for columns that aren't table columns. The counters are resolved while optimizing, so scanning
+// threads only add to them.
+struct CountingScanBindData : public TableScanBindData {
+	CountingScanBindData(const TableScanBindData &bind_data,
+	                     vector<shared_ptr<ColumnActivityCounters>> output_columns_p)
+	    : TableScanBindData(bind_data), output_columns(std::move(output_columns_p)) {
+	}
+
+	vector<shared_ptr<ColumnActivityCounters>> output_columns;
+
+	unique_ptr<FunctionData> Copy() const override {
+		return make_uniq<CountingScanBindData>(*this, output_columns);
+	}
+};
+
+void CountingTableScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	GetTableScan()(context, data, output);
+	if (output.size() == 0) {
+		return;
+	}
+	const auto &output_columns = data.bind_data->Cast<CountingScanBindData>().output_columns;
+	const idx_t column_count = MinValue<idx_t>(output.ColumnCount(), output_columns.size());
+	for (idx_t column_idx = 0; column_idx < column_count; ++column_idx) {
+		auto &counters = output_columns[column_idx];
+		if (!counters) {
+			continue;
+		}
+		counters->rows_scanned.fetch_add(output.size(), std::memory_order_relaxed);
+		counters->bytes_scanned.fetch_add(ColumnActivity::MeasureValueBytes(output.data[column_idx], output.size()),
+		                                  std::memory_order_relaxed);
+	}
+}
+
+// Swaps the function of a table scan for the counting wrapper, and its bind data for one with the counters of its
+// output columns
+void InstrumentTableScan(ColumnActivity &activity, LogicalGet &get) {
+	if (get.function.function != GetTableScan() || !get.bind_data) {
+		return;
+	}
+	auto table = get.GetTable();
+	if (!table) {
+		return;
+	}
+	const auto &database_name = table->ParentCatalog().GetName();
+	const auto &schema_name = table->ParentSchema().name;
+
+	// With projection ids, columns only needed by pushed-down filters are not part of the output
+	const auto &column_ids = get.GetColumnIds();
+	vector<idx_t> output_columns;
+	if (get.projection_ids.empty()) {
+		for (idx_t column_idx = 0; column_idx < column_ids.size(); ++column_idx) {
+			output_columns.push_back(column_idx);
+		}
+	} else {
+		output_columns = get.projection_ids;
+	}
+
+	vector<shared_ptr<ColumnActivityCounters>> counters;
+	for (const auto column_idx : output_columns) {
+		const idx_t table_column = column_ids[column_idx].GetPrimaryIndex();
+		// The row id and other virtual columns aren't table columns
+		if (table_column >= get.names.size()) {
+			counters.push_back(nullptr);
+			continue;
+		}
+		counters.push_back(activity.GetCounters(database_name, schema_name, table->name, get.names[table_column]));
+	}
+	get.bind_data = make_uniq<CountingScanBindData>(get.bind_data->Cast<TableScanBindData>(), std::move(counters));
+	get.function.function = CountingTableScan;
+}
+
+void InstrumentPlan(ColumnActivity &activity, LogicalOperator &op) {
+	if (op.type == LogicalOperatorType::LOGICAL_GET) {
+		InstrumentTableScan(activity, op.Cast<LogicalGet>());
+	}
+	for (auto &child : op.children) {
+		InstrumentPlan(activity, *child);
+	}
+}
+
+void ColumnActivityOptimize(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
+	if (!plan || !IsTrackingEnabled(input.context)) {
+		return;
+	}
+	auto activity = ColumnActivity::Get(input.context);
+	InstrumentPlan(*activity, *plan);
+}
+
+} // namespace
+
+string ColumnActivity::ObjectType() {
+	return "table_inspector_column_activity";
+}
+
+string ColumnActivity::GetObjectType() {
+	return ObjectType();
+}
+
+optional_idx ColumnActivity::GetEstimatedCacheMemory() const {
+	return optional_idx();
+}
+
+shared_ptr<ColumnActivity> ColumnActivity::Get(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<ColumnActivity>(ObjectType());
+}
+
+void ColumnActivity::RegisterOptimizer(DBConfig &config) {
+	OptimizerExtension extension;
+	extension.optimize_function = ColumnActivityOptimize;
+	config.optimizer_extensions.push_back(std::move(extension));
+}
+
+shared_ptr<ColumnActivityCounters> ColumnActivity::GetCounters(const string &database_name,
+                                                               const string &schema_name, const string &table_name,
+                                                               const string &column_name) {
+	// Names can't contain a null byte
+	string key = database_name;
+	key += '\0';
+	key += schema_name;
+	key += '\0';
+	key += table_name;
+	key += '\0';
+	key += column_name;
+
+	lock_guard<mutex> guard(lock);
+	auto entry = column_index.find(key);
+	if (entry != column_index.end()) {
+		return columns[entry->second].counters;
+	}
+	ColumnEntry column;
+	column.names.database_name = database_name;
+	column.names.schema_name = schema_name;
+	column.names.table_name = table_name;
+	column.names.column_name = column_name;
+	column.counters = make_shared_ptr<ColumnActivityCounters>();
+	column_index.emplace(std::move(key), columns.size());
+	columns.push_back(column);
+	return column.counters;
+}
+
+vector<ColumnActivityRow> ColumnActivity::GetRows() const {
+	lock_guard<mutex> guard(lock);
+	vector<ColumnActivityRow> result;
+	result.reserve(columns.size());
+	for (const auto &column : columns) {
+		auto row = column.names;
+		row.rows_scanned = column.counters->rows_scanned.load(std::memory_order_relaxed);
+		row.bytes_scanned = column.counters->bytes_scanned.load(std::memory_order_relaxed);
+		result.push_back(std::move(row));
+	}
+	return result;
+}
+
+idx_t ColumnActivity::MeasureValueBytes(Vector &vector, idx_t count) {
+	const auto physical_type = vector.GetType().InternalType();
+	if (physical_type == PhysicalType::VARCHAR) {
+		UnifiedVectorFormat format;
+		vector.ToUnifiedFormat(count, format);
+		const auto strings = UnifiedVectorFormat::GetData<string_t>(format);
+		idx_t result = 0;
+		for (idx_t row_idx = 0; row_idx < count; ++row_idx) {
+			const auto idx = format.sel->get_index(row_idx);
+			if (format.validity.RowIsValid(idx)) {
+				result += strings[idx].GetSize();
+			}
+		}
+		return result;
+	}
+	if (TypeIsConstantSize(physical_type)) {
+		return count * GetTypeIdSize(physical_type);
+	}
+	return 0;
+}
+
+} // namespace duckdb
@@ -0,0 +1,244 @@
+#include "database_file_reader.hpp"
+
+#include "duckdb/common/checksum.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/helper.hpp"
+
+#include <cstring>
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// Single-file storage layout
+//===--------------------------------------------------------------------===//
+
+// [main header][database header 1][database header 2][block 0][block 1]...
+// Every header sector and every block starts with a checksum of the rest of it. The main header holds the magic
+// bytes and flags; the database header with the higher iteration is the active one.
+constexpr idx_t FILE_HEADER_SIZE = 4096;
+constexpr idx_t CHECKSUM_SIZE = sizeof(uint64_t);
+constexpr idx_t BLOCK_START = FILE_HEADER_SIZE * 3;
+constexpr idx_t DEFAULT_BLOCK_ALLOC_SIZE = 262144;
+constexpr idx_t MIN_BLOCK_ALLOC_SIZE = 16384;
+
+constexpr const char MAGIC_BYTES[] = "DUCK";
+constexpr idx_t MAGIC_BYTE_SIZE = 4;
+// Offset of the first flags word: checksum, magic bytes, version number
+constexpr idx_t MAIN_HEADER_FLAGS_OFFSET = CHECKSUM_SIZE + MAGIC_BYTE_SIZE + sizeof(uint64_t);
+constexpr uint64_t ENCRYPTED_DATABASE_FLAG = 1;
+
+// Metadata blocks are split into 64 sub-blocks; a pointer stores the sub-block index in its top byte
+constexpr idx_t METADATA_BLOCK_COUNT = 64;
+constexpr idx_t METADATA_INDEX_SHIFT = 56;
+constexpr idx_t METADATA_BLOCK_ID_MASK = (idx_t(1) << METADATA_INDEX_SHIFT) - 1;
+
+// Reads a value stream that spans a chain of metadata sub-blocks. Every sub-block starts with the pointer to the
+// next sub-block of the chain.
+class MetadataChainReader {
+public:
+	MetadataChainReader(DatabaseFileReader &file_p, const DatabaseFileInfo &info, idx_t pointer)
+	    : file(file_p), block_alloc_size(info.block_alloc_size), block_count(info.block_count),
+	      sub_block_size(AlignValueFloor((info.block_alloc_size - CHECKSUM_SIZE) / METADATA_BLOCK_COUNT)),
+	      buffer(sub_block_size), offset(0), next_pointer(pointer), sub_blocks_read(0) {
+		LoadNext();
+	}
+
+	template <class T>
+	T Read() {
+		T value;
+		ReadData(reinterpret_cast<data_ptr_t>(&value), sizeof(T));
+		return value;
+	}
+
+private:
+	void ReadData(data_ptr_t target, idx_t size) {
+		while (size > 0) {
+			if (offset == sub_block_size) {
+				LoadNext();
+			}
+			const idx_t to_read = MinValue<idx_t>(size, sub_block_size - offset);
+			memcpy(target, buffer.data() + offset, to_read);
+			target += to_read;
+			size -= to_read;
+			offset += to_read;
+		}
+	}
+
+	void LoadNext() {
+		if (next_pointer == DConstants::INVALID_INDEX) {
+			throw IOException("Metadata chain ended unexpectedly while reading the free list");
+		}
+		// Every sub-block is read at most once, anything longer is a cycle
+		if (++sub_blocks_read > block_count * METADATA_BLOCK_COUNT) {
+			throw IOException("Metadata chain of the free list contains a cycle");
+		}
+		const idx_t block_id = next_pointer & METADATA_BLOCK_ID_MASK;
+		const idx_t index = next_pointer >> METADATA_INDEX_SHIFT;
+		if (block_id >= block_count || index >= METADATA_BLOCK_COUNT) {
+			throw IOException("Metadata pointer %llu is out of range for a file with %llu blocks", next_pointer,
+			                  block_count);
+		}
+		const idx_t location = BLOCK_START + block_id * block_alloc_size + CHECKSUM_SIZE + index * sub_block_size;
+		file.ReadAt(buffer.data(), sub_block_size, location);
+		next_pointer = Load<idx_t>(buffer.data());
+		offset = sizeof(idx_t);
+	}
+
+	DatabaseFileReader &file;
+	const idx_t block_alloc_size;
+	const idx_t block_count;
+	const idx_t sub_block_size;
+	vector<data_t> buffer;
+	idx_t offset;
+	idx_t next_pointer;
+	idx_t sub_blocks_read;
+};
+
+} // namespace
+
+idx_t DatabaseFileInfo::GetBlockLocation(idx_t block_id) const {
+	return BLOCK_START + block_id * block_alloc_size;
+}
+
+idx_t DatabaseFileInfo::GetBlockDataLocation(idx_t block_id) const {
+	return GetBlockLocation(block_id) + CHECKSUM_SIZE;
+}
+
+idx_t DatabaseFileInfo::GetBlockDataSize() const {
+	return block_alloc_size - CHECKSUM_SIZE;
+}
+
+DatabaseFileReader::DatabaseFileReader(FileSystem &fs, const string &path_p) : path(path_p) {
+	handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+	file_size = NumericCast<idx_t>(handle->GetFileSize());
+}
+
+DatabaseFileReader::~DatabaseFileReader() {
+}
+
+void DatabaseFileReader::ReadAt(data_ptr_t buffer, idx_t size, idx_t location) {
+	if (location + size > file_size) {
+		throw IOException("Database file \"%s\" is truncated: cannot read %llu bytes at offset %llu of %llu", path,
+		                  size, location, file_size);
+	}
+	handle->Read(buffer, size, location);
+}
+
+void DatabaseFileReader::ReadMainHeader() {
+	data_t header[FILE_HEADER_SIZE];
+	if (file_size < BLOCK_START) {
+		throw InvalidInputException("\"%s\" is not a DuckDB database file: the file is too small", path);
+	}
+	ReadAt(header, FILE_HEADER_SIZE, 0);
+	if (memcmp(header + CHECKSUM_SIZE, MAGIC_BYTES, MAGIC_BYTE_SIZE) != 0) {
+		throw InvalidInputException("\"%s\" is not a DuckDB database file", path);
+	}
+	const auto flags = Load<uint64_t>(header + MAIN_HEADER_FLAGS_OFFSET);
+	if (flags & ENCRYPTED_DATABASE_FLAG) {
+		throw InvalidInputException("\"%s\" is an encrypted database file, which inspect_file() cannot read.\n"
+		                            "Attach it with its key and use inspect_block_usage() instead.",
+		                            path);
+	}
+}
+
+void DatabaseFileReader::ReadDatabaseHeader(DatabaseFileInfo &info) {
+	bool found = false;
+	for (idx_t header_idx = 1; header_idx <= 2; ++header_idx) {
+		data_t header[FILE_HEADER_SIZE];
+		ReadAt(header, FILE_HEADER_SIZE, header_idx * FILE_HEADER_SIZE);
+
+		// A torn header write leaves a bad checksum, the other header is then the active one
+		const auto stored_checksum = Load<uint64_t>(header);
+		if (stored_checksum != Checksum(header + CHECKSUM_SIZE, FILE_HEADER_SIZE - CHECKSUM_SIZE)) {
+			continue;
+		}
+
+		data_ptr_t ptr = header + CHECKSUM_SIZE;
+		const auto iteration = Load<uint64_t>(ptr);
+		if (found && iteration <= info.iteration) {
+			continue;
+		}
+		found = true;
+		info.iteration = iteration;
+		info.meta_block = Load<idx_t>(ptr + sizeof(uint64_t));
+		info.free_list_pointer = Load<idx_t>(ptr + 2 * sizeof(uint64_t));
+		info.block_count = Load<uint64_t>(ptr + 3 * sizeof(uint64_t));
+		info.block_alloc_size = Load<idx_t>(ptr + 4 * sizeof(uint64_t));
+		info.vector_size = Load<idx_t>(ptr + 5 * sizeof(uint64_t));
+		info.serialization_compatibility = Load<idx_t>(ptr + 6 * sizeof(uint64_t));
+	}
+	if (!found) {
+		throw IOException("Database file \"%s\" has no valid database header", path);
+	}
+
+	// Files written before the block size became configurable leave it unset
+	if (info.block_alloc_size == 0) {
+		info.block_alloc_size = DEFAULT_BLOCK_ALLOC_SIZE;
+	}
+	if (info.block_alloc_size < MIN_BLOCK_ALLOC_SIZE || !IsPowerOfTwo(info.block_alloc_size)) {
+		throw IOException("Database file \"%s\" has an invalid block size of %llu bytes", path,
+		                  info.block_alloc_size);
+	}
+}
+
+void DatabaseFileReader::ReadFreeList(DatabaseFileInfo &info) {
+	// Databases that never wrote metadata have no free list
+	if (info.free_list_pointer == DConstants::INVALID_INDEX) {
+		return;
+	}
+
+	// Counts are validated against the block count so that a corrupt file cannot trigger huge allocations
+	auto read_count = [&](MetadataChainReader &reader, const char *list_name) {
+		const auto count = reader.Read<uint64_t>();
+		if (count > info.block_count) {
+			throw IOException("Database file \"%s\" lists %llu %s for %llu blocks", path, count, list_name,
+			                  info.block_count);
+		}
+		return count;
+	};
+	// Block ids end up as bitmap indexes, so they are validated the same way
+	auto read_block_id = [&](MetadataChainReader &reader, const char *list_name) {
+		const auto block_id = reader.Read<block_id_t>();
+		if (block_id < 0 || static_cast<idx_t>(block_id) >= info.block_count) {
+			throw IOException("Database file \"%s\" lists block %lld among its %s, but has only %llu blocks", path,
+			                  static_cast<int64_t>(block_id), list_name, info.block_count);
+		}
+		return block_id;
+	};
+
+	MetadataChainReader reader(*this, info, info.free_list_pointer);
+
+	const auto free_count = read_count(reader, "free blocks");
+	info.free_blocks.reserve(free_count);
+	for (idx_t i = 0; i < free_count; ++i) {
+		info.free_blocks.push_back(read_block_id(reader, "free blocks"));
+	}
+
+	// Blocks shared by several owners, with their reference count. They are not separate blocks.
+	const auto multi_use_count = read_count(reader, "multi-use blocks");
+	for (idx_t i = 0; i < multi_use_count; ++i) {
+		reader.Read<block_id_t>();
+		reader.Read<uint32_t>();
+	}
+
+	// Metadata blocks, with the bitmask of their free sub-blocks
+	const auto metadata_count = read_count(reader, "metadata blocks");
+	info.metadata_blocks.reserve(metadata_count);
+	for (idx_t i = 0; i < metadata_count; ++i) {
+		info.metadata_blocks.push_back(read_block_id(reader, "metadata blocks"));
+		reader.Read<idx_t>();
+	}
+}
+
+DatabaseFileInfo DatabaseFileReader::Read() {
+	DatabaseFileInfo info;
+	ReadMainHeader();
+	ReadDatabaseHeader(info);
+	ReadFreeList(info);
+	return info;
+}
+
+} // namespace duckdb
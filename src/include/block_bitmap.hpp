@@ -0,0 +1,57 @@
+#pragma once
+
+#include "duckdb/common/types.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+// Dense set of block IDs, one bit per block.
+// Persistent block IDs are dense integers in [0, total_blocks), so a bitmap sized from DatabaseSize::total_blocks
+// replaces a hash set without per-entry allocations. The bitmap grows on demand if a larger ID shows up.
+// Clear() keeps the allocation and only resets the touched range, so one bitmap can be reused across tables.
+class BlockBitmap {
+public:
+	BlockBitmap() = default;
+	explicit BlockBitmap(idx_t capacity);
+
+public:
+	// Reserves room for block IDs in [0, capacity).
+	void Reserve(idx_t capacity);
+	// Adds a block ID. Returns true if it was not in the set yet.
+	bool Set(block_id_t block_id);
+	bool Test(block_id_t block_id) const;
+	// Number of block IDs in the set.
+	idx_t Count() const {
+		return count;
+	}
+	// Number of block IDs the bitmap can hold without growing.
+	idx_t Capacity() const {
+		return words.size() * BITS_PER_WORD;
+	}
+	// Removes all block IDs, keeping the allocation.
+	void Clear();
+
+	// In-place set operations.
+	void Union(const BlockBitmap &other);
+	void Intersect(const BlockBitmap &other);
+	// Number of block IDs present in both bitmaps.
+	idx_t IntersectionCount(const BlockBitmap &other) const;
+
+	// Returns the first block ID in [start, end) whose bit equals value, or end if there is none.
+	// Scans a word at a time, so runs of set or unset blocks are skipped quickly.
+	idx_t FindNext(idx_t start, idx_t end, bool value) const;
+
+private:
+	static constexpr idx_t BITS_PER_WORD = 64;
+
+	void RecountTouchedRange();
+
+private:
+	vector<uint64_t> words;
+	idx_t count = 0;
+	// Range of words [touched_begin, touched_end) that may contain set bits
+	idx_t touched_begin = 0;
+	idx_t touched_end = 0;
+};
+
+} // namespace duckdb
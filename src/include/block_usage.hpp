@@ -0,0 +1,97 @@
+#pragma once
+
+#include "block_bitmap.hpp"
+#include "inspection_deadline.hpp"
+#include "result_cache.hpp"
+#include "sampling.hpp"
+#include "segment_snapshot.hpp"
+
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/storage/database_size.hpp"
+
+namespace duckdb {
+
+class Catalog;
+class ClientContext;
+class InspectionProfile;
+class TableCatalogEntry;
+
+// One component of a block usage breakdown.
+// Sizes and percentages are derived from the block count while emitting rows.
+struct BlockUsageEntry {
+	BlockUsageEntry(const char *component_p, idx_t block_count_p)
+	    : component(component_p), block_count(block_count_p), has_interval(true), low_blocks(block_count_p),
+	      high_blocks(block_count_p) {
+	}
+
+	const char *component;
+	idx_t block_count;
+	// Confidence interval of sampled components, measured components have low = high = block_count.
+	// Tables sampled at a single row group have no interval.
+	bool has_interval;
+	idx_t low_blocks;
+	idx_t high_blocks;
+};
+
+// Breakdown of a database file into 5 non-overlapping components, followed by the total:
+// table_data, index, metadata, free_blocks, unaccounted, total.
+struct BlockUsageResult {
+	static constexpr const char *CACHE_OBJECT_TYPE = "table_inspector_inspect_block_usage_result";
+
+	vector<BlockUsageEntry> entries;
+	idx_t total_blocks = 0;
+	idx_t block_alloc_size = 0;
+	// Tables were skipped because of the timeout, never cached
+	bool timed_out = false;
+
+	idx_t EstimateMemory() const {
+		return sizeof(BlockUsageResult) + entries.size() * sizeof(BlockUsageEntry);
+	}
+};
+
+using CachedBlockUsageResult = CachedResult<BlockUsageResult>;
+
+// Computes the block usage breakdown of one persistent database.
+// Table data and index blocks are counted directly from the blocks referenced by column segments and ART allocator
+// buffers. Whatever the four measured components don't cover is reported as unaccounted, e.g. blocks leaked by a
+// checkpoint.
+//
+// With sampling, table data is extrapolated from a stratified sample of every table's row groups (and unaccounted
+// with it), with a 95% confidence interval. Only blocks of the sampled row groups are excluded from the index blocks.
+// Sampled results are not cached.
+//
+// Prepare() only touches the catalog, Compute() inspects the tables and checks for interruption before every table.
+// Once the deadline has passed, the remaining tables are skipped: their data counts as unaccounted, and the result is
+// flagged as timed out and not cached.
+class BlockUsageInspection {
+public:
+	BlockUsageInspection(RowGroupSampling sampling_p, InspectionDeadline deadline_p,
+	                     optional_ptr<InspectionProfile> profile_p);
+
+public:
+	// Returns the cached breakdown of the catalog if it is still current. Otherwise reads the database size and
+	// metadata, collects the tables for Compute(), and returns nullptr.
+	CachedBlockUsageResult::ResultPtr Prepare(ClientContext &context, Catalog &catalog);
+	// Inspects the tables collected by Prepare() and breaks down the file. Complete, unsampled results are stored in
+	// the result cache.
+	shared_ptr<BlockUsageResult> Compute(ClientContext &context);
+
+private:
+	bool CollectDataBlocks(ClientContext &context, BlockBitmap &table_blocks, BlockBitmap &index_blocks,
+	                       SampleEstimate &table_data);
+
+private:
+	RowGroupSampling sampling;
+	InspectionDeadline deadline;
+	optional_ptr<InspectionProfile> profile;
+
+	optional_ptr<Catalog> catalog;
+	ResultVersion version;
+	DatabaseSize database_size;
+	idx_t metadata_blocks = 0;
+	shared_ptr<SegmentSnapshot> snapshot;
+	vector<reference<TableCatalogEntry>> tables;
+};
+
+} // namespace duckdb
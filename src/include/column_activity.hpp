@@ -0,0 +1,82 @@
+#pragma once
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/storage/object_cache.hpp"
+
+namespace duckdb {
+
+class ClientContext;
+class DBConfig;
+class Vector;
+
+// Name of the setting that tracks the rows and bytes scanned per table column
+constexpr const char *TRACK_COLUMN_ACTIVITY_SETTING = "table_inspector_track_column_activity";
+
+// Scan counters of one table column, updated with relaxed atomic adds by every scanning thread.
+struct ColumnActivityCounters {
+	ColumnActivityCounters() : rows_scanned(0), bytes_scanned(0) {
+	}
+
+	atomic<idx_t> rows_scanned;
+	atomic<idx_t> bytes_scanned;
+};
+
+// Counters of one table column, copied out for inspect_column_activity().
+struct ColumnActivityRow {
+	string database_name;
+	string schema_name;
+	string table_name;
+	string column_name;
+	idx_t rows_scanned = 0;
+	idx_t bytes_scanned = 0;
+};
+
+// Rows and bytes scanned per table column since the database instance started, stored in its object cache.
+// While TRACK_COLUMN_ACTIVITY_SETTING is enabled, an optimizer extension swaps the function of every table scan in
+// a plan for a counting wrapper, which calls the regular table scan and adds every chunk it returns to the counters
+// of the scanned columns. The counters are resolved once and kept in the scan's bind data, so scanning threads only
+// do relaxed atomic adds. Plans optimized while tracking was disabled are never counted.
+//
+// Rows are the rows a scan returned, after the filters pushed into it. Bytes are the in-memory size of the returned
+// values: fixed-size values count their width, strings their length, nested values are not measured. Columns only
+// read to evaluate pushed-down filters are not returned by the scan and not counted.
+class ColumnActivity : public ObjectCacheEntry {
+public:
+	static string ObjectType();
+	string GetObjectType() override;
+	// Never evicted, the counters can't be recomputed
+	optional_idx GetEstimatedCacheMemory() const override;
+
+	// Returns the counters of the context's database instance, creating empty ones if needed.
+	static shared_ptr<ColumnActivity> Get(ClientContext &context);
+
+	// Adds the optimizer extension that instruments table scans.
+	static void RegisterOptimizer(DBConfig &config);
+
+	// Returns the counters of a column, creating them on first use. Columns are identified by name, so the counters
+	// of a table survive ALTER TABLE, and a table that is dropped and recreated continues them.
+	shared_ptr<ColumnActivityCounters> GetCounters(const string &database_name, const string &schema_name,
+	                                               const string &table_name, const string &column_name);
+	// Copies the counters of every column, in the order they were first scanned.
+	vector<ColumnActivityRow> GetRows() const;
+
+	// In-memory bytes of count values of a scanned vector.
+	static idx_t MeasureValueBytes(Vector &vector, idx_t count);
+
+private:
+	struct ColumnEntry {
+		ColumnActivityRow names;
+		shared_ptr<ColumnActivityCounters> counters;
+	};
+
+	mutable mutex lock;
+	unordered_map<string, idx_t> column_index;
+	vector<ColumnEntry> columns;
+};
+
+} // namespace duckdb
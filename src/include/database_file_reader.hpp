@@ -0,0 +1,59 @@
+#pragma once
+
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+#include "duckdb/common/unique_ptr.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+class FileHandle;
+class FileSystem;
+
+// Storage layout of a database file as recorded by its last completed checkpoint.
+struct DatabaseFileInfo {
+	// Iteration of the active database header
+	idx_t iteration = 0;
+	idx_t block_alloc_size = 0;
+	idx_t block_count = 0;
+	idx_t vector_size = 0;
+	idx_t serialization_compatibility = 0;
+	// Root of the catalog metadata, INVALID_INDEX for an empty database
+	idx_t meta_block = DConstants::INVALID_INDEX;
+	// Start of the free list, INVALID_INDEX if nothing was written
+	idx_t free_list_pointer = DConstants::INVALID_INDEX;
+	vector<block_id_t> free_blocks;
+	vector<block_id_t> metadata_blocks;
+
+	// Byte offset of a block within the file
+	idx_t GetBlockLocation(idx_t block_id) const;
+	// Byte offset of a block's data within the file, past the block's checksum. Segment offsets are relative to it.
+	idx_t GetBlockDataLocation(idx_t block_id) const;
+	// Bytes of data in a block, without its checksum
+	idx_t GetBlockDataSize() const;
+};
+
+// Reads the storage layout of a database file straight from disk, without attaching it: the main header, the active
+// database header, and the free list with the metadata block list it points to. Only the header sectors and the
+// metadata blocks on the free list chain are read.
+class DatabaseFileReader {
+public:
+	DatabaseFileReader(FileSystem &fs, const string &path);
+	~DatabaseFileReader();
+
+	DatabaseFileInfo Read();
+
+	// Reads exactly size bytes at location, throws if the file is too short
+	void ReadAt(data_ptr_t buffer, idx_t size, idx_t location);
+
+private:
+	void ReadMainHeader();
+	void ReadDatabaseHeader(DatabaseFileInfo &info);
+	void ReadFreeList(DatabaseFileInfo &info);
+
+	const string path;
+	unique_ptr<FileHandle> handle;
+	idx_t file_size;
+};
+
+} // namespace duckdb
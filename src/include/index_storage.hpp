@@ -0,0 +1,41 @@
+#pragma once
+
+#include "block_bitmap.hpp"
+
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+
+#include <functional>
+
+namespace duckdb {
+
+class FixedSizeAllocator;
+class TableCatalogEntry;
+struct FixedSizeAllocatorInfo;
+
+// One ART allocator of an index, as passed to ForEachIndexAllocator().
+struct IndexAllocator {
+	const string &index_name;
+	// Position in ART allocator order, see GetIndexAllocatorName()
+	idx_t allocator_idx;
+	const FixedSizeAllocatorInfo &info;
+	// Set for bound indexes, whose buffers can be loaded in memory
+	optional_ptr<FixedSizeAllocator> allocator;
+};
+
+// Calls the callback for each ART allocator of every index of the table.
+// Two index states are handled:
+// - BoundIndex: live, in-memory index objects; the info is read from the allocator buffers.
+// - UnboundIndex: deserialized metadata from disk, not yet loaded into memory.
+using IndexAllocatorCallback = std::function<void(const IndexAllocator &allocator)>;
+void ForEachIndexAllocator(TableCatalogEntry &table, const IndexAllocatorCallback &callback);
+
+// Returns the node type an ART allocator holds (e.g. "node16"), by its position in ART allocator order.
+string GetIndexAllocatorName(idx_t allocator_idx);
+
+// Adds the persistent blocks holding the table's index buffers to the bitmap.
+// Small buffers may share a block, so the bitmap counts every block once.
+void CollectIndexBlocks(TableCatalogEntry &table, BlockBitmap &blocks);
+
+} // namespace duckdb
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+void RegisterInspectAllDatabasesFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
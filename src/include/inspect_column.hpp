@@ -5,5 +5,6 @@ namespace duckdb {
 class ExtensionLoader;
 
 void RegisterInspectColumnFunction(ExtensionLoader &loader);
+void RegisterInspectColumnsFunction(ExtensionLoader &loader);
 
 } // namespace duckdb
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+void RegisterInspectDuplicatesFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,10 @@
+#pragma once
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+void RegisterInspectFreeSpaceFunction(ExtensionLoader &loader);
+void RegisterInspectFreeSpaceSummaryFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
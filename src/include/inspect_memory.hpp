@@ -0,0 +1,9 @@
+#pragma once
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+void RegisterInspectMemoryFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
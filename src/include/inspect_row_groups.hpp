@@ -0,0 +1,10 @@
+#pragma once
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+void RegisterInspectRowGroupsFunction(ExtensionLoader &loader);
+void RegisterInspectRowGroupSummaryFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,9 @@
+#pragma once
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+void RegisterInspectScanCostFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
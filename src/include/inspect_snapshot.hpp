@@ -0,0 +1,10 @@
+#pragma once
+
+namespace duckdb {
+
+class ExtensionLoader;
+
+void RegisterInspectSnapshotFunction(ExtensionLoader &loader);
+void RegisterInspectDiffFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "duckdb/common/named_parameter_map.hpp"
+#include "duckdb/common/optional_idx.hpp"
+#include "duckdb/common/string.hpp"
+
+#include <chrono>
+
+namespace duckdb {
+
+class ClientContext;
+class TableFunction;
+
+// Latency budget of an inspection, set by the `timeout_ms` named parameter.
+// Inspections check it between tables: once it has passed, the remaining tables are skipped and the result is
+// flagged as timed out.
+class InspectionDeadline {
+public:
+	// No timeout, the deadline never passes
+	InspectionDeadline() = default;
+
+public:
+	// Reads `timeout_ms`, rejecting negative values on behalf of function_name. Returns an invalid index without a
+	// timeout.
+	static optional_idx GetTimeout(const named_parameter_map_t &named_parameters, const string &function_name);
+	// Registers the `timeout_ms` parameter on a table function.
+	static void AddNamedParameter(TableFunction &function);
+
+	// Starts counting timeout_ms from now.
+	static InspectionDeadline Start(optional_idx timeout_ms);
+
+	bool HasTimeout() const {
+		return has_timeout;
+	}
+	bool Passed() const;
+
+private:
+	bool has_timeout = false;
+	std::chrono::steady_clock::time_point deadline;
+};
+
+// Throws an InterruptException if the query was interrupted. Inspections call it between tables, so that a long
+// inspection can be cancelled.
+void CheckInterrupted(ClientContext &context);
+
+} // namespace duckdb
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "duckdb/common/array.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/insertion_order_preserving_map.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/named_parameter_map.hpp"
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/shared_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/main/client_context_state.hpp"
+
+#include <chrono>
+
+namespace duckdb {
+
+class ClientContext;
+class TableFunction;
+
+// Phases of an inspection that a profile times.
+enum class InspectionPhase : uint8_t {
+	// Collecting the tables (and database metadata) from the catalog
+	CATALOG_SCAN,
+	// Looking up the result cache
+	RESULT_CACHE,
+	// GetColumnSegmentInfo() passes, or segment snapshot hits
+	SEGMENT_COLLECTION,
+	// Unique block counting and sampled size estimates
+	BLOCK_COUNTING,
+	// ART allocator walks of the indexes
+	INDEX_WALK,
+	// Splitting shared blocks into exclusive and shared bytes
+	ATTRIBUTION,
+};
+constexpr idx_t INSPECTION_PHASE_COUNT = 6;
+
+// Counters a profile collects.
+enum class InspectionCounter : uint8_t {
+	TABLES_VISITED,
+	SEGMENTS_VISITED,
+	// Sum of the unique block counts that were computed
+	UNIQUE_BLOCKS,
+	// Memory of the block sets (bitmaps) that were allocated
+	BLOCK_SET_BYTES,
+	INDEX_ALLOCATORS,
+	RESULT_CACHE_HITS,
+};
+constexpr idx_t INSPECTION_COUNTER_COUNT = 6;
+
+// Phase timings and counters of one inspection, collected when the function is called with `profile := true`.
+// Phases are timed by ScopedPhaseTimer and summed across all threads, so with parallel inspection they can add up to
+// more than the wall time. All updates are relaxed atomic adds; without a profile the timers do nothing.
+class InspectionProfile {
+public:
+	InspectionProfile(string function_name_p, string database_name_p);
+
+	struct Metric {
+		string name;
+		double value;
+		// "ms" or "count"
+		const char *unit;
+	};
+
+public:
+	// Reads the `profile` named parameter.
+	static bool IsEnabled(const named_parameter_map_t &named_parameters);
+	// Registers the `profile` parameter on a table function.
+	static void AddNamedParameter(TableFunction &function);
+
+	static const char *PhaseName(InspectionPhase phase);
+	static const char *CounterName(InspectionCounter counter);
+
+	void AddTime(InspectionPhase phase, uint64_t nanos) {
+		phase_nanos[static_cast<idx_t>(phase)].fetch_add(nanos, std::memory_order_relaxed);
+	}
+	void Add(InspectionCounter counter, idx_t count) {
+		counters[static_cast<idx_t>(counter)].fetch_add(count, std::memory_order_relaxed);
+	}
+	// Stops the wall clock.
+	void Finish();
+
+	const string &GetFunctionName() const {
+		return function_name;
+	}
+	const string &GetDatabaseName() const {
+		return database_name;
+	}
+	// Wall time, then every phase and counter, in declaration order
+	vector<Metric> GetMetrics() const;
+	// The metrics as shown in the query profiler (EXPLAIN ANALYZE)
+	InsertionOrderPreservingMap<string> ToProfilerInfo() const;
+
+private:
+	const string function_name;
+	const string database_name;
+	const std::chrono::steady_clock::time_point start;
+	atomic<uint64_t> wall_nanos;
+	array<atomic<uint64_t>, INSPECTION_PHASE_COUNT> phase_nanos;
+	array<atomic<idx_t>, INSPECTION_COUNTER_COUNT> counters;
+};
+
+// Adds the time from construction to destruction to a phase of the profile, if there is one.
+class ScopedPhaseTimer {
+public:
+	ScopedPhaseTimer(optional_ptr<InspectionProfile> profile_p, InspectionPhase phase_p)
+	    : profile(profile_p), phase(phase_p) {
+		if (profile) {
+			start = std::chrono::steady_clock::now();
+		}
+	}
+	~ScopedPhaseTimer() {
+		if (profile) {
+			const auto elapsed = std::chrono::steady_clock::now() - start;
+			profile->AddTime(phase, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+		}
+	}
+
+	ScopedPhaseTimer(const ScopedPhaseTimer &) = delete;
+	ScopedPhaseTimer &operator=(const ScopedPhaseTimer &) = delete;
+
+private:
+	optional_ptr<InspectionProfile> profile;
+	InspectionPhase phase;
+	std::chrono::steady_clock::time_point start;
+};
+
+// Last finished profile of a connection, read by inspect_last_profile().
+class LastInspectionProfile : public ClientContextState {
+public:
+	static shared_ptr<LastInspectionProfile> Get(ClientContext &context);
+
+	void Store(shared_ptr<InspectionProfile> profile_p);
+	shared_ptr<InspectionProfile> GetProfile();
+
+private:
+	mutex lock;
+	shared_ptr<InspectionProfile> profile;
+};
+
+// Owns the profile of a running inspection, if profiling is enabled. Kept in the function's global state: when the
+// query ends and the state is destroyed, the profile is finished and becomes the connection's last profile.
+class InspectionProfiler {
+public:
+	InspectionProfiler() = default;
+	~InspectionProfiler();
+
+	InspectionProfiler(const InspectionProfiler &) = delete;
+	InspectionProfiler &operator=(const InspectionProfiler &) = delete;
+
+public:
+	void Start(ClientContext &context, const string &function_name, const string &database_name);
+
+	// Null unless profiling
+	optional_ptr<InspectionProfile> Get() const {
+		return profile.get();
+	}
+
+private:
+	shared_ptr<InspectionProfile> profile;
+	shared_ptr<LastInspectionProfile> last_profile;
+};
+
+} // namespace duckdb
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "duckdb/common/constants.hpp"
+#include "duckdb/common/numeric_utils.hpp"
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/common/types/string_type.hpp"
+#include "duckdb/common/types/vector.hpp"
+
+namespace duckdb {
+
+// Writes rows straight into the flat vectors of a table function's output chunk.
+// Avoids boxing every cell into a Value: fixed-size cells are stored into FlatVector::GetData<T>(), and strings are
+// copied once into the vector's string heap via StringVector::AddString().
+//
+// Usage:
+//   OutputWriter writer(output);
+//   while (has_more_rows && !writer.IsFull()) {
+//       writer.Write<int64_t>(ID_IDX, id);
+//       writer.WriteString(NAME_IDX, name);
+//       writer.NextRow();
+//   }
+//   writer.Finalize();
+//
+// Functions with projection pushdown pass a column map (see BuildColumnMap()). Columns are then addressed by their
+// index in the function's schema, and writes to columns that were not projected are skipped.
+class OutputWriter {
+public:
+	explicit OutputWriter(DataChunk &output_p) : output(output_p), row(0) {
+	}
+	OutputWriter(DataChunk &output_p, const vector<idx_t> &column_map_p)
+	    : output(output_p), column_map(&column_map_p), row(0) {
+	}
+
+public:
+	// Maps each column of a function's schema to its position in the output chunk, or INVALID_INDEX if the column is
+	// not projected. column_ids are the projected columns from TableFunctionInitInput.
+	static vector<idx_t> BuildColumnMap(const vector<column_t> &column_ids, idx_t column_count) {
+		vector<idx_t> result(column_count, DConstants::INVALID_INDEX);
+		for (idx_t output_idx = 0; output_idx < column_ids.size(); ++output_idx) {
+			// Skips virtual columns such as the row id
+			if (column_ids[output_idx] < column_count) {
+				result[column_ids[output_idx]] = output_idx;
+			}
+		}
+		return result;
+	}
+
+	// Same for functions whose schema depends on their parameters: schema_columns maps every position of the bound
+	// schema to the function's column index, so optional columns can be left out of the schema.
+	static vector<idx_t> BuildColumnMap(const vector<column_t> &column_ids, idx_t column_count,
+	                                    const vector<idx_t> &schema_columns) {
+		vector<idx_t> result(column_count, DConstants::INVALID_INDEX);
+		for (idx_t output_idx = 0; output_idx < column_ids.size(); ++output_idx) {
+			if (column_ids[output_idx] < schema_columns.size()) {
+				result[schema_columns[column_ids[output_idx]]] = output_idx;
+			}
+		}
+		return result;
+	}
+
+	bool IsProjected(idx_t column_idx) const {
+		return !column_map || (*column_map)[column_idx] != DConstants::INVALID_INDEX;
+	}
+
+	bool IsFull() const {
+		return row >= STANDARD_VECTOR_SIZE;
+	}
+
+	// Number of rows written so far.
+	idx_t RowCount() const {
+		return row;
+	}
+
+	template <class T>
+	void Write(idx_t column_idx, T value) {
+		if (!IsProjected(column_idx)) {
+			return;
+		}
+		FlatVector::GetData<T>(GetVector(column_idx))[row] = value;
+	}
+
+	// Writes a size or count as BIGINT.
+	void WriteBigint(idx_t column_idx, idx_t value) {
+		Write<int64_t>(column_idx, NumericCast<int64_t>(value));
+	}
+
+	void WriteString(idx_t column_idx, const string &value) {
+		if (!IsProjected(column_idx)) {
+			return;
+		}
+		auto &vector = GetVector(column_idx);
+		FlatVector::GetData<string_t>(vector)[row] = StringVector::AddString(vector, value);
+	}
+
+	void WriteString(idx_t column_idx, string_t value) {
+		if (!IsProjected(column_idx)) {
+			return;
+		}
+		auto &vector = GetVector(column_idx);
+		FlatVector::GetData<string_t>(vector)[row] = StringVector::AddString(vector, value);
+	}
+
+	void WriteNull(idx_t column_idx) {
+		if (!IsProjected(column_idx)) {
+			return;
+		}
+		FlatVector::SetNull(GetVector(column_idx), row, true);
+	}
+
+	void NextRow() {
+		D_ASSERT(!IsFull());
+		++row;
+	}
+
+	// Sets the output cardinality to the number of rows written.
+	void Finalize() {
+		output.SetCardinality(row);
+	}
+
+private:
+	Vector &GetVector(idx_t column_idx) {
+		return output.data[column_map ? (*column_map)[column_idx] : column_idx];
+	}
+
+private:
+	DataChunk &output;
+	optional_ptr<const vector<idx_t>> column_map;
+	idx_t row;
+};
+
+} // namespace duckdb
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "segment_snapshot.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/storage/object_cache.hpp"
+
+namespace duckdb {
+
+// Name of the setting that enables the result cache
+constexpr const char *ENABLE_CACHE_SETTING = "table_inspector_enable_cache";
+
+// Returns whether inspection results may be served from and stored in the result cache.
+bool IsResultCacheEnabled(ClientContext &context);
+
+// Identifies the state an inspection result was computed from.
+// Persistent storage only changes on checkpoint (see CheckpointId), and the catalog version changes on every
+// committed or transaction-local schema change, so a result computed at the same version is still exact.
+struct ResultVersion {
+	CheckpointId checkpoint_id;
+	idx_t catalog_version = DConstants::INVALID_INDEX;
+
+	// Catalogs without a catalog version cannot tell schema changes apart, their results are never cached
+	bool IsCacheable() const {
+		return catalog_version != DConstants::INVALID_INDEX;
+	}
+
+	bool operator==(const ResultVersion &other) const;
+	bool operator!=(const ResultVersion &other) const;
+
+	// Reads the version of a persistent catalog, as seen by the current transaction.
+	static ResultVersion Get(ClientContext &context, Catalog &catalog);
+};
+
+// Result of one inspector function for one attached database, stored in the database's object cache.
+// RESULT provides a CACHE_OBJECT_TYPE name and an EstimateMemory() method.
+template <class RESULT>
+class CachedResult : public ObjectCacheEntry {
+public:
+	using ResultPtr = shared_ptr<const RESULT>;
+
+	CachedResult(ResultVersion version_p, ResultPtr result_p) : version(version_p), result(std::move(result_p)) {
+	}
+
+public:
+	static string ObjectType() {
+		return RESULT::CACHE_OBJECT_TYPE;
+	}
+
+	string GetObjectType() override {
+		return ObjectType();
+	}
+
+	optional_idx GetEstimatedCacheMemory() const override {
+		return optional_idx(result->EstimateMemory());
+	}
+
+	// Returns the cached result of the catalog if it was computed at the given version, nullptr otherwise.
+	static ResultPtr Lookup(ClientContext &context, Catalog &catalog, const ResultVersion &version) {
+		if (!version.IsCacheable() || !IsResultCacheEnabled(context)) {
+			return nullptr;
+		}
+		auto entry = ObjectCache::GetObjectCache(context).Get<CachedResult<RESULT>>(GetKey(catalog));
+		if (!entry || entry->version != version) {
+			return nullptr;
+		}
+		return entry->result;
+	}
+
+	// Stores the result of the catalog, replacing any result computed at another version.
+	static void Store(ClientContext &context, Catalog &catalog, const ResultVersion &version, ResultPtr result) {
+		if (!version.IsCacheable() || !IsResultCacheEnabled(context)) {
+			return;
+		}
+		ObjectCache::GetObjectCache(context).Put(GetKey(catalog),
+		                                         make_shared_ptr<CachedResult<RESULT>>(version, std::move(result)));
+	}
+
+private:
+	// Key by name and path, so a different file attached under the same alias never sees a stale result
+	static string GetKey(Catalog &catalog) {
+		return ObjectType() + ":" + catalog.GetName() + ":" + catalog.GetDBPath();
+	}
+
+	const ResultVersion version;
+	const ResultPtr result;
+};
+
+} // namespace duckdb
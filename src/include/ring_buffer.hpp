@@ -0,0 +1,80 @@
+#pragma once
+
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/types.hpp"
+#include "duckdb/common/vector.hpp"
+
+namespace duckdb {
+
+// Fixed-capacity FIFO that overwrites its oldest element once full.
+// The storage is allocated once up front, so pushing never allocates beyond what T itself does. Elements are
+// addressed oldest first. Not thread-safe.
+template <class T>
+class RingBuffer {
+public:
+	explicit RingBuffer(idx_t capacity_p) : elements(capacity_p), start(0), count(0), dropped(0) {
+		D_ASSERT(capacity_p > 0);
+	}
+
+public:
+	idx_t Capacity() const {
+		return elements.size();
+	}
+	idx_t Size() const {
+		return count;
+	}
+	bool IsFull() const {
+		return count == elements.size();
+	}
+	// Number of elements overwritten because the buffer was full.
+	idx_t DroppedCount() const {
+		return dropped;
+	}
+
+	// Appends an element, overwriting the oldest one if the buffer is full.
+	void Push(T element) {
+		if (IsFull()) {
+			elements[start] = std::move(element);
+			start = Wrap(start + 1);
+			++dropped;
+			return;
+		}
+		elements[Wrap(start + count)] = std::move(element);
+		++count;
+	}
+
+	// The i-th oldest element.
+	const T &operator[](idx_t i) const {
+		D_ASSERT(i < count);
+		return elements[Wrap(start + i)];
+	}
+
+	// Copies the elements, oldest first.
+	vector<T> ToVector() const {
+		vector<T> result;
+		result.reserve(count);
+		for (idx_t i = 0; i < count; ++i) {
+			result.push_back((*this)[i]);
+		}
+		return result;
+	}
+
+	void Clear() {
+		start = 0;
+		count = 0;
+	}
+
+private:
+	idx_t Wrap(idx_t position) const {
+		return position < elements.size() ? position : position - elements.size();
+	}
+
+private:
+	vector<T> elements;
+	// Position of the oldest element
+	idx_t start;
+	idx_t count;
+	idx_t dropped;
+};
+
+} // namespace duckdb
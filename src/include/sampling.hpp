@@ -0,0 +1,88 @@
+#pragma once
+
+#include "duckdb/common/named_parameter_map.hpp"
+#include "duckdb/common/optional_idx.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/storage/table_storage_info.hpp"
+
+namespace duckdb {
+
+class BlockBitmap;
+class TableFunction;
+
+// A row group picked for a sampled inspection.
+struct SampledRowGroup {
+	idx_t row_group_index;
+	// Number of row groups this one stands for (the size of its stratum)
+	idx_t weight;
+};
+
+// Row group sampling for inspections of large tables, set by the `sample := fraction` and `max_row_groups := N`
+// named parameters. Without either, every row group is inspected.
+struct RowGroupSampling {
+	// Whether either parameter was given; sampled inspections report their estimates, even with `sample := 1`
+	bool enabled = false;
+	// Fraction of the row groups of a table to inspect, in (0, 1]
+	double fraction = 1.0;
+	// Upper bound on the row groups inspected per table
+	optional_idx max_row_groups;
+
+	bool IsEnabled() const {
+		return enabled;
+	}
+
+	// Reads the sampling parameters, rejecting out of range values on behalf of function_name.
+	static RowGroupSampling FromNamedParameters(const named_parameter_map_t &named_parameters,
+	                                            const string &function_name);
+	// Registers the sampling parameters on a table function.
+	static void AddNamedParameters(TableFunction &function);
+
+	// Number of row groups inspected out of row_group_count; at least one of a non-empty table.
+	idx_t SampleSize(idx_t row_group_count) const;
+
+	// Stratified selection: the row groups are split into SampleSize() runs of nearly equal length, and one row
+	// group is picked from each run. Picks are a pseudo-random function of seed, so repeated inspections of the same
+	// table see the same sample. Returned in row group order.
+	vector<SampledRowGroup> SelectRowGroups(idx_t row_group_count, hash_t seed) const;
+};
+
+// A total extrapolated from a sample of row groups, with a 95% confidence interval.
+struct SampleEstimate {
+	double estimate = 0;
+	// Estimated variance of the estimate; invalid with fewer than two sampled row groups
+	double variance = 0;
+	bool has_variance = true;
+	// Sum of the sampled values: the total can't be lower, as sizes are never negative
+	double sampled_total = 0;
+
+	// Combines the estimates of independently sampled tables.
+	void Add(const SampleEstimate &other);
+
+	// Bounds of the confidence interval. Only valid if has_variance.
+	double Low() const;
+	double High() const;
+};
+
+// Extrapolates a total over population_size row groups from the values of the sampled ones. The estimate weights
+// every value with its stratum size. The variance treats the sample as a simple random sample without replacement;
+// the stratification can only lower the actual variance, so the interval is conservative.
+SampleEstimate ExtrapolateTotal(const vector<SampledRowGroup> &sample, const vector<double> &sampled_values,
+                                idx_t population_size);
+
+// Number of row groups a table's segments are spread over (highest row group index + 1).
+idx_t CountRowGroups(const vector<ColumnSegmentInfo> &segment_info);
+
+// Bytes stored by each row group of a table, indexed by row group index: the main block portion of its segments
+// (see CalculateSegmentSizes) plus their additional blocks.
+vector<idx_t> CalculateRowGroupSizes(const vector<ColumnSegmentInfo> &segment_info, idx_t block_alloc_size);
+
+// Bytes of the blocks each sampled row group adds to blocks, in sample order. Blocks are counted like unsampled
+// inspections count them: a block referenced by several row groups, or already in blocks, counts once, for the first
+// row group that adds it. With every row group sampled, the values add up to the unique blocks of the segments.
+vector<double> MeasureSampledBlocks(const vector<SampledRowGroup> &sample,
+                                    const vector<ColumnSegmentInfo> &segment_info, idx_t block_alloc_size,
+                                    BlockBitmap &blocks);
+
+} // namespace duckdb
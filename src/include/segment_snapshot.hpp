@@ -0,0 +1,111 @@
+#pragma once
+
+#include "sampling.hpp"
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/optional_idx.hpp"
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include "duckdb/storage/table_storage_info.hpp"
+
+namespace duckdb {
+
+class Catalog;
+class ClientContext;
+class DataTable;
+class TableCatalogEntry;
+
+// Identifies the checkpointed state of a database.
+// Persistent segments only change on checkpoint, and every checkpoint writes a new metadata root and updates
+// the block counts, so two inspections that see the same id see the same persistent segments.
+struct CheckpointId {
+	idx_t meta_block = 0;
+	idx_t total_blocks = 0;
+	idx_t free_blocks = 0;
+
+	bool operator==(const CheckpointId &other) const;
+	bool operator!=(const CheckpointId &other) const;
+
+	// Reads the checkpoint id of a persistent catalog.
+	static CheckpointId Get(ClientContext &context, Catalog &catalog);
+};
+
+// Cheap summary of a table's contents, used to carry collected segments over to the next checkpoint.
+// Appends and vacuums change the row count, and appends and updates widen the column statistics, so a table whose
+// fingerprint is unchanged was not rewritten by the checkpoint. Updates that leave every column statistic unchanged
+// are not detected.
+struct TableFingerprint {
+	optional_ptr<const DataTable> storage;
+	idx_t total_rows = 0;
+	idx_t column_count = 0;
+	hash_t statistics_hash = 0;
+
+	bool operator==(const TableFingerprint &other) const;
+	bool operator!=(const TableFingerprint &other) const;
+
+	static TableFingerprint Get(ClientContext &context, TableCatalogEntry &table);
+};
+
+// Persistent column segments of all tables in one database at one checkpoint.
+// Snapshots live in the database's object cache, keyed by database, and are replaced as soon as a newer checkpoint
+// is observed. Segments of a table are collected on first access, so all inspector functions share one
+// GetColumnSegmentInfo() pass per table and checkpoint. A snapshot that replaces an older one adopts the older
+// segments of every table whose fingerprint did not change, so only tables touched by the checkpoint are collected.
+class SegmentSnapshot : public ObjectCacheEntry {
+public:
+	SegmentSnapshot(string database_name_p, CheckpointId checkpoint_id_p);
+	SegmentSnapshot(string database_name_p, CheckpointId checkpoint_id_p, const SegmentSnapshot &previous);
+
+	using TableSegments = shared_ptr<const vector<ColumnSegmentInfo>>;
+
+public:
+	static string ObjectType();
+	string GetObjectType() override;
+	optional_idx GetEstimatedCacheMemory() const override;
+
+	// Returns the snapshot for the catalog's current checkpoint. In-memory catalogs have no persistent segments
+	// and get an uncached, empty snapshot.
+	static shared_ptr<SegmentSnapshot> Get(ClientContext &context, Catalog &catalog);
+
+	// Returns the persistent segments of the table, collecting them on first access. Thread-safe.
+	TableSegments GetTableSegments(ClientContext &context, TableCatalogEntry &table);
+
+	// Persistent segments of a sample of the table's row groups, drawn from the row groups in its partition
+	// statistics. If the table's segments were collected already, they are filtered; otherwise only the sampled row
+	// groups are walked, and nothing is cached. Thread-safe.
+	struct SampledSegments {
+		vector<SampledRowGroup> sample;
+		idx_t row_group_count = 0;
+		vector<ColumnSegmentInfo> segments;
+	};
+	SampledSegments GetSampledSegments(ClientContext &context, TableCatalogEntry &table,
+	                                   const RowGroupSampling &sampling);
+
+	const CheckpointId &GetCheckpointId() const {
+		return checkpoint_id;
+	}
+
+private:
+	struct TableEntry {
+		TableSegments segments;
+		TableFingerprint fingerprint;
+		idx_t estimated_memory;
+		// Only segments collected while the table had no in-memory changes describe the checkpoint exactly
+		bool reusable;
+	};
+
+	const string database_name;
+	const CheckpointId checkpoint_id;
+
+	mutable mutex lock;
+	// Keyed by table catalog entry oid
+	unordered_map<idx_t, TableEntry> table_segments;
+	// Reusable entries of the snapshot this one replaced, adopted on first access if still valid
+	unordered_map<idx_t, TableEntry> previous_segments;
+	idx_t estimated_memory = 0;
+};
+
+} // namespace duckdb
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "ring_buffer.hpp"
+
+#include "duckdb/common/enums/set_scope.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/storage/object_cache.hpp"
+
+#include <condition_variable>
+#include <thread>
+
+namespace duckdb {
+
+class ClientContext;
+class DatabaseInstance;
+class Value;
+
+// Name of the setting that starts the background storage collector
+constexpr const char *SAMPLE_INTERVAL_SETTING = "table_inspector_sample_interval";
+
+// Number of samples kept per database instance; older samples are overwritten
+constexpr idx_t STORAGE_HISTORY_CAPACITY = 4096;
+
+// inspect_storage() and inspect_block_usage() figures of one attached database at one point in time.
+struct StorageHistorySample {
+	timestamp_t sample_time;
+	string database_name;
+	idx_t database_file_bytes = 0;
+	idx_t wal_file_bytes = 0;
+	idx_t table_data_bytes = 0;
+	idx_t index_bytes = 0;
+	idx_t metadata_bytes = 0;
+	idx_t free_bytes = 0;
+	idx_t unaccounted_bytes = 0;
+	idx_t total_blocks = 0;
+	idx_t free_blocks = 0;
+};
+
+// History of storage samples of a database instance, stored in its object cache.
+// While the sample interval is non-zero, a background thread captures every persistent attached database once per
+// interval in a client context of its own, so sampling never competes with user queries for a transaction. Between
+// captures the thread only holds a weak reference to the database instance, and it skips captures while no
+// connection is open. Resetting the interval to zero, or destroying the instance and with it this entry, stops and
+// joins the thread.
+class StorageHistory : public ObjectCacheEntry {
+public:
+	StorageHistory();
+	~StorageHistory() override;
+
+public:
+	static string ObjectType();
+	string GetObjectType() override;
+	// Never evicted, the history can't be recomputed
+	optional_idx GetEstimatedCacheMemory() const override;
+
+	// Returns the history of the context's database instance, creating an empty one if needed.
+	static shared_ptr<StorageHistory> Get(ClientContext &context);
+
+	// Starts, retimes or (with zero) stops the collector.
+	void SetInterval(DatabaseInstance &db, idx_t interval_ms);
+	// Captures every persistent attached database in the context's transaction, as the collector does.
+	void Capture(ClientContext &context);
+	// Copies the samples, oldest first.
+	vector<StorageHistorySample> GetSamples() const;
+
+	// Callback of SAMPLE_INTERVAL_SETTING, in milliseconds.
+	static void SetSampleInterval(ClientContext &context, SetScope scope, Value &parameter);
+
+private:
+	// Shared with the collector thread, which outlives this entry if it released the last instance reference
+	struct CollectorState {
+		CollectorState() : samples(STORAGE_HISTORY_CAPACITY) {
+		}
+
+		mutable mutex lock;
+		std::condition_variable interval_changed;
+		idx_t interval_ms = 0;
+		// Bumped on every interval change, so the thread restarts its wait
+		idx_t generation = 0;
+		RingBuffer<StorageHistorySample> samples;
+	};
+
+	// Resets the interval and joins the collector. Requires collector_lock.
+	void StopCollector();
+	static void RunCollector(shared_ptr<CollectorState> state, weak_ptr<DatabaseInstance> weak_db);
+
+private:
+	shared_ptr<CollectorState> state;
+	// Serializes starting and stopping the collector
+	mutex collector_lock;
+	std::thread collector;
+};
+
+} // namespace duckdb
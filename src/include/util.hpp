@@ -1,5 +1,9 @@
 #pragma once
 
+#include "block_bitmap.hpp"
+
+#include "duckdb/common/helper.hpp"
+#include "duckdb/common/optional_idx.hpp"
 #include "duckdb/common/string.hpp"
 #include "duckdb/common/types.hpp"
 #include "duckdb/common/vector.hpp"
@@ -11,7 +15,67 @@ namespace duckdb {
 // Guards against division by zero: returns "0.0%" when total_blocks is zero.
 string FormatPercentage(idx_t blocks, idx_t total_blocks);
 
+// Adds all persistent block IDs referenced by column segment info (including additional blocks) to the bitmap.
+void CollectSegmentBlocks(const vector<ColumnSegmentInfo> &segment_info, BlockBitmap &blocks);
+
 // Counts unique persistent block IDs from column segment info.
-idx_t CountUniqueBlocks(const vector<ColumnSegmentInfo> &segment_info);
+// The bitmap is scratch space: it's cleared first, and can be reused across calls to avoid reallocation.
+idx_t CountUniqueBlocks(const vector<ColumnSegmentInfo> &segment_info, BlockBitmap &blocks);
+
+// A persistent segment's position within its block.
+struct SegmentOffset {
+	block_id_t block_id;
+	idx_t offset;
+	// Index of the segment in the segment info it was collected from
+	idx_t segment_idx;
+};
+
+// Sorts segment offsets by (block_id, offset) with a stable LSD radix sort.
+// Only the low bytes that actually differ between entries are sorted on.
+void RadixSortSegmentOffsets(vector<SegmentOffset> &entries);
+
+// Calculates the compressed size of every segment within its main block, from the offset of the next segment in the
+// same block. The last segment in a block gets the upper bound (block_alloc_size - offset). The result is indexed like
+// segment_info; non-persistent segments have size 0. Additional blocks of large segments are not included.
+// Uses one flat array sorted once, and a single linear sweep over it.
+vector<idx_t> CalculateSegmentSizes(const vector<ColumnSegmentInfo> &segment_info, idx_t block_alloc_size);
+
+// Bytes of persistent blocks attributed to one owner (e.g. a table) of a set of segments.
+struct BlockAttribution {
+	// Blocks only this owner has segments in, counted in full
+	idx_t exclusive_bytes = 0;
+	// This owner's share of blocks that other owners have segments in too
+	idx_t shared_bytes = 0;
+};
+
+// Attributes every persistent block referenced by the owners' segments to the owners at byte granularity.
+// Small segments of different owners can share a block (partial blocks). Within a shared block, each segment owns the
+// bytes up to the next segment's offset, the last one up to the end of the block, so the bytes of all owners add up
+// to the referenced blocks exactly. The result is indexed like owners.
+vector<BlockAttribution> AttributeSharedBlocks(const vector<reference<const vector<ColumnSegmentInfo>>> &owners,
+                                               idx_t block_alloc_size);
+
+// A maximal run of consecutive free blocks.
+struct FreeExtent {
+	idx_t start_block;
+	idx_t block_count;
+};
+
+// Collects the runs of set blocks in [0, total_blocks) of a free block bitmap, in block order.
+vector<FreeExtent> CollectFreeExtents(const BlockBitmap &free_blocks, idx_t total_blocks);
+
+// Histogram bucket of an extent length: bucket b holds lengths in [2^b, 2^(b+1)).
+idx_t GetExtentSizeBucket(idx_t block_count);
+
+// Reads the maximum string length from a string segment's statistics (e.g. "[Min: a, Max: z, Has Unicode: false,
+// Max String Length: 10][Has Null: false, Has No Null: true]"). Returns an invalid index if the statistics don't
+// record it.
+optional_idx ParseMaxStringLength(const string &segment_stats);
+
+// Reads the min and max values from a segment's statistics (e.g. "[Min: 1, Max: 99][Has Null: false, Has No Null:
+// true]"), as printed by Value::ToString(). String bounds are prefixes of the actual values, cut at 8 bytes or at the
+// first NUL or non-ASCII byte, whichever comes first. Returns false if the statistics have no bounds, or if a string
+// bound contains ", Max: " so that the bounds can't be told apart.
+bool ParseSegmentMinMax(const string &segment_stats, string &min, string &max);
 
 } // namespace duckdb
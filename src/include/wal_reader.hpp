@@ -0,0 +1,28 @@
+#pragma once
+
+#include "duckdb/common/string.hpp"
+#include "duckdb/common/types.hpp"
+
+namespace duckdb {
+
+class FileSystem;
+
+// Entries of a write-ahead log file, counted from its framing.
+struct WalSummary {
+	// Whether the version marker was recognized; false e.g. for encrypted WAL files. A missing WAL file is empty.
+	bool readable = true;
+	idx_t file_bytes = 0;
+	// Entries after the version marker
+	idx_t entry_count = 0;
+	// Flush markers, one per committed transaction
+	idx_t commit_count = 0;
+	// Bytes after the last complete entry, e.g. of an entry that is still being written
+	idx_t trailing_bytes = 0;
+};
+
+// Counts the entries of a WAL file without replaying it. The log starts with an unframed version marker. Every entry
+// after it is [size][checksum][payload], and the payload starts with the serialized entry type, so only the 19 bytes
+// leading each entry are read.
+WalSummary ReadWalSummary(FileSystem &fs, const string &path);
+
+} // namespace duckdb
@@ -0,0 +1,63 @@
+#include "index_storage.hpp"
+
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/execution/index/art/art.hpp"
+#include "duckdb/execution/index/fixed_size_allocator.hpp"
+#include "duckdb/execution/index/unbound_index.hpp"
+#include "duckdb/storage/block.hpp"
+#include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/table/data_table_info.hpp"
+
+namespace duckdb {
+
+void ForEachIndexAllocator(TableCatalogEntry &table, const IndexAllocatorCallback &callback) {
+	auto &storage = table.GetStorage();
+	auto &table_info = *storage.GetDataTableInfo();
+	auto &indexes = table_info.GetIndexes();
+
+	for (auto &index : indexes.Indexes()) {
+		if (index.IsBound() && index.GetIndexType() == ART::TYPE_NAME) {
+			// BoundIndex: the allocation_size and block pointers are set during serialization.
+			auto &art = index.Cast<ART>();
+			for (idx_t alloc_idx = 0; alloc_idx < ART::ALLOCATOR_COUNT; ++alloc_idx) {
+				auto &allocator = *(*art.allocators)[alloc_idx];
+				const auto info = allocator.GetInfo();
+				callback(IndexAllocator {index.GetIndexName(), alloc_idx, info, &allocator});
+			}
+		} else if (!index.IsBound()) {
+			auto &unbound = index.Cast<UnboundIndex>();
+			const auto &allocator_infos = unbound.GetStorageInfo().allocator_infos;
+			for (idx_t alloc_idx = 0; alloc_idx < allocator_infos.size(); ++alloc_idx) {
+				callback(IndexAllocator {index.GetIndexName(), alloc_idx, allocator_infos[alloc_idx], nullptr});
+			}
+		}
+	}
+}
+
+string GetIndexAllocatorName(idx_t allocator_idx) {
+	// Same order as Node::GetAllocatorIdx()
+	static constexpr const char *ALLOCATOR_NAMES[] = {"prefix",      "leaf",        "node4",
+	                                                  "node16",      "node48",      "node256",
+	                                                  "node7_leaf",  "node15_leaf", "node256_leaf"};
+	static constexpr idx_t ALLOCATOR_NAME_COUNT = sizeof(ALLOCATOR_NAMES) / sizeof(ALLOCATOR_NAMES[0]);
+	static_assert(ALLOCATOR_NAME_COUNT == ART::ALLOCATOR_COUNT, "ART allocator names out of sync");
+
+	if (allocator_idx < ALLOCATOR_NAME_COUNT) {
+		return ALLOCATOR_NAMES[allocator_idx];
+	}
+	// Indexes written by older storage versions can have a different allocator layout
+	return "allocator_" + std::to_string(allocator_idx);
+}
+
+void CollectIndexBlocks(TableCatalogEntry &table, BlockBitmap &blocks) {
+	ForEachIndexAllocator(table, [&](const IndexAllocator &allocator) {
+		for (const auto &block_pointer : allocator.info.block_pointers) {
+			// Buffers created since the last checkpoint have no block yet
+			if (block_pointer.IsValid()) {
+				blocks.Set(block_pointer.block_id);
+			}
+		}
+	});
+}
+
+} // namespace duckdb
@@ -0,0 +1,255 @@
+#include "inspect_all_databases.hpp"
+#include "block_usage.hpp"
+#include "inspection_deadline.hpp"
+#include "output_writer.hpp"
+#include "util.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/attached_database.hpp"
+#include "duckdb/main/database_manager.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// inspect_all_databases() - Block usage of every attached database, rolled up
+//===--------------------------------------------------------------------===//
+
+// Runs the inspect_block_usage() breakdown for every attached persistent database in one call, and rolls the
+// components up across databases. Rows of a database come in database name order, followed by the rollup rows whose
+// database_name is NULL. Percentages are relative to the total of the database (or of all databases for the
+// rollup); block sizes can differ between databases, so the rollup percentages are computed from bytes.
+//
+// Init prepares every database: cached breakdowns are taken as they are, for the others only the catalog is read.
+// Execute computes the remaining breakdowns in parallel, one database per thread at a time. The thread that
+// finishes the last database emits all rows, as the rollup needs every database.
+//
+// With `timeout_ms`, one deadline covers all databases: tables left once it has passed are skipped, as in
+// inspect_block_usage(), and the rows of every affected database and of the rollup report timed_out.
+
+constexpr idx_t DATABASE_NAME_IDX = 0;
+constexpr idx_t COMPONENT_IDX = 1;
+constexpr idx_t SIZE_BYTES_IDX = 2;
+constexpr idx_t PERCENTAGE_IDX = 3;
+constexpr idx_t BLOCK_COUNT_IDX = 4;
+// Only present with a timeout
+constexpr idx_t TIMED_OUT_IDX = 5;
+constexpr idx_t OUTPUT_COLUMN_COUNT = 6;
+
+struct InspectAllDatabasesBindData : public TableFunctionData {
+	explicit InspectAllDatabasesBindData(optional_idx timeout_ms_p) : timeout_ms(timeout_ms_p) {
+	}
+
+	optional_idx timeout_ms;
+	// Bound schema position -> output column index, as optional columns are left out of the schema
+	vector<idx_t> schema_columns;
+};
+
+struct DatabaseBlockUsage {
+	shared_ptr<AttachedDatabase> database;
+	unique_ptr<BlockUsageInspection> inspection;
+	// Set by Init on a cache hit, otherwise by the thread that computes it
+	CachedBlockUsageResult::ResultPtr result;
+};
+
+struct OutputRow {
+	bool is_rollup;
+	string database_name;
+	const char *component;
+	idx_t size_bytes;
+	idx_t total_bytes;
+	idx_t block_count;
+	bool timed_out;
+};
+
+struct InspectAllDatabasesState : public GlobalTableFunctionState {
+	InspectAllDatabasesState() : next_pending(0), finished_pending(0), emit_claimed(false), offset(0) {
+	}
+
+	idx_t MaxThreads() const override {
+		return MaxValue<idx_t>(pending.size(), 1);
+	}
+
+	vector<idx_t> column_map;
+	InspectionDeadline deadline;
+	vector<DatabaseBlockUsage> databases;
+	// Databases whose breakdown still has to be computed
+	vector<idx_t> pending;
+	atomic<idx_t> next_pending;
+	atomic<idx_t> finished_pending;
+	// Without pending databases, the first thread emits the rows
+	atomic<bool> emit_claimed;
+
+	// Built and emitted by the thread that finished last
+	vector<OutputRow> rows;
+	idx_t offset;
+};
+
+struct InspectAllDatabasesLocalState : public LocalTableFunctionState {
+	bool emitting = false;
+};
+
+unique_ptr<FunctionData> InspectAllDatabasesBind(ClientContext &context, TableFunctionBindInput &input,
+                                                 vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	names.reserve(OUTPUT_COLUMN_COUNT);
+	return_types.reserve(OUTPUT_COLUMN_COUNT);
+	names.emplace_back("database_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("component");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("size_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("percentage");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("block_count");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	const auto timeout_ms = InspectionDeadline::GetTimeout(input.named_parameters, "inspect_all_databases");
+	if (timeout_ms.IsValid()) {
+		names.emplace_back("timed_out");
+		return_types.emplace_back(LogicalType {LogicalTypeId::BOOLEAN});
+	}
+
+	auto result = make_uniq<InspectAllDatabasesBindData>(timeout_ms);
+	for (idx_t column_idx = 0; column_idx <= BLOCK_COUNT_IDX; ++column_idx) {
+		result->schema_columns.push_back(column_idx);
+	}
+	if (timeout_ms.IsValid()) {
+		result->schema_columns.push_back(TIMED_OUT_IDX);
+	}
+	return std::move(result);
+}
+
+unique_ptr<GlobalTableFunctionState> InspectAllDatabasesInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<InspectAllDatabasesState>();
+	const auto &bind_data = input.bind_data->Cast<InspectAllDatabasesBindData>();
+
+	result->column_map = OutputWriter::BuildColumnMap(input.column_ids, OUTPUT_COLUMN_COUNT, bind_data.schema_columns);
+	result->deadline = InspectionDeadline::Start(bind_data.timeout_ms);
+
+	// Same databases as inspect_storage()
+	auto databases = DatabaseManager::Get(context).GetDatabases(context);
+	std::sort(databases.begin(), databases.end(),
+	          [](const shared_ptr<AttachedDatabase> &lhs, const shared_ptr<AttachedDatabase> &rhs) {
+		          return lhs->GetName() < rhs->GetName();
+	          });
+	for (auto &db : databases) {
+		if (db->IsSystem() || db->IsTemporary() || db->GetCatalog().InMemory()) {
+			continue;
+		}
+		DatabaseBlockUsage usage;
+		usage.inspection = make_uniq<BlockUsageInspection>(RowGroupSampling(), result->deadline, nullptr);
+		usage.result = usage.inspection->Prepare(context, db->GetCatalog());
+		if (!usage.result) {
+			result->pending.push_back(result->databases.size());
+		}
+		usage.database = std::move(db);
+		result->databases.push_back(std::move(usage));
+	}
+
+	return std::move(result);
+}
+
+unique_ptr<LocalTableFunctionState> InspectAllDatabasesInitLocal(ExecutionContext &context,
+                                                                 TableFunctionInitInput &input,
+                                                                 GlobalTableFunctionState *global_state) {
+	return make_uniq<InspectAllDatabasesLocalState>();
+}
+
+// Rows of every database, followed by the rollup. Components come in the same order for every database.
+vector<OutputRow> BuildRows(const vector<DatabaseBlockUsage> &databases) {
+	vector<OutputRow> result;
+	vector<OutputRow> rollup;
+	for (const auto &database : databases) {
+		const auto &usage = *database.result;
+		const idx_t total_bytes = usage.total_blocks * usage.block_alloc_size;
+		for (idx_t entry_idx = 0; entry_idx < usage.entries.size(); ++entry_idx) {
+			const auto &entry = usage.entries[entry_idx];
+			const idx_t size_bytes = entry.block_count * usage.block_alloc_size;
+			result.push_back(OutputRow {false, database.database->GetName(), entry.component, size_bytes,
+			                            total_bytes, entry.block_count, usage.timed_out});
+
+			if (rollup.size() <= entry_idx) {
+				rollup.push_back(OutputRow {true, string(), entry.component, 0, 0, 0, false});
+			}
+			auto &rollup_row = rollup[entry_idx];
+			D_ASSERT(StringUtil::Equals(rollup_row.component, entry.component));
+			rollup_row.size_bytes += size_bytes;
+			rollup_row.total_bytes += total_bytes;
+			rollup_row.block_count += entry.block_count;
+			rollup_row.timed_out = rollup_row.timed_out || usage.timed_out;
+		}
+	}
+	result.insert(result.end(), rollup.begin(), rollup.end());
+	return result;
+}
+
+void InspectAllDatabasesExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectAllDatabasesState>();
+	auto &local_state = data.local_state->Cast<InspectAllDatabasesLocalState>();
+
+	// Threads keep computing breakdowns until none are left; the one finishing the last breakdown emits the rows
+	while (!local_state.emitting) {
+		const idx_t pending_idx = state.next_pending++;
+		if (pending_idx >= state.pending.size()) {
+			if (state.pending.empty() && !state.emit_claimed.exchange(true)) {
+				local_state.emitting = true;
+				state.rows = BuildRows(state.databases);
+				break;
+			}
+			output.SetCardinality(0);
+			return;
+		}
+		auto &database = state.databases[state.pending[pending_idx]];
+		database.result = database.inspection->Compute(context);
+		// Every other thread has published its breakdown once the last one is counted
+		if (++state.finished_pending == state.pending.size()) {
+			local_state.emitting = true;
+			state.rows = BuildRows(state.databases);
+		}
+	}
+
+	OutputWriter writer(output, state.column_map);
+	while (state.offset < state.rows.size() && !writer.IsFull()) {
+		const auto &row = state.rows[state.offset];
+
+		if (row.is_rollup) {
+			writer.WriteNull(DATABASE_NAME_IDX);
+		} else {
+			writer.WriteString(DATABASE_NAME_IDX, row.database_name);
+		}
+		writer.WriteString(COMPONENT_IDX, string_t(row.component));
+		writer.WriteBigint(SIZE_BYTES_IDX, row.size_bytes);
+		writer.WriteString(PERCENTAGE_IDX, FormatPercentage(row.size_bytes, row.total_bytes));
+		writer.WriteBigint(BLOCK_COUNT_IDX, row.block_count);
+		writer.Write<bool>(TIMED_OUT_IDX, row.timed_out);
+		writer.NextRow();
+
+		state.offset++;
+	}
+
+	writer.Finalize();
+}
+
+} // namespace
+
+void RegisterInspectAllDatabasesFunction(ExtensionLoader &loader) {
+	TableFunction inspect_all_databases_func("inspect_all_databases", {}, InspectAllDatabasesExecute,
+	                                         InspectAllDatabasesBind, InspectAllDatabasesInit,
+	                                         InspectAllDatabasesInitLocal);
+	InspectionDeadline::AddNamedParameter(inspect_all_databases_func);
+	loader.RegisterFunction(std::move(inspect_all_databases_func));
+}
+
+} // namespace duckdb
@@ -1,15 +1,15 @@
 #include "inspect_block_usage.hpp"
+#include "block_usage.hpp"
+#include "inspection_deadline.hpp"
+#include "inspection_profile.hpp"
+#include "output_writer.hpp"
+#include "sampling.hpp"
 #include "util.hpp"
 
 #include "duckdb/catalog/catalog.hpp"
-#include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
-#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
-#include "duckdb/catalog/default/default_schemas.hpp"
 #include "duckdb/common/assert.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
-#include "duckdb/storage/database_size.hpp"
-#include "duckdb/storage/table_storage_info.hpp"
 
 namespace duckdb {
 
@@ -19,70 +19,70 @@ namespace {
 // inspect_block_usage() - File-level storage breakdown
 //===--------------------------------------------------------------------===//
 
-// Breaks down a .duckdb file into 4 non-overlapping components:
-// table_data, index, metadata, free_blocks.
-
-struct BlockUsageEntry {
-	string component;
-	idx_t block_count;
-	idx_t size_bytes;
-	string percentage;
-};
+// Breaks down a .duckdb file into 5 non-overlapping components:
+// table_data, index, metadata, free_blocks, unaccounted. See BlockUsageInspection.
+//
+// With `sample` or `max_row_groups`, table data is extrapolated from a stratified sample of every table's row groups,
+// and size_bytes_low/size_bytes_high give the 95% confidence interval.
+//
+// Init only collects the tables; they are inspected in Execute, which checks for interruption before every table.
+// With `timeout_ms`, the tables left once the deadline has passed are skipped: their data counts as unaccounted, and
+// every row reports timed_out. Partial results are not cached.
+//
+// With `profile := true`, every phase is timed and counted, see InspectionProfile. The profile is shown by
+// EXPLAIN ANALYZE and kept for inspect_last_profile() once the query ends.
+
+constexpr idx_t COMPONENT_IDX = 0;
+constexpr idx_t SIZE_BYTES_IDX = 1;
+constexpr idx_t PERCENTAGE_IDX = 2;
+constexpr idx_t BLOCK_COUNT_IDX = 3;
+// Only present with row group sampling
+constexpr idx_t SIZE_BYTES_LOW_IDX = 4;
+constexpr idx_t SIZE_BYTES_HIGH_IDX = 5;
+// Only present with a timeout
+constexpr idx_t TIMED_OUT_IDX = 6;
+constexpr idx_t OUTPUT_COLUMN_COUNT = 7;
 
 struct InspectBlockUsageBindData : public TableFunctionData {
-	explicit InspectBlockUsageBindData(string database_name_p) : database_name(std::move(database_name_p)) {
+	InspectBlockUsageBindData(string database_name_p, RowGroupSampling sampling_p, optional_idx timeout_ms_p,
+	                          bool profile_p)
+	    : database_name(std::move(database_name_p)), sampling(sampling_p), timeout_ms(timeout_ms_p),
+	      profile(profile_p) {
 	}
 
 	string database_name;
+	RowGroupSampling sampling;
+	optional_idx timeout_ms;
+	bool profile;
+	// Bound schema position -> output column index, as optional columns are left out of the schema
+	vector<idx_t> schema_columns;
 };
 
 struct InspectBlockUsageState : public GlobalTableFunctionState {
 	InspectBlockUsageState() : offset(0) {
 	}
 
-	vector<BlockUsageEntry> entries;
-	idx_t offset;
-};
-
-// Count unique block IDs used by table data across all tables
-idx_t CountTableDataBlocks(ClientContext &context, Catalog &catalog) {
-	idx_t total = 0;
+	vector<idx_t> column_map;
+	InspectionProfiler profiler;
 
-	auto schemas = catalog.GetSchemas(context);
-	for (auto &schema_ref : schemas) {
-		auto &schema = schema_ref.get();
-
-		// Skip internal schemas
-		if (DefaultSchemaGenerator::IsDefaultSchema(schema.name)) {
-			continue;
-		}
-
-		schema.Scan(context, CatalogType::TABLE_ENTRY, [&](CatalogEntry &entry) {
-			auto &table = entry.Cast<TableCatalogEntry>();
-			QueryContext query_context {context};
-			const auto segment_info = table.GetColumnSegmentInfo(query_context);
-			total += CountUniqueBlocks(segment_info);
-		});
-	}
-
-	return total;
-}
+	// Either computed by the first Execute call or served from the result cache
+	CachedBlockUsageResult::ResultPtr result;
+	idx_t offset;
 
-// Count physical metadata blocks
-// Each MetadataBlockInfo entry represents one physical block.
-idx_t CountMetadataBlocks(const vector<MetadataBlockInfo> &metadata_info) {
-	return metadata_info.size();
-}
+	// Computes the result in the first Execute call, unless it was cached
+	unique_ptr<BlockUsageInspection> inspection;
+};
 
 // Shared bind logic for all inspect_block_usage overloads
-unique_ptr<FunctionData> InspectBlockUsageBindInternal(ClientContext &context, const string &database_name,
-                                                       vector<LogicalType> &return_types, vector<string> &names) {
+unique_ptr<FunctionData> InspectBlockUsageBindInternal(ClientContext &context, TableFunctionBindInput &input,
+                                                       const string &database_name, vector<LogicalType> &return_types,
+                                                       vector<string> &names) {
 	D_ASSERT(names.empty());
 	D_ASSERT(return_types.empty());
 
 	// Define output columns
-	names.reserve(4);
-	return_types.reserve(4);
+	names.reserve(OUTPUT_COLUMN_COUNT);
+	return_types.reserve(OUTPUT_COLUMN_COUNT);
 	names.emplace_back("component");
 	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
 	names.emplace_back("size_bytes");
@@ -92,20 +92,45 @@ unique_ptr<FunctionData> InspectBlockUsageBindInternal(ClientContext &context, c
 	names.emplace_back("block_count");
 	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
 
-	return make_uniq<InspectBlockUsageBindData>(database_name);
+	const auto sampling = RowGroupSampling::FromNamedParameters(input.named_parameters, "inspect_block_usage");
+	if (sampling.IsEnabled()) {
+		names.emplace_back("size_bytes_low");
+		return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+		names.emplace_back("size_bytes_high");
+		return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	}
+	const auto timeout_ms = InspectionDeadline::GetTimeout(input.named_parameters, "inspect_block_usage");
+	if (timeout_ms.IsValid()) {
+		names.emplace_back("timed_out");
+		return_types.emplace_back(LogicalType {LogicalTypeId::BOOLEAN});
+	}
+
+	const bool profile = InspectionProfile::IsEnabled(input.named_parameters);
+	auto result = make_uniq<InspectBlockUsageBindData>(database_name, sampling, timeout_ms, profile);
+	for (idx_t column_idx = 0; column_idx <= BLOCK_COUNT_IDX; ++column_idx) {
+		result->schema_columns.push_back(column_idx);
+	}
+	if (sampling.IsEnabled()) {
+		result->schema_columns.push_back(SIZE_BYTES_LOW_IDX);
+		result->schema_columns.push_back(SIZE_BYTES_HIGH_IDX);
+	}
+	if (timeout_ms.IsValid()) {
+		result->schema_columns.push_back(TIMED_OUT_IDX);
+	}
+	return std::move(result);
 }
 
 // inspect_block_usage(database_name)
 unique_ptr<FunctionData> InspectBlockUsageBindWithDatabase(ClientContext &context, TableFunctionBindInput &input,
                                                            vector<LogicalType> &return_types, vector<string> &names) {
 	const auto database_name = input.inputs[0].GetValue<string>();
-	return InspectBlockUsageBindInternal(context, database_name, return_types, names);
+	return InspectBlockUsageBindInternal(context, input, database_name, return_types, names);
 }
 
 // inspect_block_usage() — uses current database
 unique_ptr<FunctionData> InspectBlockUsageBindCurrentDB(ClientContext &context, TableFunctionBindInput &input,
                                                         vector<LogicalType> &return_types, vector<string> &names) {
-	return InspectBlockUsageBindInternal(context, INVALID_CATALOG, return_types, names);
+	return InspectBlockUsageBindInternal(context, input, INVALID_CATALOG, return_types, names);
 }
 
 unique_ptr<GlobalTableFunctionState> InspectBlockUsageInit(ClientContext &context, TableFunctionInitInput &input) {
@@ -128,89 +153,57 @@ unique_ptr<GlobalTableFunctionState> InspectBlockUsageInit(ClientContext &contex
 		    "     D SELECT * FROM inspect_block_usage('mydb');\n\n");
 	}
 
-	// Get database size info
-	const auto ds = catalog.GetDatabaseSize(context);
-	const idx_t total_blocks = ds.total_blocks;
-	const idx_t free_blocks = ds.free_blocks;
-	const idx_t block_alloc_size = ds.block_size;
-
-	// Count metadata blocks
-	const auto metadata_info = catalog.GetMetadataInfo(context);
-	const idx_t metadata_blocks = CountMetadataBlocks(metadata_info);
-
-	// Count table data blocks (unique block IDs across all tables)
-	const idx_t table_data_blocks = CountTableDataBlocks(context, catalog);
-
-	// Index blocks = total - table_data - metadata - free_blocks
-	// TODO: count index blocks directly once IndexStorageInfo updates correctly after checkpoint.
-	const idx_t used_blocks = table_data_blocks + metadata_blocks + free_blocks;
-	D_ASSERT(used_blocks <= total_blocks);
-	const idx_t index_blocks = total_blocks - used_blocks;
-
-	// Build entries
-	result->entries.reserve(5);
-
-	BlockUsageEntry table_data_entry;
-	table_data_entry.component = "table_data";
-	table_data_entry.block_count = table_data_blocks;
-	table_data_entry.size_bytes = table_data_blocks * block_alloc_size;
-	table_data_entry.percentage = FormatPercentage(table_data_blocks, total_blocks);
-	result->entries.push_back(std::move(table_data_entry));
-
-	BlockUsageEntry index_entry;
-	index_entry.component = "index";
-	index_entry.block_count = index_blocks;
-	index_entry.size_bytes = index_blocks * block_alloc_size;
-	index_entry.percentage = FormatPercentage(index_blocks, total_blocks);
-	result->entries.push_back(std::move(index_entry));
-
-	BlockUsageEntry metadata_entry;
-	metadata_entry.component = "metadata";
-	metadata_entry.block_count = metadata_blocks;
-	metadata_entry.size_bytes = metadata_blocks * block_alloc_size;
-	metadata_entry.percentage = FormatPercentage(metadata_blocks, total_blocks);
-	result->entries.push_back(std::move(metadata_entry));
-
-	BlockUsageEntry free_blocks_entry;
-	free_blocks_entry.component = "free_blocks";
-	free_blocks_entry.block_count = free_blocks;
-	free_blocks_entry.size_bytes = free_blocks * block_alloc_size;
-	free_blocks_entry.percentage = FormatPercentage(free_blocks, total_blocks);
-	result->entries.push_back(std::move(free_blocks_entry));
-
-	BlockUsageEntry total_entry;
-	total_entry.component = "total";
-	total_entry.block_count = total_blocks;
-	total_entry.size_bytes = total_blocks * block_alloc_size;
-	total_entry.percentage = FormatPercentage(total_blocks, total_blocks);
-	result->entries.push_back(std::move(total_entry));
+	result->column_map = OutputWriter::BuildColumnMap(input.column_ids, OUTPUT_COLUMN_COUNT, bind_data.schema_columns);
+
+	if (bind_data.profile) {
+		result->profiler.Start(context, "inspect_block_usage", catalog.GetName());
+	}
+
+	result->inspection = make_uniq<BlockUsageInspection>(
+	    bind_data.sampling, InspectionDeadline::Start(bind_data.timeout_ms), result->profiler.Get());
+	result->result = result->inspection->Prepare(context, catalog);
 
 	return std::move(result);
 }
 
 void InspectBlockUsageExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
 	auto &state = data.global_state->Cast<InspectBlockUsageState>();
-
-	idx_t count = 0;
-
-	constexpr idx_t COMPONENT_IDX = 0;
-	constexpr idx_t SIZE_BYTES_IDX = 1;
-	constexpr idx_t PERCENTAGE_IDX = 2;
-	constexpr idx_t BLOCK_COUNT_IDX = 3;
-
-	while (state.offset < state.entries.size() && count < STANDARD_VECTOR_SIZE) {
-		auto &entry = state.entries[state.offset];
-
-		output.SetValue(COMPONENT_IDX, count, Value(entry.component));
-		output.SetValue(SIZE_BYTES_IDX, count, Value::BIGINT(NumericCast<int64_t>(entry.size_bytes)));
-		output.SetValue(PERCENTAGE_IDX, count, Value(entry.percentage));
-		output.SetValue(BLOCK_COUNT_IDX, count, Value::BIGINT(NumericCast<int64_t>(entry.block_count)));
+	if (!state.result) {
+		state.result = state.inspection->Compute(context);
+	}
+	const auto &usage = *state.result;
+
+	OutputWriter writer(output, state.column_map);
+	while (state.offset < usage.entries.size() && !writer.IsFull()) {
+		auto &entry = usage.entries[state.offset];
+
+		writer.WriteString(COMPONENT_IDX, string_t(entry.component));
+		writer.WriteBigint(SIZE_BYTES_IDX, entry.block_count * usage.block_alloc_size);
+		writer.WriteString(PERCENTAGE_IDX, FormatPercentage(entry.block_count, usage.total_blocks));
+		writer.WriteBigint(BLOCK_COUNT_IDX, entry.block_count);
+		if (entry.has_interval) {
+			writer.WriteBigint(SIZE_BYTES_LOW_IDX, entry.low_blocks * usage.block_alloc_size);
+			writer.WriteBigint(SIZE_BYTES_HIGH_IDX, entry.high_blocks * usage.block_alloc_size);
+		} else {
+			writer.WriteNull(SIZE_BYTES_LOW_IDX);
+			writer.WriteNull(SIZE_BYTES_HIGH_IDX);
+		}
+		writer.Write<bool>(TIMED_OUT_IDX, usage.timed_out);
+		writer.NextRow();
 
 		state.offset++;
-		count++;
 	}
 
-	output.SetCardinality(count);
+	writer.Finalize();
+}
+
+// Shows the profile in EXPLAIN ANALYZE
+InsertionOrderPreservingMap<string> InspectBlockUsageDynamicToString(TableFunctionDynamicToStringInput &input) {
+	if (!input.global_state) {
+		return InsertionOrderPreservingMap<string>();
+	}
+	const auto profile = input.global_state->Cast<InspectBlockUsageState>().profiler.Get();
+	return profile ? profile->ToProfilerInfo() : InsertionOrderPreservingMap<string>();
 }
 
 } // namespace
@@ -220,11 +213,19 @@ void RegisterInspectBlockUsageFunction(ExtensionLoader &loader) {
 	TableFunction inspect_block_usage_with_db("inspect_block_usage", {LogicalType {LogicalTypeId::VARCHAR}},
 	                                          InspectBlockUsageExecute, InspectBlockUsageBindWithDatabase,
 	                                          InspectBlockUsageInit);
+	RowGroupSampling::AddNamedParameters(inspect_block_usage_with_db);
+	InspectionDeadline::AddNamedParameter(inspect_block_usage_with_db);
+	InspectionProfile::AddNamedParameter(inspect_block_usage_with_db);
+	inspect_block_usage_with_db.dynamic_to_string = InspectBlockUsageDynamicToString;
 	loader.RegisterFunction(std::move(inspect_block_usage_with_db));
 
 	// inspect_block_usage() — uses current database
 	TableFunction inspect_block_usage_current_db("inspect_block_usage", {}, InspectBlockUsageExecute,
 	                                             InspectBlockUsageBindCurrentDB, InspectBlockUsageInit);
+	RowGroupSampling::AddNamedParameters(inspect_block_usage_current_db);
+	InspectionDeadline::AddNamedParameter(inspect_block_usage_current_db);
+	InspectionProfile::AddNamedParameter(inspect_block_usage_current_db);
+	inspect_block_usage_current_db.dynamic_to_string = InspectBlockUsageDynamicToString;
 	loader.RegisterFunction(std::move(inspect_block_usage_current_db));
 }
 
@@ -0,0 +1,411 @@
+#include "inspect_checkpoint.hpp"
+#include "block_bitmap.hpp"
+#include "database_file_reader.hpp"
+#include "inspection_deadline.hpp"
+#include "output_writer.hpp"
+#include "sampling.hpp"
+#include "wal_reader.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/catalog/default/default_schemas.hpp"
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/attached_database.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/storage/database_size.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/storage/table_storage_info.hpp"
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// inspect_checkpoint() - WAL growth and checkpoint cost
+//===--------------------------------------------------------------------===//
+
+// Reports what the next checkpoint will have to do, and what the last one did:
+// - The WAL holds everything committed since the last checkpoint. Its entries are counted from the file framing,
+//   and its size is compared to checkpoint_threshold, past which the next commit checkpoints automatically.
+// - Row groups with transient segments (appends) or updates are rewritten by the next checkpoint. Their size is
+//   extrapolated from the persisted row groups of the same table, or from the column types of tables that were
+//   never checkpointed.
+// - Checkpoints are not observable from an extension while they run. Every call records the free list of the
+//   checkpoint it sees, and compares it to the free list of the previously observed checkpoint: blocks that became
+//   used were written, blocks that became free were freed. With several checkpoints in between, the figures are
+//   the net change over all of them.
+
+// Used blocks of a checkpoint, as recorded by its free list
+struct CheckpointObservation {
+	idx_t iteration = 0;
+	timestamp_t observed_at;
+	idx_t total_blocks = 0;
+	BlockBitmap free_blocks;
+
+	bool IsUsed(idx_t block_id) const {
+		return block_id < total_blocks && !free_blocks.Test(NumericCast<block_id_t>(block_id));
+	}
+};
+
+// Change between two observed checkpoints
+struct CheckpointChange {
+	bool has_change = false;
+	idx_t checkpoint_count = 0;
+	idx_t blocks_written = 0;
+	idx_t blocks_freed = 0;
+};
+
+// Last observed checkpoint of one database, stored in the database instance's object cache
+class CheckpointTracker : public ObjectCacheEntry {
+public:
+	static string ObjectType() {
+		return "table_inspector_checkpoint_tracker";
+	}
+
+	string GetObjectType() override {
+		return ObjectType();
+	}
+
+	optional_idx GetEstimatedCacheMemory() const override {
+		lock_guard<mutex> guard(lock);
+		return optional_idx(sizeof(CheckpointTracker) + current.free_blocks.Capacity() / 8);
+	}
+
+	static shared_ptr<CheckpointTracker> Get(ClientContext &context, Catalog &catalog) {
+		// Key by name and path, so a different file attached under the same alias starts over
+		const auto key = ObjectType() + ":" + catalog.GetName() + ":" + catalog.GetDBPath();
+		return ObjectCache::GetObjectCache(context).GetOrCreate<CheckpointTracker>(key);
+	}
+
+	// Records the checkpoint, and returns the change since the checkpoint observed before it. observed_at is set to
+	// when the checkpoint was first observed.
+	CheckpointChange Observe(CheckpointObservation observation, timestamp_t &observed_at) {
+		lock_guard<mutex> guard(lock);
+		if (!has_current || observation.iteration != current.iteration) {
+			if (has_current) {
+				change = Compare(current, observation);
+			}
+			has_current = true;
+			current = std::move(observation);
+		}
+		observed_at = current.observed_at;
+		return change;
+	}
+
+private:
+	static CheckpointChange Compare(const CheckpointObservation &previous, const CheckpointObservation &next) {
+		CheckpointChange result;
+		// A different file at the same path
+		if (next.iteration < previous.iteration) {
+			return result;
+		}
+		result.has_change = true;
+		result.checkpoint_count = next.iteration - previous.iteration;
+		const idx_t block_count = MaxValue(previous.total_blocks, next.total_blocks);
+		for (idx_t block_id = 0; block_id < block_count; ++block_id) {
+			const bool was_used = previous.IsUsed(block_id);
+			const bool is_used = next.IsUsed(block_id);
+			if (is_used && !was_used) {
+				result.blocks_written++;
+			} else if (was_used && !is_used) {
+				result.blocks_freed++;
+			}
+		}
+		return result;
+	}
+
+private:
+	mutable mutex lock;
+	bool has_current = false;
+	CheckpointObservation current;
+	CheckpointChange change;
+};
+
+// Row groups the next checkpoint rewrites
+struct DirtyData {
+	idx_t dirty_tables = 0;
+	idx_t dirty_row_groups = 0;
+	idx_t dirty_rows = 0;
+	double estimated_bytes = 0;
+};
+
+// Upper-bound row width of a table that has no persisted rows to extrapolate from
+idx_t EstimateRowWidth(TableCatalogEntry &table) {
+	idx_t row_width = 0;
+	for (auto &col : table.GetColumns().Physical()) {
+		row_width += MaxValue<idx_t>(GetTypeIdSize(col.Type().InternalType()), 1);
+	}
+	return row_width;
+}
+
+void CollectDirtyRowGroups(ClientContext &context, TableCatalogEntry &table, idx_t block_alloc_size,
+                           DirtyData &result) {
+	QueryContext query_context {context};
+	const auto segment_info = table.GetColumnSegmentInfo(query_context);
+	const idx_t row_group_count = CountRowGroups(segment_info);
+	if (row_group_count == 0) {
+		return;
+	}
+
+	// Rows are counted on the data segments of the first column
+	vector<bool> is_dirty(row_group_count, false);
+	vector<idx_t> row_counts(row_group_count, 0);
+	const auto first_column = table.GetColumns().Physical().begin()->Physical().index;
+	const auto first_column_path = "[" + std::to_string(first_column) + "]";
+	for (const auto &seg : segment_info) {
+		// Constant segments are persistent without a block
+		if (!seg.persistent || seg.has_updates) {
+			is_dirty[seg.row_group_index] = true;
+		}
+		if (seg.column_id == first_column && seg.column_path == first_column_path) {
+			row_counts[seg.row_group_index] += seg.segment_count;
+		}
+	}
+
+	// Bytes per row of the row groups the checkpoint leaves alone
+	const auto row_group_sizes = CalculateRowGroupSizes(segment_info, block_alloc_size);
+	idx_t clean_bytes = 0;
+	idx_t clean_rows = 0;
+	idx_t dirty_row_groups = 0;
+	idx_t dirty_rows = 0;
+	for (idx_t row_group_idx = 0; row_group_idx < row_group_count; ++row_group_idx) {
+		if (is_dirty[row_group_idx]) {
+			dirty_row_groups++;
+			dirty_rows += row_counts[row_group_idx];
+		} else {
+			clean_bytes += row_group_sizes[row_group_idx];
+			clean_rows += row_counts[row_group_idx];
+		}
+	}
+	if (dirty_row_groups == 0) {
+		return;
+	}
+
+	const double bytes_per_row = clean_rows > 0 ? static_cast<double>(clean_bytes) / static_cast<double>(clean_rows)
+	                                            : static_cast<double>(EstimateRowWidth(table));
+	result.dirty_tables++;
+	result.dirty_row_groups += dirty_row_groups;
+	result.dirty_rows += dirty_rows;
+	result.estimated_bytes += bytes_per_row * static_cast<double>(dirty_rows);
+}
+
+struct CheckpointInfo {
+	string database_name;
+	idx_t iteration = 0;
+	WalSummary wal;
+	idx_t checkpoint_threshold = 0;
+	DirtyData dirty;
+	timestamp_t observed_at;
+	CheckpointChange last_change;
+};
+
+struct InspectCheckpointBindData : public TableFunctionData {
+	explicit InspectCheckpointBindData(string database_name_p) : database_name(std::move(database_name_p)) {
+	}
+
+	string database_name;
+};
+
+struct InspectCheckpointState : public GlobalTableFunctionState {
+	InspectCheckpointState() : finished(false) {
+	}
+
+	CheckpointInfo info;
+	bool finished;
+};
+
+// Shared bind logic for all inspect_checkpoint overloads
+unique_ptr<FunctionData> InspectCheckpointBindInternal(const string &database_name, vector<LogicalType> &return_types,
+                                                       vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	names.reserve(15);
+	return_types.reserve(15);
+	names.emplace_back("database_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("checkpoint_iteration");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("wal_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("wal_entries");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("wal_commits");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("checkpoint_threshold_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("checkpoint_due");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BOOLEAN});
+	names.emplace_back("dirty_tables");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("dirty_row_groups");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("dirty_rows");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("estimated_checkpoint_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("checkpoint_observed_at");
+	return_types.emplace_back(LogicalType {LogicalTypeId::TIMESTAMP_TZ});
+	names.emplace_back("checkpoints_since_previous");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("blocks_written");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("blocks_freed");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	return make_uniq<InspectCheckpointBindData>(database_name);
+}
+
+// inspect_checkpoint(database_name)
+unique_ptr<FunctionData> InspectCheckpointBindWithDatabase(ClientContext &context, TableFunctionBindInput &input,
+                                                           vector<LogicalType> &return_types, vector<string> &names) {
+	return InspectCheckpointBindInternal(input.inputs[0].GetValue<string>(), return_types, names);
+}
+
+// inspect_checkpoint() — uses current database
+unique_ptr<FunctionData> InspectCheckpointBindCurrentDB(ClientContext &context, TableFunctionBindInput &input,
+                                                        vector<LogicalType> &return_types, vector<string> &names) {
+	// INVALID_CATALOG retrieves the currently active catalog
+	return InspectCheckpointBindInternal(INVALID_CATALOG, return_types, names);
+}
+
+unique_ptr<GlobalTableFunctionState> InspectCheckpointInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<InspectCheckpointState>();
+
+	auto &bind_data = input.bind_data->Cast<InspectCheckpointBindData>();
+	auto &catalog = Catalog::GetCatalog(context, bind_data.database_name);
+
+	// Require persistent database
+	if (catalog.InMemory()) {
+		throw InvalidInputException(
+		    "inspect_checkpoint() requires a persistent database file.\n"
+		    "In-memory databases have no write-ahead log and never checkpoint.\n\n"
+		    "Correct usage:\n"
+		    "  1. Open a database file directly:\n"
+		    "     $ duckdb mydata.duckdb\n"
+		    "     D SELECT * FROM inspect_checkpoint();\n\n"
+		    "  2. Or attach a database file:\n"
+		    "     D ATTACH 'mydata.duckdb' AS mydb;\n"
+		    "     D SELECT * FROM inspect_checkpoint('mydb');\n\n");
+	}
+
+	auto &info = result->info;
+	info.database_name = catalog.GetName();
+	info.checkpoint_threshold = DBConfig::GetConfig(context).options.checkpoint_wal_size;
+
+	auto &fs = FileSystem::GetFileSystem(context);
+	info.wal = ReadWalSummary(fs, catalog.GetAttached().GetStorageManager().GetWALPath());
+
+	// The free list of the last checkpoint, recorded for the next call
+	DatabaseFileReader reader(fs, catalog.GetDBPath());
+	const auto file_info = reader.Read();
+	CheckpointObservation observation;
+	observation.iteration = file_info.iteration;
+	observation.observed_at = Timestamp::GetCurrentTimestamp();
+	observation.total_blocks = file_info.block_count;
+	observation.free_blocks.Reserve(file_info.block_count);
+	for (const auto block_id : file_info.free_blocks) {
+		observation.free_blocks.Set(block_id);
+	}
+	info.iteration = file_info.iteration;
+	info.last_change = CheckpointTracker::Get(context, catalog)->Observe(std::move(observation), info.observed_at);
+
+	auto schemas = catalog.GetSchemas(context);
+	for (auto &schema_ref : schemas) {
+		auto &schema = schema_ref.get();
+
+		// Skip internal schemas
+		if (DefaultSchemaGenerator::IsDefaultSchema(schema.name)) {
+			continue;
+		}
+
+		schema.Scan(context, CatalogType::TABLE_ENTRY, [&](CatalogEntry &entry) {
+			CheckInterrupted(context);
+			CollectDirtyRowGroups(context, entry.Cast<TableCatalogEntry>(), file_info.block_alloc_size, info.dirty);
+		});
+	}
+
+	return std::move(result);
+}
+
+void InspectCheckpointExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectCheckpointState>();
+	if (state.finished) {
+		output.SetCardinality(0);
+		return;
+	}
+	const auto &info = state.info;
+
+	constexpr idx_t DATABASE_NAME_IDX = 0;
+	constexpr idx_t CHECKPOINT_ITERATION_IDX = 1;
+	constexpr idx_t WAL_BYTES_IDX = 2;
+	constexpr idx_t WAL_ENTRIES_IDX = 3;
+	constexpr idx_t WAL_COMMITS_IDX = 4;
+	constexpr idx_t CHECKPOINT_THRESHOLD_IDX = 5;
+	constexpr idx_t CHECKPOINT_DUE_IDX = 6;
+	constexpr idx_t DIRTY_TABLES_IDX = 7;
+	constexpr idx_t DIRTY_ROW_GROUPS_IDX = 8;
+	constexpr idx_t DIRTY_ROWS_IDX = 9;
+	constexpr idx_t ESTIMATED_CHECKPOINT_BYTES_IDX = 10;
+	constexpr idx_t CHECKPOINT_OBSERVED_AT_IDX = 11;
+	constexpr idx_t CHECKPOINTS_SINCE_PREVIOUS_IDX = 12;
+	constexpr idx_t BLOCKS_WRITTEN_IDX = 13;
+	constexpr idx_t BLOCKS_FREED_IDX = 14;
+
+	OutputWriter writer(output);
+	writer.WriteString(DATABASE_NAME_IDX, info.database_name);
+	writer.WriteBigint(CHECKPOINT_ITERATION_IDX, info.iteration);
+	writer.WriteBigint(WAL_BYTES_IDX, info.wal.file_bytes);
+	if (info.wal.readable) {
+		writer.WriteBigint(WAL_ENTRIES_IDX, info.wal.entry_count);
+		writer.WriteBigint(WAL_COMMITS_IDX, info.wal.commit_count);
+	} else {
+		writer.WriteNull(WAL_ENTRIES_IDX);
+		writer.WriteNull(WAL_COMMITS_IDX);
+	}
+	writer.WriteBigint(CHECKPOINT_THRESHOLD_IDX, info.checkpoint_threshold);
+	writer.Write<bool>(CHECKPOINT_DUE_IDX, info.wal.file_bytes >= info.checkpoint_threshold);
+	writer.WriteBigint(DIRTY_TABLES_IDX, info.dirty.dirty_tables);
+	writer.WriteBigint(DIRTY_ROW_GROUPS_IDX, info.dirty.dirty_row_groups);
+	writer.WriteBigint(DIRTY_ROWS_IDX, info.dirty.dirty_rows);
+	writer.WriteBigint(ESTIMATED_CHECKPOINT_BYTES_IDX, static_cast<idx_t>(info.dirty.estimated_bytes));
+	writer.Write<timestamp_tz_t>(CHECKPOINT_OBSERVED_AT_IDX, timestamp_tz_t(info.observed_at));
+	if (info.last_change.has_change) {
+		writer.WriteBigint(CHECKPOINTS_SINCE_PREVIOUS_IDX, info.last_change.checkpoint_count);
+		writer.WriteBigint(BLOCKS_WRITTEN_IDX, info.last_change.blocks_written);
+		writer.WriteBigint(BLOCKS_FREED_IDX, info.last_change.blocks_freed);
+	} else {
+		writer.WriteNull(CHECKPOINTS_SINCE_PREVIOUS_IDX);
+		writer.WriteNull(BLOCKS_WRITTEN_IDX);
+		writer.WriteNull(BLOCKS_FREED_IDX);
+	}
+	writer.NextRow();
+	writer.Finalize();
+
+	state.finished = true;
+}
+
+} // namespace
+
+void RegisterInspectCheckpointFunction(ExtensionLoader &loader) {
+	// inspect_checkpoint(database_name)
+	TableFunction inspect_checkpoint_with_db("inspect_checkpoint", {LogicalType {LogicalTypeId::VARCHAR}},
+	                                         InspectCheckpointExecute, InspectCheckpointBindWithDatabase,
+	                                         InspectCheckpointInit);
+	loader.RegisterFunction(std::move(inspect_checkpoint_with_db));
+
+	// inspect_checkpoint() — uses current database
+	TableFunction inspect_checkpoint_current_db("inspect_checkpoint", {}, InspectCheckpointExecute,
+	                                            InspectCheckpointBindCurrentDB, InspectCheckpointInit);
+	loader.RegisterFunction(std::move(inspect_checkpoint_current_db));
+}
+
+} // namespace duckdb
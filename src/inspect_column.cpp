@@ -1,18 +1,29 @@
 #include "inspect_column.hpp"
+#include "output_writer.hpp"
+#include "sampling.hpp"
+#include "segment_snapshot.hpp"
+#include "util.hpp"
 
 #include "duckdb/catalog/catalog.hpp"
 #include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
 #include "duckdb/common/algorithm.hpp"
 #include "duckdb/common/assert.hpp"
 #include "duckdb/common/exception.hpp"
+#include "duckdb/common/limits.hpp"
+#include "duckdb/common/numeric_utils.hpp"
 #include "duckdb/common/optional_idx.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "duckdb/common/types.hpp"
-#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
 #include "duckdb/parser/qualified_name.hpp"
 #include "duckdb/planner/binder.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/planner/filter/conjunction_filter.hpp"
+#include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/table_filter.hpp"
 #include "duckdb/storage/storage_manager.hpp"
 #include "duckdb/storage/table_storage_info.hpp"
 
@@ -21,46 +32,106 @@ namespace duckdb {
 namespace {
 
 //===--------------------------------------------------------------------===//
-// inspect_column() - Show per-segment storage info for a specific column
+// inspect_column() / inspect_columns() - Show per-segment storage info for columns
 //===--------------------------------------------------------------------===//
 
-// Filtered segment entry with calculated compressed size
+// inspect_column() reports a single column, inspect_columns() reports all (or a selected list of) columns of a
+// table. Both share one pass over the table's segments: the block offset map used for compressed size calculation
+// is built once and shared across all target columns.
+//
+// Bind only resolves the table and columns, so EXPLAIN and prepared statements stay cheap. Segments are collected
+// in Init. Projection pushdown skips cells that aren't needed (and the offset map entirely if compressed_bytes isn't
+// read), filter pushdown prunes row groups outside a row_group_id range before any row is materialized.
+//
+// With `sample` or `max_row_groups`, only the segments of a stratified sample of row groups are collected and
+// reported, drawn from the row groups in the table's partition statistics. Every row then carries a sample_weight, the
+// number of row groups its row group stands for, so weighted sums extrapolate to the whole table. Compressed sizes
+// are computed from the sampled segments alone, so a segment sharing its block with a row group that wasn't sampled
+// can be charged for the space up to the next sampled segment.
+
+// Output column layout
+constexpr idx_t ROW_GROUP_ID_IDX = 0;
+constexpr idx_t COLUMN_NAME_IDX = 1;
+constexpr idx_t COLUMN_TYPE_IDX = 2;
+constexpr idx_t COMPRESSION_IDX = 3;
+constexpr idx_t COMPRESSED_BYTES_IDX = 4;
+constexpr idx_t ESTIMATED_DECOMPRESSED_BYTES_IDX = 5;
+constexpr idx_t ROW_COUNT_IDX = 6;
+// Only present with row group sampling
+constexpr idx_t SAMPLE_WEIGHT_IDX = 7;
+constexpr idx_t OUTPUT_COLUMN_COUNT = 8;
+
+// A column whose segments are reported
+struct TargetColumn {
+	TargetColumn(string name_p, LogicalType type_p, idx_t physical_id_p)
+	    : name(std::move(name_p)), type(std::move(type_p)), type_name(type.ToString()), physical_id(physical_id_p) {
+	}
+
+	string name;
+	LogicalType type;
+	string type_name;
+	idx_t physical_id;
+};
+
+// Filtered segment entry with calculated compressed size.
+// Points into the snapshot's segment info, the remaining cells are materialized when the row is emitted. Names and
+// types live once per target column, so an entry is 24 bytes however many segments a column has.
 struct FilteredSegmentEntry {
-	idx_t row_group_index;
-	string column_name;
-	LogicalType column_type;
-	string compression_type;
+	const ColumnSegmentInfo *segment;
+	// Index into the bind data's target columns
+	uint32_t target_idx;
+	// Number of row groups the segment's row group stands for, 1 without sampling
+	uint32_t sample_weight;
+	// Size within the main block, additional blocks of large segments are added when the row is emitted
 	idx_t compressed_size;
-	idx_t additional_blocks_size; // Size from additional_blocks (for large segments)
-	idx_t row_count;
 };
 
 struct InspectColumnBindData : public TableFunctionData {
-	InspectColumnBindData(TableCatalogEntry &table_entry_p, string column_name_p, LogicalType column_type_p)
-	    : table_entry(table_entry_p), column_name(std::move(column_name_p)), column_type(std::move(column_type_p)) {
+	InspectColumnBindData(TableCatalogEntry &table_entry_p, vector<TargetColumn> columns_p,
+	                      RowGroupSampling sampling_p)
+	    : table_entry(table_entry_p), columns(std::move(columns_p)), sampling(sampling_p) {
 	}
 
 	TableCatalogEntry &table_entry;
-	string column_name;
-	LogicalType column_type;
-	vector<FilteredSegmentEntry> filtered_segments;
+	vector<TargetColumn> columns;
+	RowGroupSampling sampling;
+	// Physical column id -> index into columns, INVALID_INDEX for columns that aren't reported
+	vector<idx_t> column_to_target;
+	vector<LogicalType> return_types;
+};
+
+// Inclusive range of row groups that can pass the pushed down filters
+struct RowGroupRange {
+	idx_t min = 0;
+	idx_t max = NumericLimits<idx_t>::Maximum();
+
+	bool Contains(idx_t row_group_index) const {
+		return row_group_index >= min && row_group_index <= max;
+	}
 };
 
 struct InspectColumnState : public GlobalTableFunctionState {
 	InspectColumnState() : offset(0) {
 	}
 
+	// Keeps the segments referenced by filtered_segments alive
+	SegmentSnapshot::TableSegments segments;
+	vector<FilteredSegmentEntry> filtered_segments;
+	idx_t block_alloc_size = 0;
 	idx_t offset;
+
+	// Output column -> output chunk position, from projection pushdown
+	vector<idx_t> column_map;
+	// Pushed down filters, evaluated on every produced chunk
+	unique_ptr<Expression> filter_expression;
+	unique_ptr<ExpressionExecutor> filter_executor;
 };
 
-// Check if segment is a target column's main data segment (not validity bitmap)
-bool IsTargetMainDataSegment(const ColumnSegmentInfo &seg, idx_t target_column_id) {
-	if (seg.column_id != target_column_id) {
-		return false;
-	}
+// Check if segment is a column's main data segment (not validity bitmap). main_data_path is the path of the
+// segment's column, "[column_id]", formatted once per column rather than once per segment.
+bool IsMainDataSegment(const ColumnSegmentInfo &seg, const string &main_data_path) {
 	// Skip validity bitmap segments (e.g., "[0, 0]") - only include main data segments ("[column_id]")
-	const string expected_path = StringUtil::Format("[%d]", seg.column_id);
-	if (seg.column_path != expected_path) {
+	if (seg.column_path != main_data_path) {
 		return false;
 	}
 	// Skip non-persistent segments
@@ -70,59 +141,65 @@ bool IsTargetMainDataSegment(const ColumnSegmentInfo &seg, idx_t target_column_i
 	return true;
 }
 
-// Groups ALL segments by block_id to calculate sizes based on offset differences
+// Uses ALL segments (of every column) to calculate sizes based on offset differences within a block.
+// column_to_target maps a physical column id to its index in the target columns, or INVALID_INDEX if the column
+// isn't reported. Only segments in row_groups are returned. row_group_weights holds the sample weight of every row
+// group, zero for row groups outside the sample; it's empty without sampling. Without need_sizes no sizes are
+// calculated and the compressed sizes are left at zero.
+// The entries are counted before they're collected, so the result is allocated once at its final size.
 vector<FilteredSegmentEntry> FilterAndCalculateSegments(const vector<ColumnSegmentInfo> &all_segments,
-                                                        idx_t target_column_id, const string &column_name,
-                                                        const LogicalType &column_type, idx_t block_alloc_size) {
-	// Build a map of block_id -> all segment offsets (sorted)
-	// This includes segments from ALL columns, so we can calculate sizes
-	unordered_map<block_id_t, vector<idx_t>> block_to_all_offsets;
-
-	for (const auto &seg : all_segments) {
-		if (!seg.persistent || seg.block_id == INVALID_BLOCK) {
-			continue;
+                                                        const vector<idx_t> &column_to_target,
+                                                        const RowGroupRange &row_groups,
+                                                        const vector<idx_t> &row_group_weights, bool need_sizes,
+                                                        idx_t block_alloc_size) {
+	vector<string> main_data_paths(column_to_target.size());
+	for (idx_t column_id = 0; column_id < column_to_target.size(); ++column_id) {
+		if (column_to_target[column_id] != DConstants::INVALID_INDEX) {
+			main_data_paths[column_id] = StringUtil::Format("[%d]", column_id);
 		}
-		block_to_all_offsets[seg.block_id].push_back(seg.block_offset);
 	}
 
-	// Sort offsets within each block
-	for (auto &block_entry : block_to_all_offsets) {
-		std::sort(block_entry.second.begin(), block_entry.second.end());
-	}
+	// Sample weight of a reported segment, zero for segments that aren't reported
+	const auto get_sample_weight = [&](const ColumnSegmentInfo &seg) -> idx_t {
+		if (seg.column_id >= column_to_target.size() || column_to_target[seg.column_id] == DConstants::INVALID_INDEX) {
+			return 0;
+		}
+		if (!row_groups.Contains(seg.row_group_index) || !IsMainDataSegment(seg, main_data_paths[seg.column_id])) {
+			return 0;
+		}
+		return row_group_weights.empty() ? 1 : row_group_weights[seg.row_group_index];
+	};
 
-	vector<FilteredSegmentEntry> entries;
+	idx_t entry_count = 0;
 	for (const auto &seg : all_segments) {
-		if (!IsTargetMainDataSegment(seg, target_column_id)) {
-			continue;
+		if (get_sample_weight(seg) != 0) {
+			entry_count++;
 		}
+	}
 
-		// Calculate compressed size by looking at the next offset in the same block
-		auto &offsets = block_to_all_offsets[seg.block_id];
-		auto it = std::lower_bound(offsets.begin(), offsets.end(), seg.block_offset);
-		D_ASSERT(it != offsets.end() && *it == seg.block_offset);
+	vector<FilteredSegmentEntry> entries;
+	if (entry_count == 0) {
+		return entries;
+	}
+	vector<idx_t> segment_sizes;
+	if (need_sizes) {
+		segment_sizes = CalculateSegmentSizes(all_segments, block_alloc_size);
+	}
 
-		idx_t compressed_size;
-		if (it + 1 != offsets.end()) {
-			// There's a next segment in this block - exact size
-			compressed_size = *(it + 1) - seg.block_offset;
-		} else {
-			// Last segment in block: upper bound
-			compressed_size = block_alloc_size - seg.block_offset;
+	entries.reserve(entry_count);
+	for (idx_t segment_idx = 0; segment_idx < all_segments.size(); ++segment_idx) {
+		const auto &seg = all_segments[segment_idx];
+		const idx_t sample_weight = get_sample_weight(seg);
+		if (sample_weight == 0) {
+			continue;
 		}
 
-		// Handle additional_blocks for large segments that span multiple blocks
-		const idx_t additional_size = seg.additional_blocks.size() * block_alloc_size;
-
 		FilteredSegmentEntry entry;
-		entry.row_group_index = seg.row_group_index;
-		entry.column_name = column_name;
-		entry.column_type = column_type;
-		entry.compression_type = seg.compression_type;
-		entry.compressed_size = compressed_size;
-		entry.additional_blocks_size = additional_size;
-		entry.row_count = seg.segment_count;
-
-		entries.push_back(std::move(entry));
+		entry.segment = &seg;
+		entry.target_idx = NumericCast<uint32_t>(column_to_target[seg.column_id]);
+		entry.sample_weight = NumericCast<uint32_t>(sample_weight);
+		entry.compressed_size = need_sizes ? segment_sizes[segment_idx] : 0;
+		entries.push_back(entry);
 	}
 
 	return entries;
@@ -140,16 +217,50 @@ optional_idx CalculateEstimatedDecompressedSize(const LogicalType &type, idx_t r
 	return optional_idx(type_size * row_count);
 }
 
-// Shared bind logic for all inspect_column overloads
+// Resolves the target columns by name. An empty list selects all physical columns of the table.
+vector<TargetColumn> ResolveTargetColumns(TableCatalogEntry &table_entry, const vector<string> &column_names) {
+	auto &columns = table_entry.GetColumns();
+
+	vector<TargetColumn> result;
+	if (column_names.empty()) {
+		for (auto &col : columns.Physical()) {
+			result.emplace_back(col.Name(), col.Type(), col.Physical().index);
+		}
+		return result;
+	}
+
+	for (const auto &column_name : column_names) {
+		if (!columns.ColumnExists(column_name)) {
+			throw InvalidInputException("Column '%s' not found in table '%s'", column_name, table_entry.name);
+		}
+		const auto &col = columns.GetColumn(column_name);
+		if (col.Generated()) {
+			throw InvalidInputException("Column '%s' in table '%s' is a generated column and has no storage",
+			                            column_name, table_entry.name);
+		}
+		const idx_t physical_id = col.Physical().index;
+		// Ignore duplicates in the column list
+		const bool duplicate = std::any_of(result.begin(), result.end(), [&](const TargetColumn &target) {
+			return target.physical_id == physical_id;
+		});
+		if (!duplicate) {
+			result.emplace_back(col.Name(), col.Type(), physical_id);
+		}
+	}
+	return result;
+}
+
+// Shared bind logic for all inspect_column and inspect_columns overloads
 unique_ptr<FunctionData> InspectColumnBindInternal(ClientContext &context, const string &database_name,
-                                                   const string &table_name_str, const string &column_name,
-                                                   vector<LogicalType> &return_types, vector<string> &names) {
+                                                   const string &table_name_str, const vector<string> &column_names,
+                                                   const RowGroupSampling &sampling, vector<LogicalType> &return_types,
+                                                   vector<string> &names) {
 	D_ASSERT(names.empty());
 	D_ASSERT(return_types.empty());
 
 	// Define output columns
-	names.reserve(7);
-	return_types.reserve(7);
+	names.reserve(OUTPUT_COLUMN_COUNT);
+	return_types.reserve(OUTPUT_COLUMN_COUNT);
 	names.emplace_back("row_group_id");
 	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
 	names.emplace_back("column_name");
@@ -164,6 +275,10 @@ unique_ptr<FunctionData> InspectColumnBindInternal(ClientContext &context, const
 	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
 	names.emplace_back("row_count");
 	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	if (sampling.IsEnabled()) {
+		names.emplace_back("sample_weight");
+		return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	}
 
 	// Parse table name (handles schema.table format)
 	auto qname = QualifiedName::Parse(table_name_str);
@@ -172,25 +287,14 @@ unique_ptr<FunctionData> InspectColumnBindInternal(ClientContext &context, const
 	auto &catalog_entry = Catalog::GetEntry(context, CatalogType::TABLE_ENTRY, database_name, qname.schema, qname.name);
 	auto &table_entry = catalog_entry.Cast<TableCatalogEntry>();
 
-	// Find the target column
-	auto &columns = table_entry.GetColumns();
-	if (!columns.ColumnExists(column_name)) {
-		throw InvalidInputException("Column '%s' not found in table '%s'", column_name, qname.name);
+	// Find the target columns
+	auto result =
+	    make_uniq<InspectColumnBindData>(table_entry, ResolveTargetColumns(table_entry, column_names), sampling);
+	result->column_to_target.resize(table_entry.GetColumns().PhysicalColumnCount(), DConstants::INVALID_INDEX);
+	for (idx_t target_idx = 0; target_idx < result->columns.size(); ++target_idx) {
+		result->column_to_target[result->columns[target_idx].physical_id] = target_idx;
 	}
-	const auto &col = columns.GetColumn(column_name);
-	const idx_t target_column_id = col.Physical().index;
-	const LogicalType column_type = col.Type();
-
-	auto result = make_uniq<InspectColumnBindData>(table_entry, column_name, column_type);
-
-	// Get block allocation size for compressed size calculation
-	auto &storage_manager = table_entry.ParentCatalog().GetAttached().GetStorageManager();
-	const idx_t block_alloc_size = storage_manager.GetBlockManager().GetBlockAllocSize();
-
-	QueryContext query_context {context};
-	const auto all_segments = table_entry.GetColumnSegmentInfo(query_context);
-	result->filtered_segments =
-	    FilterAndCalculateSegments(all_segments, target_column_id, column_name, column_type, block_alloc_size);
+	result->return_types = return_types;
 
 	return std::move(result);
 }
@@ -201,7 +305,9 @@ unique_ptr<FunctionData> InspectColumnBindWithDatabase(ClientContext &context, T
 	const auto database_name = input.inputs[0].GetValue<string>();
 	const auto table_name_str = input.inputs[1].GetValue<string>();
 	const auto column_name = input.inputs[2].GetValue<string>();
-	return InspectColumnBindInternal(context, database_name, table_name_str, column_name, return_types, names);
+	const auto sampling = RowGroupSampling::FromNamedParameters(input.named_parameters, "inspect_column");
+	return InspectColumnBindInternal(context, database_name, table_name_str, {column_name}, sampling, return_types,
+	                                 names);
 }
 
 // inspect_column(table_name, column_name) — uses current database
@@ -209,54 +315,224 @@ unique_ptr<FunctionData> InspectColumnBindCurrentDB(ClientContext &context, Tabl
                                                     vector<LogicalType> &return_types, vector<string> &names) {
 	const auto table_name_str = input.inputs[0].GetValue<string>();
 	const auto column_name = input.inputs[1].GetValue<string>();
-	return InspectColumnBindInternal(context, INVALID_CATALOG, table_name_str, column_name, return_types, names);
+	const auto sampling = RowGroupSampling::FromNamedParameters(input.named_parameters, "inspect_column");
+	return InspectColumnBindInternal(context, INVALID_CATALOG, table_name_str, {column_name}, sampling, return_types,
+	                                 names);
 }
 
-unique_ptr<GlobalTableFunctionState> InspectColumnInit(ClientContext &context, TableFunctionInitInput &input) {
-	return make_uniq<InspectColumnState>();
+// Reads the optional `columns := [...]` filter of inspect_columns(); no filter selects all columns
+vector<string> GetColumnsParameter(TableFunctionBindInput &input) {
+	vector<string> column_names;
+	auto entry = input.named_parameters.find("columns");
+	if (entry == input.named_parameters.end() || entry->second.IsNull()) {
+		return column_names;
+	}
+	for (const auto &child : ListValue::GetChildren(entry->second)) {
+		if (child.IsNull()) {
+			throw InvalidInputException("inspect_columns() column list must not contain NULL");
+		}
+		column_names.push_back(child.GetValue<string>());
+	}
+	if (column_names.empty()) {
+		throw InvalidInputException("inspect_columns() column list must not be empty");
+	}
+	return column_names;
 }
 
-void InspectColumnExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
-	auto &bind_data = data.bind_data->Cast<InspectColumnBindData>();
-	auto &state = data.global_state->Cast<InspectColumnState>();
+// inspect_columns(database_name, table_name)
+unique_ptr<FunctionData> InspectColumnsBindWithDatabase(ClientContext &context, TableFunctionBindInput &input,
+                                                        vector<LogicalType> &return_types, vector<string> &names) {
+	const auto database_name = input.inputs[0].GetValue<string>();
+	const auto table_name_str = input.inputs[1].GetValue<string>();
+	const auto sampling = RowGroupSampling::FromNamedParameters(input.named_parameters, "inspect_columns");
+	return InspectColumnBindInternal(context, database_name, table_name_str, GetColumnsParameter(input), sampling,
+	                                 return_types, names);
+}
+
+// inspect_columns(table_name) — uses current database
+unique_ptr<FunctionData> InspectColumnsBindCurrentDB(ClientContext &context, TableFunctionBindInput &input,
+                                                     vector<LogicalType> &return_types, vector<string> &names) {
+	const auto table_name_str = input.inputs[0].GetValue<string>();
+	const auto sampling = RowGroupSampling::FromNamedParameters(input.named_parameters, "inspect_columns");
+	return InspectColumnBindInternal(context, INVALID_CATALOG, table_name_str, GetColumnsParameter(input), sampling,
+	                                 return_types, names);
+}
+
+// Narrows the row group range with a filter on row_group_id.
+// Only constant comparisons (and conjunctions of them) narrow the range. Other filters keep the full range, they're
+// still evaluated on the output.
+void NarrowRowGroupRange(const TableFilter &filter, RowGroupRange &range) {
+	switch (filter.filter_type) {
+	case TableFilterType::CONJUNCTION_AND: {
+		auto &conjunction = filter.Cast<ConjunctionAndFilter>();
+		for (auto &child : conjunction.child_filters) {
+			NarrowRowGroupRange(*child, range);
+		}
+		return;
+	}
+	case TableFilterType::CONSTANT_COMPARISON: {
+		auto &comparison = filter.Cast<ConstantFilter>();
+		if (comparison.constant.IsNull()) {
+			return;
+		}
+		const auto constant = comparison.constant.GetValue<int64_t>();
+		// Row group ids are never negative
+		const idx_t bound = constant < 0 ? 0 : static_cast<idx_t>(constant);
+		switch (comparison.comparison_type) {
+		case ExpressionType::COMPARE_EQUAL:
+			range.min = MaxValue(range.min, bound);
+			range.max = MinValue(range.max, bound);
+			return;
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			range.min = MaxValue(range.min, bound);
+			return;
+		case ExpressionType::COMPARE_GREATERTHAN:
+			range.min = MaxValue(range.min, constant < 0 ? 0 : bound + 1);
+			return;
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			if (constant < 0) {
+				range.max = 0;
+				range.min = 1;
+				return;
+			}
+			range.max = MinValue(range.max, bound);
+			return;
+		case ExpressionType::COMPARE_LESSTHAN:
+			if (constant <= 0) {
+				range.max = 0;
+				range.min = 1;
+				return;
+			}
+			range.max = MinValue(range.max, bound - 1);
+			return;
+		default:
+			return;
+		}
+	}
+	default:
+		return;
+	}
+}
+
+unique_ptr<GlobalTableFunctionState> InspectColumnInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<InspectColumnBindData>();
+	auto result = make_uniq<InspectColumnState>();
+	result->column_map = OutputWriter::BuildColumnMap(input.column_ids, OUTPUT_COLUMN_COUNT);
+
+	// Pushed down filters: narrow the row group range where possible, and evaluate all of them on the output.
+	// Filters are keyed by their position in column_ids, which is also their position in the output chunk.
+	RowGroupRange row_groups;
+	if (input.filters) {
+		vector<unique_ptr<Expression>> filter_expressions;
+		for (auto &entry : input.filters->filters) {
+			const idx_t output_idx = entry.first;
+			const column_t column_id = input.column_ids[output_idx];
+			if (column_id == ROW_GROUP_ID_IDX) {
+				NarrowRowGroupRange(*entry.second, row_groups);
+			}
+			BoundReferenceExpression column_ref(bind_data.return_types[column_id], output_idx);
+			filter_expressions.push_back(entry.second->ToExpression(column_ref));
+		}
 
-	idx_t count = 0;
+		if (filter_expressions.size() == 1) {
+			result->filter_expression = std::move(filter_expressions[0]);
+		} else if (!filter_expressions.empty()) {
+			auto conjunction = make_uniq<BoundConjunctionExpression>(ExpressionType::CONJUNCTION_AND);
+			conjunction->children = std::move(filter_expressions);
+			result->filter_expression = std::move(conjunction);
+		}
+		if (result->filter_expression) {
+			result->filter_executor = make_uniq<ExpressionExecutor>(context, *result->filter_expression);
+		}
+	}
 
-	constexpr idx_t ROW_GROUP_ID_IDX = 0;
-	constexpr idx_t COLUMN_NAME_IDX = 1;
-	constexpr idx_t COLUMN_TYPE_IDX = 2;
-	constexpr idx_t COMPRESSION_IDX = 3;
-	constexpr idx_t COMPRESSED_BYTES_IDX = 4;
-	constexpr idx_t ESTIMATED_DECOMPRESSED_BYTES_IDX = 5;
-	constexpr idx_t ROW_COUNT_IDX = 6;
+	// Offsets are only needed to compute compressed_bytes
+	const bool need_sizes = result->column_map[COMPRESSED_BYTES_IDX] != DConstants::INVALID_INDEX;
+
+	// Get block allocation size for compressed size calculation
+	auto &table_entry = bind_data.table_entry;
+	auto &storage_manager = table_entry.ParentCatalog().GetAttached().GetStorageManager();
+	const idx_t block_alloc_size = storage_manager.GetBlockManager().GetBlockAllocSize();
+	result->block_alloc_size = block_alloc_size;
 
-	while (state.offset < bind_data.filtered_segments.size() && count < STANDARD_VECTOR_SIZE) {
-		auto &entry = bind_data.filtered_segments[state.offset];
+	auto snapshot = SegmentSnapshot::Get(context, table_entry.ParentCatalog());
 
-		output.SetValue(ROW_GROUP_ID_IDX, count, Value::BIGINT(NumericCast<int64_t>(entry.row_group_index)));
-		output.SetValue(COLUMN_NAME_IDX, count, Value(entry.column_name));
-		output.SetValue(COLUMN_TYPE_IDX, count, Value(entry.column_type.ToString()));
-		output.SetValue(COMPRESSION_IDX, count, Value(entry.compression_type));
+	// Sample weight per row group, zero for row groups that aren't sampled
+	vector<idx_t> row_group_weights;
+	if (bind_data.sampling.IsEnabled()) {
+		auto sampled = snapshot->GetSampledSegments(context, table_entry, bind_data.sampling);
+		row_group_weights.resize(sampled.row_group_count, 0);
+		for (const auto &row_group : sampled.sample) {
+			row_group_weights[row_group.row_group_index] = row_group.weight;
+		}
+		result->segments = make_shared_ptr<const vector<ColumnSegmentInfo>>(std::move(sampled.segments));
+	} else {
+		result->segments = snapshot->GetTableSegments(context, table_entry);
+	}
+	result->filtered_segments = FilterAndCalculateSegments(*result->segments, bind_data.column_to_target, row_groups,
+	                                                       row_group_weights, need_sizes, block_alloc_size);
 
-		// Total compressed size = main block portion + additional blocks
-		const idx_t total_compressed_size = entry.compressed_size + entry.additional_blocks_size;
-		output.SetValue(COMPRESSED_BYTES_IDX, count, Value::BIGINT(NumericCast<int64_t>(total_compressed_size)));
+	return std::move(result);
+}
 
-		const auto estimated_size = CalculateEstimatedDecompressedSize(entry.column_type, entry.row_count);
+// Fills the output with the next batch of segments, without applying filters
+void EmitSegments(const InspectColumnBindData &bind_data, InspectColumnState &state, DataChunk &output) {
+	OutputWriter writer(output, state.column_map);
+	while (state.offset < state.filtered_segments.size() && !writer.IsFull()) {
+		auto &entry = state.filtered_segments[state.offset];
+		auto &seg = *entry.segment;
+		auto &column = bind_data.columns[entry.target_idx];
+
+		writer.WriteBigint(ROW_GROUP_ID_IDX, seg.row_group_index);
+		writer.WriteString(COLUMN_NAME_IDX, column.name);
+		writer.WriteString(COLUMN_TYPE_IDX, column.type_name);
+		writer.WriteString(COMPRESSION_IDX, seg.compression_type);
+
+		// Total compressed size = main block portion + additional blocks of large segments
+		const idx_t total_compressed_size =
+		    entry.compressed_size + seg.additional_blocks.size() * state.block_alloc_size;
+		writer.WriteBigint(COMPRESSED_BYTES_IDX, total_compressed_size);
+
+		const auto estimated_size = CalculateEstimatedDecompressedSize(column.type, seg.segment_count);
 		if (estimated_size.IsValid()) {
-			output.SetValue(ESTIMATED_DECOMPRESSED_BYTES_IDX, count,
-			                Value::BIGINT(NumericCast<int64_t>(estimated_size.GetIndex())));
+			writer.WriteBigint(ESTIMATED_DECOMPRESSED_BYTES_IDX, estimated_size.GetIndex());
 		} else {
-			output.SetValue(ESTIMATED_DECOMPRESSED_BYTES_IDX, count, Value());
+			writer.WriteNull(ESTIMATED_DECOMPRESSED_BYTES_IDX);
 		}
 
-		output.SetValue(ROW_COUNT_IDX, count, Value::BIGINT(NumericCast<int64_t>(entry.row_count)));
+		writer.WriteBigint(ROW_COUNT_IDX, seg.segment_count);
+		writer.WriteBigint(SAMPLE_WEIGHT_IDX, entry.sample_weight);
+		writer.NextRow();
 
 		state.offset++;
-		count++;
 	}
 
-	output.SetCardinality(count);
+	writer.Finalize();
+}
+
+void InspectColumnExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<InspectColumnBindData>();
+	auto &state = data.global_state->Cast<InspectColumnState>();
+
+	// An empty chunk ends the scan, so keep going until a row passes the filters or all segments are consumed
+	while (state.offset < state.filtered_segments.size()) {
+		output.Reset();
+		EmitSegments(bind_data, state, output);
+		if (!state.filter_executor) {
+			return;
+		}
+
+		SelectionVector sel(STANDARD_VECTOR_SIZE);
+		const idx_t selected = state.filter_executor->SelectExpression(output, sel);
+		if (selected == output.size()) {
+			return;
+		}
+		if (selected > 0) {
+			output.Slice(sel, selected);
+			return;
+		}
+	}
+	output.SetCardinality(0);
 }
 
 } // namespace
@@ -267,13 +543,42 @@ void RegisterInspectColumnFunction(ExtensionLoader &loader) {
 	                                     {LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::VARCHAR},
 	                                      LogicalType {LogicalTypeId::VARCHAR}},
 	                                     InspectColumnExecute, InspectColumnBindWithDatabase, InspectColumnInit);
+	inspect_column_with_db.projection_pushdown = true;
+	inspect_column_with_db.filter_pushdown = true;
+	RowGroupSampling::AddNamedParameters(inspect_column_with_db);
 	loader.RegisterFunction(std::move(inspect_column_with_db));
 
 	// inspect_column(table_name, column_name) — uses current database
 	TableFunction inspect_column_current_db(
 	    "inspect_column", {LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::VARCHAR}},
 	    InspectColumnExecute, InspectColumnBindCurrentDB, InspectColumnInit);
+	inspect_column_current_db.projection_pushdown = true;
+	inspect_column_current_db.filter_pushdown = true;
+	RowGroupSampling::AddNamedParameters(inspect_column_current_db);
 	loader.RegisterFunction(std::move(inspect_column_current_db));
 }
 
+void RegisterInspectColumnsFunction(ExtensionLoader &loader) {
+	const auto columns_parameter = LogicalType::LIST(LogicalType {LogicalTypeId::VARCHAR});
+
+	// inspect_columns(database_name, table_name)
+	TableFunction inspect_columns_with_db("inspect_columns",
+	                                      {LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::VARCHAR}},
+	                                      InspectColumnExecute, InspectColumnsBindWithDatabase, InspectColumnInit);
+	inspect_columns_with_db.named_parameters["columns"] = columns_parameter;
+	inspect_columns_with_db.projection_pushdown = true;
+	inspect_columns_with_db.filter_pushdown = true;
+	RowGroupSampling::AddNamedParameters(inspect_columns_with_db);
+	loader.RegisterFunction(std::move(inspect_columns_with_db));
+
+	// inspect_columns(table_name) — uses current database
+	TableFunction inspect_columns_current_db("inspect_columns", {LogicalType {LogicalTypeId::VARCHAR}},
+	                                         InspectColumnExecute, InspectColumnsBindCurrentDB, InspectColumnInit);
+	inspect_columns_current_db.named_parameters["columns"] = columns_parameter;
+	inspect_columns_current_db.projection_pushdown = true;
+	inspect_columns_current_db.filter_pushdown = true;
+	RowGroupSampling::AddNamedParameters(inspect_columns_current_db);
+	loader.RegisterFunction(std::move(inspect_columns_current_db));
+}
+
 } // namespace duckdb
@@ -0,0 +1,194 @@
+#include "inspect_column_activity.hpp"
+#include "column_activity.hpp"
+#include "output_writer.hpp"
+#include "segment_snapshot.hpp"
+#include "util.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/attached_database.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/storage/block_manager.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/storage/table_storage_info.hpp"
+
+#include <algorithm>
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// inspect_column_activity() - Rows and bytes scanned per table column
+//===--------------------------------------------------------------------===//
+
+// Reports the scan counters collected while table_inspector_track_column_activity is enabled (see ColumnActivity),
+// next to the checkpointed size of every column, to rank columns for compression changes:
+// - scan_ratio = bytes_scanned / persisted_bytes, how often the column's stored size was scanned
+// A high ratio marks a hot column whose decompression cost matters, a low ratio with many persisted bytes a cold
+// column worth compressing harder. Persisted bytes are computed like in inspect_memory(), and are NULL for columns of
+// in-memory databases and of tables or columns that no longer exist. Rows come by bytes_scanned, largest first.
+
+struct ColumnActivityOutputRow {
+	ColumnActivityRow activity;
+	optional_idx persisted_bytes;
+};
+
+struct InspectColumnActivityState : public GlobalTableFunctionState {
+	InspectColumnActivityState() : offset(0) {
+	}
+
+	vector<ColumnActivityOutputRow> rows;
+	idx_t offset;
+};
+
+unique_ptr<FunctionData> InspectColumnActivityBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	names.reserve(8);
+	return_types.reserve(8);
+	names.emplace_back("database_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("schema_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("table_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("column_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("rows_scanned");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("bytes_scanned");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("persisted_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("scan_ratio");
+	return_types.emplace_back(LogicalType {LogicalTypeId::DOUBLE});
+
+	return nullptr;
+}
+
+// Checkpointed bytes of every column of a table, by column name. Empty if the table no longer exists or its
+// database is not a persistent DuckDB database.
+unordered_map<string, idx_t> GetPersistedColumnBytes(ClientContext &context, const ColumnActivityRow &row) {
+	unordered_map<string, idx_t> result;
+	auto catalog = Catalog::GetCatalogEntry(context, row.database_name);
+	if (!catalog || !catalog->IsDuckCatalog() || catalog->InMemory()) {
+		return result;
+	}
+	auto entry = catalog->GetEntry(context, CatalogType::TABLE_ENTRY, row.schema_name, row.table_name,
+	                               OnEntryNotFound::RETURN_NULL);
+	if (!entry || entry->type != CatalogType::TABLE_ENTRY) {
+		return result;
+	}
+	auto &table = entry->Cast<TableCatalogEntry>();
+
+	// Physical column id -> column name
+	vector<string> column_names;
+	for (auto &col : table.GetColumns().Physical()) {
+		const idx_t physical_id = col.Physical().index;
+		if (column_names.size() <= physical_id) {
+			column_names.resize(physical_id + 1);
+		}
+		column_names[physical_id] = col.Name();
+		result[col.Name()] = 0;
+	}
+
+	const idx_t block_alloc_size = catalog->GetAttached().GetStorageManager().GetBlockManager().GetBlockAllocSize();
+	const auto segment_info = SegmentSnapshot::Get(context, *catalog)->GetTableSegments(context, table);
+	const auto segment_sizes = CalculateSegmentSizes(*segment_info, block_alloc_size);
+	for (idx_t segment_idx = 0; segment_idx < segment_info->size(); ++segment_idx) {
+		const auto &seg = (*segment_info)[segment_idx];
+		if (!seg.persistent || seg.block_id == INVALID_BLOCK || seg.column_id >= column_names.size()) {
+			continue;
+		}
+		result[column_names[seg.column_id]] +=
+		    segment_sizes[segment_idx] + seg.additional_blocks.size() * block_alloc_size;
+	}
+	return result;
+}
+
+unique_ptr<GlobalTableFunctionState> InspectColumnActivityInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<InspectColumnActivityState>();
+
+	// Column sizes of every table, looked up once per table
+	unordered_map<string, unordered_map<string, idx_t>> table_sizes;
+	for (auto &activity : ColumnActivity::Get(context)->GetRows()) {
+		CheckInterrupted(context);
+		const auto table_key = activity.database_name + "." + activity.schema_name + "." + activity.table_name;
+		auto sizes = table_sizes.find(table_key);
+		if (sizes == table_sizes.end()) {
+			sizes = table_sizes.emplace(table_key, GetPersistedColumnBytes(context, activity)).first;
+		}
+
+		ColumnActivityOutputRow row;
+		auto column_size = sizes->second.find(activity.column_name);
+		if (column_size != sizes->second.end()) {
+			row.persisted_bytes = column_size->second;
+		}
+		row.activity = std::move(activity);
+		result->rows.push_back(std::move(row));
+	}
+
+	std::stable_sort(result->rows.begin(), result->rows.end(),
+	                 [](const ColumnActivityOutputRow &lhs, const ColumnActivityOutputRow &rhs) {
+		                 return lhs.activity.bytes_scanned > rhs.activity.bytes_scanned;
+	                 });
+	return std::move(result);
+}
+
+void InspectColumnActivityExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectColumnActivityState>();
+
+	constexpr idx_t DATABASE_NAME_IDX = 0;
+	constexpr idx_t SCHEMA_NAME_IDX = 1;
+	constexpr idx_t TABLE_NAME_IDX = 2;
+	constexpr idx_t COLUMN_NAME_IDX = 3;
+	constexpr idx_t ROWS_SCANNED_IDX = 4;
+	constexpr idx_t BYTES_SCANNED_IDX = 5;
+	constexpr idx_t PERSISTED_BYTES_IDX = 6;
+	constexpr idx_t SCAN_RATIO_IDX = 7;
+
+	OutputWriter writer(output);
+	while (state.offset < state.rows.size() && !writer.IsFull()) {
+		const auto &row = state.rows[state.offset];
+		const auto &activity = row.activity;
+
+		writer.WriteString(DATABASE_NAME_IDX, activity.database_name);
+		writer.WriteString(SCHEMA_NAME_IDX, activity.schema_name);
+		writer.WriteString(TABLE_NAME_IDX, activity.table_name);
+		writer.WriteString(COLUMN_NAME_IDX, activity.column_name);
+		writer.WriteBigint(ROWS_SCANNED_IDX, activity.rows_scanned);
+		writer.WriteBigint(BYTES_SCANNED_IDX, activity.bytes_scanned);
+		if (row.persisted_bytes.IsValid()) {
+			writer.WriteBigint(PERSISTED_BYTES_IDX, row.persisted_bytes.GetIndex());
+		} else {
+			writer.WriteNull(PERSISTED_BYTES_IDX);
+		}
+		if (row.persisted_bytes.IsValid() && row.persisted_bytes.GetIndex() > 0) {
+			writer.Write<double>(SCAN_RATIO_IDX, static_cast<double>(activity.bytes_scanned) /
+			                                         static_cast<double>(row.persisted_bytes.GetIndex()));
+		} else {
+			writer.WriteNull(SCAN_RATIO_IDX);
+		}
+		writer.NextRow();
+
+		state.offset++;
+	}
+
+	writer.Finalize();
+}
+
+} // namespace
+
+void RegisterInspectColumnActivityFunction(ExtensionLoader &loader) {
+	TableFunction inspect_column_activity_func("inspect_column_activity", {}, InspectColumnActivityExecute,
+	                                           InspectColumnActivityBind, InspectColumnActivityInit);
+	loader.RegisterFunction(std::move(inspect_column_activity_func));
+}
+
+} // namespace duckdb
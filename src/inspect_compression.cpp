@@ -0,0 +1,472 @@
+#include "inspect_compression.hpp"
+#include "output_writer.hpp"
+#include "segment_snapshot.hpp"
+#include "util.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/map.hpp"
+#include "duckdb/common/optional_idx.hpp"
+#include "duckdb/common/optional_ptr.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types.hpp"
+#include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/attached_database.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "duckdb/planner/binder.hpp"
+#include "duckdb/storage/block_manager.hpp"
+#include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/storage_index.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/storage/table/scan_state.hpp"
+#include "duckdb/storage/table_storage_info.hpp"
+#include "duckdb/transaction/duck_transaction.hpp"
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// inspect_compression(table_name) - Compression ratio per column and compression type
+//===--------------------------------------------------------------------===//
+
+// Groups the persistent segments of a table by column, segment kind (data or validity) and compression type, and
+// compares their compressed size with what the same values take in the uncompressed storage layout:
+// - fixed-size values: value_count * type size, validity: one bit per value, list offsets: 8 bytes per list
+// - strings: string bytes plus a 4-byte offset per value. Segment statistics only record the maximum string length,
+//   which gives an upper bound. With `sample_rows := N` the first N rows of every top-level string column are
+//   scanned, and the average length (capped by the statistics bound) is used instead.
+// Segments of nested columns (list elements, struct fields) are reported under their top-level column; value_count
+// then counts the stored elements, not the rows.
+// Constant segments are not part of the segment snapshot, as they have no block.
+
+// Where a group's estimated_decompressed_bytes comes from, ordered by increasing uncertainty
+enum class EstimateSource : uint8_t { EXACT, STATISTICS, SAMPLED };
+
+const char *EstimateSourceToString(EstimateSource source) {
+	switch (source) {
+	case EstimateSource::EXACT:
+		return "exact";
+	case EstimateSource::STATISTICS:
+		return "statistics";
+	case EstimateSource::SAMPLED:
+		return "sampled";
+	default:
+		throw InternalException("Unknown estimate source");
+	}
+}
+
+// The storage column a segment belongs to, resolved from its column path
+struct StorageColumn {
+	bool is_validity = false;
+	// Type of the values stored in the segment; invalid if the path could not be resolved
+	LogicalType type;
+};
+
+struct CompressionGroupKey {
+	idx_t physical_id;
+	bool is_validity;
+	string compression;
+
+	bool operator<(const CompressionGroupKey &other) const {
+		if (physical_id != other.physical_id) {
+			return physical_id < other.physical_id;
+		}
+		if (is_validity != other.is_validity) {
+			return !is_validity;
+		}
+		return compression < other.compression;
+	}
+};
+
+struct CompressionGroup {
+	idx_t segment_count = 0;
+	idx_t value_count = 0;
+	idx_t compressed_bytes = 0;
+	idx_t decompressed_bytes = 0;
+	// False as soon as one segment's uncompressed size is unknown
+	bool decompressed_known = true;
+	EstimateSource source = EstimateSource::EXACT;
+};
+
+struct CompressionRow {
+	CompressionGroupKey key;
+	CompressionGroup group;
+};
+
+struct InspectCompressionBindData : public TableFunctionData {
+	InspectCompressionBindData(TableCatalogEntry &table_entry_p, optional_idx sample_rows_p)
+	    : table_entry(table_entry_p), sample_rows(sample_rows_p) {
+	}
+
+	TableCatalogEntry &table_entry;
+	// Rows scanned to sample string lengths; invalid disables sampling
+	optional_idx sample_rows;
+};
+
+struct InspectCompressionState : public GlobalTableFunctionState {
+	InspectCompressionState() : offset(0) {
+	}
+
+	vector<CompressionRow> rows;
+	// Physical column id -> column name and type
+	vector<string> column_names;
+	vector<string> column_types;
+	idx_t offset;
+};
+
+// Parses a column path such as "[2, 1, 0]" into its components
+vector<idx_t> ParseColumnPath(const string &column_path) {
+	vector<idx_t> path;
+	idx_t value = 0;
+	bool in_number = false;
+	for (const char c : column_path) {
+		if (StringUtil::CharacterIsDigit(c)) {
+			value = value * 10 + static_cast<idx_t>(c - '0');
+			in_number = true;
+		} else if (in_number) {
+			path.push_back(value);
+			value = 0;
+			in_number = false;
+		}
+	}
+	if (in_number) {
+		path.push_back(value);
+	}
+	return path;
+}
+
+// Walks a segment's column path from the top-level column type. Child 0 of every column is its validity, the other
+// children are the list/array element (1) or the struct fields (1..n).
+StorageColumn ResolveStorageColumn(const LogicalType &column_type, const vector<idx_t> &path) {
+	StorageColumn result;
+	LogicalType type = column_type;
+	for (idx_t depth = 1; depth < path.size(); ++depth) {
+		const idx_t child = path[depth];
+		if (child == 0) {
+			result.is_validity = true;
+			return result;
+		}
+		switch (type.InternalType()) {
+		case PhysicalType::LIST:
+			type = ListType::GetChildType(type);
+			break;
+		case PhysicalType::ARRAY:
+			type = ArrayType::GetChildType(type);
+			break;
+		case PhysicalType::STRUCT:
+			if (child > StructType::GetChildCount(type)) {
+				return result;
+			}
+			type = StructType::GetChildType(type, child - 1);
+			break;
+		default:
+			return result;
+		}
+	}
+	result.type = std::move(type);
+	return result;
+}
+
+// Scans the first sample_rows rows of the given string columns, and returns their average length in bytes per row.
+// NULLs count as empty strings, as they take no string bytes in storage either.
+unordered_map<idx_t, double> SampleStringLengths(ClientContext &context, TableCatalogEntry &table,
+                                                 const vector<idx_t> &physical_ids, idx_t sample_rows) {
+	unordered_map<idx_t, double> result;
+	if (physical_ids.empty()) {
+		return result;
+	}
+
+	auto &storage = table.GetStorage();
+	auto &transaction = DuckTransaction::Get(context, table.ParentCatalog());
+	auto &columns = table.GetColumns();
+
+	vector<StorageIndex> column_ids;
+	vector<LogicalType> types;
+	for (const auto physical_id : physical_ids) {
+		column_ids.emplace_back(physical_id);
+		types.push_back(columns.GetColumn(PhysicalIndex(physical_id)).Type());
+	}
+
+	TableScanState scan_state;
+	storage.InitializeScan(context, transaction, scan_state, column_ids);
+	DataChunk chunk;
+	chunk.Initialize(context, types);
+
+	vector<idx_t> string_bytes(physical_ids.size(), 0);
+	idx_t scanned = 0;
+	while (scanned < sample_rows) {
+		chunk.Reset();
+		storage.Scan(transaction, chunk, scan_state);
+		if (chunk.size() == 0) {
+			break;
+		}
+		const idx_t count = MinValue(chunk.size(), sample_rows - scanned);
+		for (idx_t col_idx = 0; col_idx < physical_ids.size(); ++col_idx) {
+			UnifiedVectorFormat format;
+			chunk.data[col_idx].ToUnifiedFormat(chunk.size(), format);
+			const auto strings = UnifiedVectorFormat::GetData<string_t>(format);
+			for (idx_t row = 0; row < count; ++row) {
+				const idx_t idx = format.sel->get_index(row);
+				if (format.validity.RowIsValid(idx)) {
+					string_bytes[col_idx] += strings[idx].GetSize();
+				}
+			}
+		}
+		scanned += count;
+	}
+
+	// An empty table gives no sample, the statistics bound is used then
+	if (scanned == 0) {
+		return result;
+	}
+	for (idx_t col_idx = 0; col_idx < physical_ids.size(); ++col_idx) {
+		result[physical_ids[col_idx]] = static_cast<double>(string_bytes[col_idx]) / static_cast<double>(scanned);
+	}
+	return result;
+}
+
+// Adds a segment's uncompressed size to its group, or marks the group's estimate unknown
+void AddDecompressedSize(const ColumnSegmentInfo &seg, const StorageColumn &column,
+                         optional_ptr<const double> sampled_length, CompressionGroup &group) {
+	const idx_t count = seg.segment_count;
+	if (column.is_validity) {
+		group.decompressed_bytes += (count + 7) / 8;
+		return;
+	}
+
+	const auto physical_type = column.type.InternalType();
+	switch (physical_type) {
+	case PhysicalType::LIST:
+		// Lists store one offset per row, the elements live in the child column
+		group.decompressed_bytes += count * sizeof(uint64_t);
+		return;
+	case PhysicalType::VARCHAR: {
+		const auto max_length = ParseMaxStringLength(seg.segment_stats);
+		optional_idx string_bytes;
+		if (max_length.IsValid()) {
+			string_bytes = count * max_length.GetIndex();
+			group.source = MaxValue(group.source, EstimateSource::STATISTICS);
+		}
+		if (sampled_length) {
+			const auto sampled_bytes = static_cast<idx_t>(static_cast<double>(count) * *sampled_length + 0.5);
+			if (!string_bytes.IsValid() || sampled_bytes < string_bytes.GetIndex()) {
+				string_bytes = sampled_bytes;
+			}
+			group.source = MaxValue(group.source, EstimateSource::SAMPLED);
+		}
+		if (!string_bytes.IsValid()) {
+			group.decompressed_known = false;
+			return;
+		}
+		group.decompressed_bytes += string_bytes.GetIndex() + count * sizeof(uint32_t);
+		return;
+	}
+	default:
+		if (column.type.id() == LogicalTypeId::INVALID || !TypeIsConstantSize(physical_type)) {
+			group.decompressed_known = false;
+			return;
+		}
+		group.decompressed_bytes += count * GetTypeIdSize(physical_type);
+		return;
+	}
+}
+
+// Shared bind logic for all inspect_compression overloads
+unique_ptr<FunctionData> InspectCompressionBindInternal(ClientContext &context, TableFunctionBindInput &input,
+                                                        const string &database_name, const string &table_name_str,
+                                                        vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	// Define output columns
+	names.reserve(10);
+	return_types.reserve(10);
+	names.emplace_back("column_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("column_type");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("segment_kind");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("compression");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("segment_count");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("value_count");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("compressed_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("estimated_decompressed_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("compression_ratio");
+	return_types.emplace_back(LogicalType {LogicalTypeId::DOUBLE});
+	names.emplace_back("estimate");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	optional_idx sample_rows;
+	auto entry = input.named_parameters.find("sample_rows");
+	if (entry != input.named_parameters.end() && !entry->second.IsNull()) {
+		const auto value = entry->second.GetValue<int64_t>();
+		if (value <= 0) {
+			throw InvalidInputException("inspect_compression() sample_rows must be positive");
+		}
+		sample_rows = NumericCast<idx_t>(value);
+	}
+
+	// Parse table name (handles schema.table format)
+	auto qname = QualifiedName::Parse(table_name_str);
+	Binder::BindSchemaOrCatalog(context, qname.catalog, qname.schema);
+
+	auto &catalog_entry = Catalog::GetEntry(context, CatalogType::TABLE_ENTRY, database_name, qname.schema, qname.name);
+	return make_uniq<InspectCompressionBindData>(catalog_entry.Cast<TableCatalogEntry>(), sample_rows);
+}
+
+// inspect_compression(database_name, table_name)
+unique_ptr<FunctionData> InspectCompressionBindWithDatabase(ClientContext &context, TableFunctionBindInput &input,
+                                                            vector<LogicalType> &return_types, vector<string> &names) {
+	const auto database_name = input.inputs[0].GetValue<string>();
+	const auto table_name_str = input.inputs[1].GetValue<string>();
+	return InspectCompressionBindInternal(context, input, database_name, table_name_str, return_types, names);
+}
+
+// inspect_compression(table_name) — uses current database
+unique_ptr<FunctionData> InspectCompressionBindCurrentDB(ClientContext &context, TableFunctionBindInput &input,
+                                                         vector<LogicalType> &return_types, vector<string> &names) {
+	const auto table_name_str = input.inputs[0].GetValue<string>();
+	return InspectCompressionBindInternal(context, input, INVALID_CATALOG, table_name_str, return_types, names);
+}
+
+unique_ptr<GlobalTableFunctionState> InspectCompressionInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<InspectCompressionState>();
+
+	auto &bind_data = input.bind_data->Cast<InspectCompressionBindData>();
+	auto &table = bind_data.table_entry;
+	auto &columns = table.GetColumns();
+
+	vector<LogicalType> column_types;
+	vector<idx_t> string_columns;
+	for (auto &col : columns.Physical()) {
+		result->column_names.push_back(col.Name());
+		result->column_types.push_back(col.Type().ToString());
+		column_types.push_back(col.Type());
+		if (col.Type().InternalType() == PhysicalType::VARCHAR) {
+			string_columns.push_back(col.Physical().index);
+		}
+	}
+
+	auto snapshot = SegmentSnapshot::Get(context, table.ParentCatalog());
+	auto segments = snapshot->GetTableSegments(context, table);
+	if (segments->empty()) {
+		return std::move(result);
+	}
+
+	unordered_map<idx_t, double> sampled_lengths;
+	if (bind_data.sample_rows.IsValid()) {
+		sampled_lengths = SampleStringLengths(context, table, string_columns, bind_data.sample_rows.GetIndex());
+	}
+
+	auto &storage_manager = table.ParentCatalog().GetAttached().GetStorageManager();
+	const idx_t block_alloc_size = storage_manager.GetBlockManager().GetBlockAllocSize();
+	const auto segment_sizes = CalculateSegmentSizes(*segments, block_alloc_size);
+
+	map<CompressionGroupKey, CompressionGroup> groups;
+	for (idx_t segment_idx = 0; segment_idx < segments->size(); ++segment_idx) {
+		const auto &seg = (*segments)[segment_idx];
+		if (!seg.persistent || seg.column_id >= column_types.size()) {
+			continue;
+		}
+		const auto path = ParseColumnPath(seg.column_path);
+		const auto column = ResolveStorageColumn(column_types[seg.column_id], path);
+
+		auto &group = groups[CompressionGroupKey {seg.column_id, column.is_validity, seg.compression_type}];
+		group.segment_count++;
+		group.value_count += seg.segment_count;
+		group.compressed_bytes += segment_sizes[segment_idx] + seg.additional_blocks.size() * block_alloc_size;
+
+		// Only top-level string columns are sampled, nested strings keep the statistics bound
+		optional_ptr<const double> sampled_length;
+		auto sampled = sampled_lengths.find(seg.column_id);
+		if (!column.is_validity && path.size() == 1 && sampled != sampled_lengths.end()) {
+			sampled_length = &sampled->second;
+		}
+		AddDecompressedSize(seg, column, sampled_length, group);
+	}
+
+	result->rows.reserve(groups.size());
+	for (auto &entry : groups) {
+		result->rows.push_back(CompressionRow {entry.first, entry.second});
+	}
+	return std::move(result);
+}
+
+void InspectCompressionExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectCompressionState>();
+
+	constexpr idx_t COLUMN_NAME_IDX = 0;
+	constexpr idx_t COLUMN_TYPE_IDX = 1;
+	constexpr idx_t SEGMENT_KIND_IDX = 2;
+	constexpr idx_t COMPRESSION_IDX = 3;
+	constexpr idx_t SEGMENT_COUNT_IDX = 4;
+	constexpr idx_t VALUE_COUNT_IDX = 5;
+	constexpr idx_t COMPRESSED_BYTES_IDX = 6;
+	constexpr idx_t ESTIMATED_DECOMPRESSED_BYTES_IDX = 7;
+	constexpr idx_t COMPRESSION_RATIO_IDX = 8;
+	constexpr idx_t ESTIMATE_IDX = 9;
+
+	OutputWriter writer(output);
+	while (state.offset < state.rows.size() && !writer.IsFull()) {
+		const auto &row = state.rows[state.offset];
+		const auto &group = row.group;
+
+		writer.WriteString(COLUMN_NAME_IDX, state.column_names[row.key.physical_id]);
+		writer.WriteString(COLUMN_TYPE_IDX, state.column_types[row.key.physical_id]);
+		writer.WriteString(SEGMENT_KIND_IDX, row.key.is_validity ? "validity" : "data");
+		writer.WriteString(COMPRESSION_IDX, row.key.compression);
+		writer.WriteBigint(SEGMENT_COUNT_IDX, group.segment_count);
+		writer.WriteBigint(VALUE_COUNT_IDX, group.value_count);
+		writer.WriteBigint(COMPRESSED_BYTES_IDX, group.compressed_bytes);
+		if (group.decompressed_known) {
+			writer.WriteBigint(ESTIMATED_DECOMPRESSED_BYTES_IDX, group.decompressed_bytes);
+			writer.WriteString(ESTIMATE_IDX, EstimateSourceToString(group.source));
+		} else {
+			writer.WriteNull(ESTIMATED_DECOMPRESSED_BYTES_IDX);
+			writer.WriteNull(ESTIMATE_IDX);
+		}
+		if (group.decompressed_known && group.compressed_bytes > 0) {
+			writer.Write<double>(COMPRESSION_RATIO_IDX, static_cast<double>(group.decompressed_bytes) /
+			                                                static_cast<double>(group.compressed_bytes));
+		} else {
+			writer.WriteNull(COMPRESSION_RATIO_IDX);
+		}
+		writer.NextRow();
+
+		state.offset++;
+	}
+
+	writer.Finalize();
+}
+
+} // namespace
+
+void RegisterInspectCompressionFunction(ExtensionLoader &loader) {
+	// inspect_compression(database_name, table_name)
+	TableFunction inspect_compression_with_db(
+	    "inspect_compression", {LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::VARCHAR}},
+	    InspectCompressionExecute, InspectCompressionBindWithDatabase, InspectCompressionInit);
+	inspect_compression_with_db.named_parameters["sample_rows"] = LogicalType {LogicalTypeId::BIGINT};
+	loader.RegisterFunction(std::move(inspect_compression_with_db));
+
+	// inspect_compression(table_name) — uses current database
+	TableFunction inspect_compression_current_db("inspect_compression", {LogicalType {LogicalTypeId::VARCHAR}},
+	                                             InspectCompressionExecute, InspectCompressionBindCurrentDB,
+	                                             InspectCompressionInit);
+	inspect_compression_current_db.named_parameters["sample_rows"] = LogicalType {LogicalTypeId::BIGINT};
+	loader.RegisterFunction(std::move(inspect_compression_current_db));
+}
+
+} // namespace duckdb
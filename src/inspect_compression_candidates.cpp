@@ -0,0 +1,444 @@
+#include "inspect_compression_candidates.hpp"
+#include "output_writer.hpp"
+#include "sampling.hpp"
+#include "segment_snapshot.hpp"
+#include "util.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/enums/compression_type.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/map.hpp"
+#include "duckdb/common/numeric_utils.hpp"
+#include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/function/compression_function.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/attached_database.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "duckdb/planner/binder.hpp"
+#include "duckdb/storage/block_manager.hpp"
+#include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/storage_index.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/storage/table/column_data.hpp"
+#include "duckdb/storage/table/scan_state.hpp"
+#include "duckdb/storage/table_storage_info.hpp"
+#include "duckdb/transaction/duck_transaction.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// inspect_compression_candidates(table_name, column_name) - Projected size per compression method
+//===--------------------------------------------------------------------===//
+
+// Runs the analyze step of every compression method DuckDB has for the column's physical type over a sample of the
+// table, the same step a checkpoint runs to pick a method, and extrapolates the bytes each method would store.
+// Sample units are runs of row_group_size consecutive row ids, which are the row groups of tables appended in bulk,
+// and are picked with the `sample` / `max_row_groups` parameters (at most DEFAULT_CANDIDATE_ROW_GROUPS without them).
+// Sampled units are scanned in parallel, one unit per thread at a time; every method analyzes the rows of a unit on
+// its own, as a checkpoint analyzes a row group. Deleted rows are not scanned, so projections describe the table as
+// a rewrite would store it. A method that refuses any sampled unit (e.g. RLE past its run limits) is not applicable.
+// Only the column's data is analyzed, its validity mask is left out of both projected and current bytes.
+
+// Row groups analyzed when neither `sample` nor `max_row_groups` is given
+constexpr idx_t DEFAULT_CANDIDATE_ROW_GROUPS = 8;
+
+struct InspectCompressionCandidatesBindData : public TableFunctionData {
+	InspectCompressionCandidatesBindData(TableCatalogEntry &table_entry_p, string column_name_p, LogicalType type_p,
+	                                     idx_t physical_id_p, RowGroupSampling sampling_p)
+	    : table_entry(table_entry_p), column_name(std::move(column_name_p)), type(std::move(type_p)),
+	      physical_id(physical_id_p), sampling(sampling_p) {
+	}
+
+	TableCatalogEntry &table_entry;
+	string column_name;
+	LogicalType type;
+	idx_t physical_id;
+	RowGroupSampling sampling;
+};
+
+struct CandidateRow {
+	string compression;
+	bool is_current = false;
+	bool applicable = false;
+	SampleEstimate projected;
+};
+
+struct InspectCompressionCandidatesState : public GlobalTableFunctionState {
+	InspectCompressionCandidatesState() : next_unit(0), finished_units(0), emit_claimed(false), offset(0) {
+	}
+
+	idx_t MaxThreads() const override {
+		return MaxValue<idx_t>(sample.size(), 1);
+	}
+
+	idx_t row_group_size = 0;
+	idx_t total_rows = 0;
+	idx_t unit_count = 0;
+	vector<SampledRowGroup> sample;
+
+	// Column the analyze functions are initialized with; it holds no data
+	shared_ptr<ColumnData> column_data;
+	vector<const CompressionFunction *> candidates;
+	// Bytes per (candidate, sampled unit), INVALID_INDEX where the candidate doesn't apply. Written by the thread that
+	// analyzes the unit.
+	vector<vector<idx_t>> unit_bytes;
+
+	// Checkpointed data segments of the column
+	idx_t current_bytes = 0;
+	string current_compression;
+
+	atomic<idx_t> next_unit;
+	atomic<idx_t> finished_units;
+	// Without sampled units, the first thread emits the result
+	atomic<bool> emit_claimed;
+
+	// Built and emitted by the thread that finished last
+	vector<CandidateRow> rows;
+	idx_t offset;
+};
+
+struct InspectCompressionCandidatesLocalState : public LocalTableFunctionState {
+	bool emitting = false;
+};
+
+void DefineCandidatesColumns(vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	names.reserve(10);
+	return_types.reserve(10);
+	names.emplace_back("compression");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("is_current");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BOOLEAN});
+	names.emplace_back("applicable");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BOOLEAN});
+	names.emplace_back("projected_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("projected_bytes_low");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("projected_bytes_high");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("current_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("saved_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("sampled_row_groups");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("total_row_groups");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+}
+
+unique_ptr<FunctionData> InspectCompressionCandidatesBindInternal(ClientContext &context, const string &database_name,
+                                                                  const Value &table_name, const Value &column_name,
+                                                                  TableFunctionBindInput &input,
+                                                                  vector<LogicalType> &return_types,
+                                                                  vector<string> &names) {
+	DefineCandidatesColumns(return_types, names);
+	if (table_name.IsNull() || column_name.IsNull()) {
+		throw InvalidInputException("inspect_compression_candidates() table and column name must not be NULL");
+	}
+
+	auto sampling = RowGroupSampling::FromNamedParameters(input.named_parameters, "inspect_compression_candidates");
+	if (!sampling.IsEnabled()) {
+		sampling.enabled = true;
+		sampling.max_row_groups = DEFAULT_CANDIDATE_ROW_GROUPS;
+	}
+
+	// Parse table name (handles schema.table format)
+	auto qname = QualifiedName::Parse(table_name.GetValue<string>());
+	Binder::BindSchemaOrCatalog(context, qname.catalog, qname.schema);
+	auto &catalog_entry = Catalog::GetEntry(context, CatalogType::TABLE_ENTRY, database_name, qname.schema, qname.name);
+	auto &table_entry = catalog_entry.Cast<TableCatalogEntry>();
+
+	const auto column_name_str = column_name.GetValue<string>();
+	auto &columns = table_entry.GetColumns();
+	if (!columns.ColumnExists(column_name_str)) {
+		throw InvalidInputException("Column '%s' not found in table '%s'", column_name_str, table_entry.name);
+	}
+	const auto &col = columns.GetColumn(column_name_str);
+	if (col.Generated()) {
+		throw InvalidInputException("Column '%s' in table '%s' is a generated column and has no storage",
+		                            column_name_str, table_entry.name);
+	}
+	// Nested columns are stored (and compressed) as their child columns
+	const auto physical_type = col.Type().InternalType();
+	if (physical_type != PhysicalType::VARCHAR && !TypeIsConstantSize(physical_type)) {
+		throw InvalidInputException("inspect_compression_candidates() does not support column '%s' of type %s",
+		                            column_name_str, col.Type().ToString());
+	}
+	return make_uniq<InspectCompressionCandidatesBindData>(table_entry, col.Name(), col.Type(), col.Physical().index,
+	                                                       sampling);
+}
+
+// inspect_compression_candidates(database_name, table_name, column_name)
+unique_ptr<FunctionData> InspectCompressionCandidatesBindWithDatabase(ClientContext &context,
+                                                                      TableFunctionBindInput &input,
+                                                                      vector<LogicalType> &return_types,
+                                                                      vector<string> &names) {
+	if (input.inputs[0].IsNull()) {
+		throw InvalidInputException("inspect_compression_candidates() database name must not be NULL");
+	}
+	return InspectCompressionCandidatesBindInternal(context, input.inputs[0].GetValue<string>(), input.inputs[1],
+	                                                input.inputs[2], input, return_types, names);
+}
+
+// inspect_compression_candidates(table_name, column_name) — uses current database
+unique_ptr<FunctionData> InspectCompressionCandidatesBindCurrentDB(ClientContext &context,
+                                                                   TableFunctionBindInput &input,
+                                                                   vector<LogicalType> &return_types,
+                                                                   vector<string> &names) {
+	return InspectCompressionCandidatesBindInternal(context, INVALID_CATALOG, input.inputs[0], input.inputs[1], input,
+	                                                return_types, names);
+}
+
+unique_ptr<GlobalTableFunctionState> InspectCompressionCandidatesInit(ClientContext &context,
+                                                                      TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<InspectCompressionCandidatesBindData>();
+	auto &table = bind_data.table_entry;
+	auto &storage = table.GetStorage();
+	auto result = make_uniq<InspectCompressionCandidatesState>();
+
+	result->row_group_size = storage.GetRowGroupSize();
+	result->total_rows = storage.GetTotalRows();
+	result->unit_count = (result->total_rows + result->row_group_size - 1) / result->row_group_size;
+	result->sample = bind_data.sampling.SelectRowGroups(result->unit_count, Hash(table.oid));
+
+	auto &storage_manager = table.ParentCatalog().GetAttached().GetStorageManager();
+	auto &block_manager = storage_manager.GetBlockManager();
+	result->column_data =
+	    ColumnData::CreateColumn(block_manager, *storage.GetDataTableInfo(), bind_data.physical_id, 0, bind_data.type);
+
+	const auto physical_type = bind_data.type.InternalType();
+	for (auto &function : DBConfig::GetConfig(context).GetCompressionFunctions(physical_type)) {
+		const auto &candidate = function.get();
+		if (!candidate.init_analyze || !candidate.analyze || !candidate.final_analyze) {
+			continue;
+		}
+		result->candidates.push_back(&candidate);
+	}
+	result->unit_bytes.assign(result->candidates.size(), vector<idx_t>(result->sample.size(), 0));
+
+	// Current size and method of the column's data segments: their path has no child index, e.g. "[2]"
+	const idx_t block_alloc_size = block_manager.GetBlockAllocSize();
+	auto snapshot = SegmentSnapshot::Get(context, table.ParentCatalog());
+	const auto segments = snapshot->GetTableSegments(context, table);
+	const auto segment_sizes = CalculateSegmentSizes(*segments, block_alloc_size);
+	map<string, idx_t> compression_bytes;
+	for (idx_t segment_idx = 0; segment_idx < segments->size(); ++segment_idx) {
+		const auto &seg = (*segments)[segment_idx];
+		if (seg.column_id != bind_data.physical_id || seg.column_path.find(',') != string::npos) {
+			continue;
+		}
+		const idx_t size = segment_sizes[segment_idx] + seg.additional_blocks.size() * block_alloc_size;
+		result->current_bytes += size;
+		compression_bytes[seg.compression_type] += size;
+	}
+	idx_t most_bytes = 0;
+	for (const auto &entry : compression_bytes) {
+		if (entry.second > most_bytes) {
+			most_bytes = entry.second;
+			result->current_compression = entry.first;
+		}
+	}
+	return std::move(result);
+}
+
+unique_ptr<LocalTableFunctionState> InspectCompressionCandidatesInitLocal(ExecutionContext &context,
+                                                                          TableFunctionInitInput &input,
+                                                                          GlobalTableFunctionState *global_state) {
+	return make_uniq<InspectCompressionCandidatesLocalState>();
+}
+
+// Scans one sampled unit and runs every candidate's analysis over its rows
+void AnalyzeUnit(ClientContext &context, const InspectCompressionCandidatesBindData &bind_data,
+                 InspectCompressionCandidatesState &state, idx_t sample_idx) {
+	auto &storage = bind_data.table_entry.GetStorage();
+	auto &transaction = DuckTransaction::Get(context, bind_data.table_entry.ParentCatalog());
+	const idx_t start_row = state.sample[sample_idx].row_group_index * state.row_group_size;
+	const idx_t end_row = MinValue(start_row + state.row_group_size, state.total_rows);
+
+	vector<StorageIndex> column_ids;
+	column_ids.emplace_back(bind_data.physical_id);
+	TableScanState scan_state;
+	storage.InitializeScanWithOffset(transaction, scan_state, column_ids, start_row, end_row);
+	DataChunk chunk;
+	chunk.Initialize(context, {bind_data.type});
+
+	const auto physical_type = bind_data.type.InternalType();
+	vector<unique_ptr<AnalyzeState>> analyze_states;
+	for (const auto candidate : state.candidates) {
+		analyze_states.push_back(candidate->init_analyze(*state.column_data, physical_type));
+	}
+
+	idx_t scanned = 0;
+	while (true) {
+		CheckInterrupted(context);
+		chunk.Reset();
+		if (!scan_state.table_state.Scan(transaction, chunk) || chunk.size() == 0) {
+			break;
+		}
+		chunk.Flatten();
+		scanned += chunk.size();
+		for (idx_t candidate_idx = 0; candidate_idx < state.candidates.size(); ++candidate_idx) {
+			auto &analyze_state = analyze_states[candidate_idx];
+			if (!analyze_state) {
+				continue;
+			}
+			// A rejected candidate stays rejected for the rest of the unit
+			if (!state.candidates[candidate_idx]->analyze(*analyze_state, chunk.data[0], chunk.size())) {
+				analyze_state.reset();
+			}
+		}
+	}
+	// Every row of the unit is deleted: nothing to store
+	if (scanned == 0) {
+		return;
+	}
+	for (idx_t candidate_idx = 0; candidate_idx < state.candidates.size(); ++candidate_idx) {
+		auto &analyze_state = analyze_states[candidate_idx];
+		state.unit_bytes[candidate_idx][sample_idx] =
+		    analyze_state ? state.candidates[candidate_idx]->final_analyze(*analyze_state) : DConstants::INVALID_INDEX;
+	}
+}
+
+// Extrapolates the bytes of every candidate. Rows come by projected_bytes, smallest first, with candidates that
+// don't apply last.
+vector<CandidateRow> BuildRows(const InspectCompressionCandidatesState &state) {
+	vector<CandidateRow> result;
+	for (idx_t candidate_idx = 0; candidate_idx < state.candidates.size(); ++candidate_idx) {
+		CandidateRow row;
+		row.compression = CompressionTypeToString(state.candidates[candidate_idx]->type);
+		row.is_current = row.compression == state.current_compression;
+
+		const auto &unit_bytes = state.unit_bytes[candidate_idx];
+		row.applicable = std::none_of(unit_bytes.begin(), unit_bytes.end(),
+		                              [](idx_t bytes) { return bytes == DConstants::INVALID_INDEX; });
+		if (row.applicable) {
+			vector<double> values;
+			values.reserve(unit_bytes.size());
+			for (const auto bytes : unit_bytes) {
+				values.push_back(static_cast<double>(bytes));
+			}
+			row.projected = ExtrapolateTotal(state.sample, values, state.unit_count);
+		}
+		result.push_back(std::move(row));
+	}
+	std::stable_sort(result.begin(), result.end(), [](const CandidateRow &lhs, const CandidateRow &rhs) {
+		if (lhs.applicable != rhs.applicable) {
+			return lhs.applicable;
+		}
+		return lhs.projected.estimate < rhs.projected.estimate;
+	});
+	return result;
+}
+
+int64_t RoundBytes(double bytes) {
+	return static_cast<int64_t>(std::llround(bytes));
+}
+
+void InspectCompressionCandidatesExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<InspectCompressionCandidatesBindData>();
+	auto &state = data.global_state->Cast<InspectCompressionCandidatesState>();
+	auto &local_state = data.local_state->Cast<InspectCompressionCandidatesLocalState>();
+
+	constexpr idx_t COMPRESSION_IDX = 0;
+	constexpr idx_t IS_CURRENT_IDX = 1;
+	constexpr idx_t APPLICABLE_IDX = 2;
+	constexpr idx_t PROJECTED_BYTES_IDX = 3;
+	constexpr idx_t PROJECTED_BYTES_LOW_IDX = 4;
+	constexpr idx_t PROJECTED_BYTES_HIGH_IDX = 5;
+	constexpr idx_t CURRENT_BYTES_IDX = 6;
+	constexpr idx_t SAVED_BYTES_IDX = 7;
+	constexpr idx_t SAMPLED_ROW_GROUPS_IDX = 8;
+	constexpr idx_t TOTAL_ROW_GROUPS_IDX = 9;
+
+	// Threads keep analyzing units until none are left; the one finishing the last unit emits the rows
+	while (!local_state.emitting) {
+		const idx_t sample_idx = state.next_unit++;
+		if (sample_idx >= state.sample.size()) {
+			if (state.sample.empty() && !state.emit_claimed.exchange(true)) {
+				local_state.emitting = true;
+				state.rows = BuildRows(state);
+				break;
+			}
+			output.SetCardinality(0);
+			return;
+		}
+		AnalyzeUnit(context, bind_data, state, sample_idx);
+		// Every other thread has published its bytes once the last unit is counted
+		if (++state.finished_units == state.sample.size()) {
+			local_state.emitting = true;
+			state.rows = BuildRows(state);
+		}
+	}
+
+	OutputWriter writer(output);
+	while (state.offset < state.rows.size() && !writer.IsFull()) {
+		const auto &row = state.rows[state.offset];
+
+		writer.WriteString(COMPRESSION_IDX, row.compression);
+		writer.Write<bool>(IS_CURRENT_IDX, row.is_current);
+		writer.Write<bool>(APPLICABLE_IDX, row.applicable);
+		if (row.applicable) {
+			const auto projected_bytes = RoundBytes(row.projected.estimate);
+			writer.Write<int64_t>(PROJECTED_BYTES_IDX, projected_bytes);
+			if (row.projected.has_variance) {
+				writer.Write<int64_t>(PROJECTED_BYTES_LOW_IDX, RoundBytes(row.projected.Low()));
+				writer.Write<int64_t>(PROJECTED_BYTES_HIGH_IDX, RoundBytes(row.projected.High()));
+			} else {
+				writer.WriteNull(PROJECTED_BYTES_LOW_IDX);
+				writer.WriteNull(PROJECTED_BYTES_HIGH_IDX);
+			}
+			writer.Write<int64_t>(SAVED_BYTES_IDX, NumericCast<int64_t>(state.current_bytes) - projected_bytes);
+		} else {
+			writer.WriteNull(PROJECTED_BYTES_IDX);
+			writer.WriteNull(PROJECTED_BYTES_LOW_IDX);
+			writer.WriteNull(PROJECTED_BYTES_HIGH_IDX);
+			writer.WriteNull(SAVED_BYTES_IDX);
+		}
+		writer.WriteBigint(CURRENT_BYTES_IDX, state.current_bytes);
+		writer.WriteBigint(SAMPLED_ROW_GROUPS_IDX, state.sample.size());
+		writer.WriteBigint(TOTAL_ROW_GROUPS_IDX, state.unit_count);
+		writer.NextRow();
+
+		state.offset++;
+	}
+
+	writer.Finalize();
+}
+
+} // namespace
+
+void RegisterInspectCompressionCandidatesFunction(ExtensionLoader &loader) {
+	// inspect_compression_candidates(database_name, table_name, column_name)
+	TableFunction inspect_compression_candidates_with_db(
+	    "inspect_compression_candidates",
+	    {LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::VARCHAR},
+	     LogicalType {LogicalTypeId::VARCHAR}},
+	    InspectCompressionCandidatesExecute, InspectCompressionCandidatesBindWithDatabase,
+	    InspectCompressionCandidatesInit, InspectCompressionCandidatesInitLocal);
+	RowGroupSampling::AddNamedParameters(inspect_compression_candidates_with_db);
+	loader.RegisterFunction(std::move(inspect_compression_candidates_with_db));
+
+	// inspect_compression_candidates(table_name, column_name) — uses current database
+	TableFunction inspect_compression_candidates_current_db(
+	    "inspect_compression_candidates", {LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::VARCHAR}},
+	    InspectCompressionCandidatesExecute, InspectCompressionCandidatesBindCurrentDB,
+	    InspectCompressionCandidatesInit, InspectCompressionCandidatesInitLocal);
+	RowGroupSampling::AddNamedParameters(inspect_compression_candidates_current_db);
+	loader.RegisterFunction(std::move(inspect_compression_candidates_current_db));
+}
+
+} // namespace duckdb
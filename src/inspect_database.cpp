@@ -1,4 +1,11 @@
 #include "inspect_database.hpp"
+#include "index_storage.hpp"
+#include "inspection_deadline.hpp"
+#include "inspection_profile.hpp"
+#include "output_writer.hpp"
+#include "result_cache.hpp"
+#include "sampling.hpp"
+#include "segment_snapshot.hpp"
 #include "util.hpp"
 
 #include "duckdb/catalog/catalog.hpp"
@@ -6,18 +13,21 @@
 #include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
 #include "duckdb/catalog/default/default_schemas.hpp"
 #include "duckdb/common/assert.hpp"
+#include "duckdb/common/atomic.hpp"
 #include "duckdb/common/exception.hpp"
-#include "duckdb/execution/index/art/art.hpp"
-#include "duckdb/execution/index/unbound_index.hpp"
+#include "duckdb/common/mutex.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/main/attached_database.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
 #include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/database_size.hpp"
+#include "duckdb/storage/index_storage_info.hpp"
 #include "duckdb/storage/storage_info.hpp"
 #include "duckdb/storage/storage_manager.hpp"
-#include "duckdb/storage/table/data_table_info.hpp"
 #include "duckdb/storage/table_storage_info.hpp"
 
+#include <cmath>
+
 namespace duckdb {
 
 namespace {
@@ -28,17 +38,18 @@ namespace {
 
 // Calculates table data size by counting unique blocks used by the table.
 // Only counts persistent segments (data checkpointed to disk).
-// - Collects all unique block IDs used by table segments.
+// - Collects all unique block IDs used by table segments into the (reusable) block bitmap.
 // - Each block contributes the database's configured block allocation size.
 
-idx_t CalculateTableDataSize(const vector<ColumnSegmentInfo> &segment_info, TableCatalogEntry &table) {
+idx_t CalculateTableDataSize(const vector<ColumnSegmentInfo> &segment_info, TableCatalogEntry &table,
+                             BlockBitmap &blocks) {
 	if (segment_info.empty()) {
 		return 0;
 	}
 
 	auto &storage_manager = table.ParentCatalog().GetAttached().GetStorageManager();
 	const idx_t block_alloc_size = storage_manager.GetBlockManager().GetBlockAllocSize();
-	return CountUniqueBlocks(segment_info) * block_alloc_size;
+	return CountUniqueBlocks(segment_info, blocks) * block_alloc_size;
 }
 
 //===--------------------------------------------------------------------===//
@@ -47,39 +58,17 @@ idx_t CalculateTableDataSize(const vector<ColumnSegmentInfo> &segment_info, Tabl
 
 // Calculates the total on-disk size of all indexes belonging to a table.
 // Sums allocation_size across all FixedSizeAllocator buffers for each index.
-// Two index states need to be handled:
-// - BoundIndex: live, in-memory index objects.
-// - UnboundIndex: deserialized metadata from disk, not yet loaded into memory.
-
-idx_t CalculateTableIndexSize(TableCatalogEntry &table) {
-	auto &storage = table.GetStorage();
-	auto &table_info = *storage.GetDataTableInfo();
-	auto &indexes = table_info.GetIndexes();
 
+idx_t CalculateTableIndexSize(TableCatalogEntry &table, optional_ptr<InspectionProfile> profile) {
 	idx_t total_bytes = 0;
-
-	for (auto &index : indexes.Indexes()) {
-		if (index.IsBound() && index.GetIndexType() == ART::TYPE_NAME) {
-			// BoundIndex: read allocation_size from live allocator buffers.
-			// The allocation_size is set during serialization.
-			auto &art = index.Cast<ART>();
-			for (idx_t alloc_idx = 0; alloc_idx < ART::ALLOCATOR_COUNT; ++alloc_idx) {
-				const auto info = (*art.allocators)[alloc_idx]->GetInfo();
-				for (const auto &alloc_size : info.allocation_sizes) {
-					total_bytes += alloc_size;
-				}
-			}
-		} else if (!index.IsBound()) {
-			// UnboundIndex: read allocation_size from deserialized metadata on disk.
-			auto &unbound = index.Cast<UnboundIndex>();
-			for (const auto &alloc_info : unbound.GetStorageInfo().allocator_infos) {
-				for (const auto &alloc_size : alloc_info.allocation_sizes) {
-					total_bytes += alloc_size;
-				}
-			}
+	ForEachIndexAllocator(table, [&](const IndexAllocator &allocator) {
+		if (profile) {
+			profile->Add(InspectionCounter::INDEX_ALLOCATORS, 1);
 		}
-	}
-
+		for (const auto &alloc_size : allocator.info.allocation_sizes) {
+			total_bytes += alloc_size;
+		}
+	});
 	return total_bytes;
 }
 
@@ -88,37 +77,178 @@ idx_t CalculateTableIndexSize(TableCatalogEntry &table) {
 //===--------------------------------------------------------------------===//
 
 struct InspectDatabaseBindData : public TableFunctionData {
-	explicit InspectDatabaseBindData(string database_name_p) : database_name(std::move(database_name_p)) {
+	InspectDatabaseBindData(string database_name_p, RowGroupSampling sampling_p, optional_idx timeout_ms_p,
+	                        bool profile_p, bool attribute_p)
+	    : database_name(std::move(database_name_p)), sampling(sampling_p), timeout_ms(timeout_ms_p),
+	      profile(profile_p), attribute(attribute_p) {
 	}
 
 	string database_name;
+	RowGroupSampling sampling;
+	optional_idx timeout_ms;
+	bool profile;
+	// Whether exclusive_bytes and shared_bytes are computed, see InspectDatabaseData
+	bool attribute;
+	// Bound schema position -> output column index, as optional columns are left out of the schema
+	vector<idx_t> schema_columns;
+};
+
+// Output layout
+constexpr idx_t DATABASE_NAME_IDX = 0;
+constexpr idx_t SCHEMA_NAME_IDX = 1;
+constexpr idx_t TABLE_NAME_IDX = 2;
+constexpr idx_t DATA_BYTES_IDX = 3;
+constexpr idx_t INDEX_BYTES_IDX = 4;
+constexpr idx_t EXCLUSIVE_BYTES_IDX = 5;
+constexpr idx_t SHARED_BYTES_IDX = 6;
+// Only present with row group sampling
+constexpr idx_t SAMPLED_ROW_GROUPS_IDX = 7;
+constexpr idx_t TOTAL_ROW_GROUPS_IDX = 8;
+constexpr idx_t DATA_BYTES_LOW_IDX = 9;
+constexpr idx_t DATA_BYTES_HIGH_IDX = 10;
+// Only present with a timeout
+constexpr idx_t TIMED_OUT_IDX = 11;
+constexpr idx_t OUTPUT_COLUMN_COUNT = 12;
+
+// One output row, kept so that complete results can be served from the result cache
+struct InspectDatabaseRow {
+	string schema_name;
+	string table_name;
+	idx_t data_bytes = 0;
+	idx_t index_bytes = 0;
+	idx_t exclusive_bytes = 0;
+	idx_t shared_bytes = 0;
+	// With row group sampling, data_bytes is extrapolated from the sampled row groups
+	idx_t sampled_row_groups = 0;
+	idx_t total_row_groups = 0;
+	bool has_interval = false;
+	idx_t data_bytes_low = 0;
+	idx_t data_bytes_high = 0;
+	// Skipped because the timeout passed; only the names are set
+	bool timed_out = false;
 };
 
+struct InspectDatabaseResult {
+	static constexpr const char *CACHE_OBJECT_TYPE = "table_inspector_inspect_database_result";
+
+	vector<InspectDatabaseRow> rows;
+	// Whether exclusive_bytes and shared_bytes were computed
+	bool has_attribution = false;
+
+	idx_t EstimateMemory() const {
+		idx_t memory = sizeof(InspectDatabaseResult);
+		for (const auto &row : rows) {
+			memory += sizeof(InspectDatabaseRow) + row.schema_name.size() + row.table_name.size();
+		}
+		return memory;
+	}
+};
+
+using CachedInspectDatabaseResult = CachedResult<InspectDatabaseResult>;
+
+// Extrapolates the table data size from a stratified sample of its row groups. Sampled row groups are measured by
+// the unique blocks they add, as unsampled tables are, so sampling every row group reproduces the exact size.
+void EstimateTableDataSize(const SegmentSnapshot::SampledSegments &sampled, TableCatalogEntry &table,
+                           BlockBitmap &blocks, InspectDatabaseRow &row) {
+	auto &storage_manager = table.ParentCatalog().GetAttached().GetStorageManager();
+	const idx_t block_alloc_size = storage_manager.GetBlockManager().GetBlockAllocSize();
+
+	blocks.Clear();
+	const auto sampled_values = MeasureSampledBlocks(sampled.sample, sampled.segments, block_alloc_size, blocks);
+	const auto estimate = ExtrapolateTotal(sampled.sample, sampled_values, sampled.row_group_count);
+
+	row.sampled_row_groups = sampled.sample.size();
+	row.total_row_groups = sampled.row_group_count;
+	row.data_bytes = static_cast<idx_t>(std::llround(estimate.estimate));
+	row.has_interval = estimate.has_variance;
+	if (estimate.has_variance) {
+		row.data_bytes_low = static_cast<idx_t>(std::llround(estimate.Low()));
+		row.data_bytes_high = static_cast<idx_t>(std::llround(estimate.High()));
+	}
+}
+
+// Tables are collected up front in Init, which only touches the catalog. The expensive per-table work
+// (segment collection and index allocator walks) runs in Execute: every thread claims the next unprocessed
+// table, so tables are inspected in parallel and each row is emitted as soon as its table finishes.
+// If the result cache holds the result for the current version, Init skips the catalog entirely and the rows
+// are emitted from the cached result instead.
+//
+// exclusive_bytes and shared_bytes need the segments of all tables, since small segments of different tables can
+// share a block. They're NULL unless `attribute := true` is passed, so that rows stream by default. With it, and
+// when they're projected, threads keep their rows instead of emitting them, and the thread that finishes the last
+// table attributes the blocks and emits all rows.
+//
+// With `sample` or `max_row_groups`, only a stratified sample of each table's row groups is sized, and
+// persisted_data_bytes is extrapolated with a 95% confidence interval. Sampled results can't be attributed and aren't
+// cached.
+//
+// Threads check for interruption before every table. With `timeout_ms`, tables claimed after the deadline are not
+// inspected: their rows have NULL sizes and timed_out set, and the result is not cached.
+//
+// With `profile := true`, every phase is timed and counted, see InspectionProfile. The profile is shown by
+// EXPLAIN ANALYZE and kept for inspect_last_profile() once the query ends.
 struct InspectDatabaseData : public GlobalTableFunctionState {
-	InspectDatabaseData() : offset(0) {
+	InspectDatabaseData() : next_table(0), cached_result_claimed(false), timed_out(false), finished_tables(0) {
 	}
 
-	struct TableEntry {
-		string database_name;
-		string schema_name;
-		string table_name;
-		idx_t persisted_data_size_bytes = 0;
-		idx_t index_size_bytes = 0;
-	};
+	idx_t MaxThreads() const override {
+		if (cached_result) {
+			return 1;
+		}
+		return MaxValue<idx_t>(tables.size(), 1);
+	}
+
+	optional_ptr<Catalog> catalog;
+	RowGroupSampling sampling;
+	InspectionDeadline deadline;
+	InspectionProfiler profiler;
+	ResultVersion version;
+	vector<idx_t> column_map;
+	bool need_attribution = false;
+
+	// Set on a cache hit, handed to the first local state
+	CachedInspectDatabaseResult::ResultPtr cached_result;
+	atomic<bool> cached_result_claimed;
+
+	shared_ptr<SegmentSnapshot> snapshot;
+	vector<reference<TableCatalogEntry>> tables;
+	atomic<idx_t> next_table;
+	// Set once a table was skipped because of the timeout
+	atomic<bool> timed_out;
+	// Used to size the per-thread block bitmaps
+	idx_t total_blocks = 0;
+
+	// Rows of finished tables, stored in the result cache once every table is done
+	bool store_result = false;
+	mutex result_lock;
+	shared_ptr<InspectDatabaseResult> result;
+	idx_t finished_tables;
+	// Segments of every table, indexed like tables; only kept for the attribution. Null for skipped tables.
+	vector<SegmentSnapshot::TableSegments> table_segments;
+};
+
+struct InspectDatabaseLocalState : public LocalTableFunctionState {
+	explicit InspectDatabaseLocalState(idx_t total_blocks) : blocks(total_blocks) {
+	}
 
-	vector<TableEntry> entries;
-	idx_t offset;
+	// Scratch bitmap for unique block counting, reused across the tables this thread inspects
+	BlockBitmap blocks;
+
+	// Complete result this thread emits: the cached result, or the result it attributed as the last finisher
+	CachedInspectDatabaseResult::ResultPtr complete_result;
+	idx_t complete_offset = 0;
 };
 
 // Shared bind logic for all inspect_database overloads
-unique_ptr<FunctionData> InspectDatabaseBindInternal(ClientContext &context, const string &database_name,
-                                                     vector<LogicalType> &return_types, vector<string> &names) {
+unique_ptr<FunctionData> InspectDatabaseBindInternal(ClientContext &context, TableFunctionBindInput &input,
+                                                     const string &database_name, vector<LogicalType> &return_types,
+                                                     vector<string> &names) {
 	D_ASSERT(names.empty());
 	D_ASSERT(return_types.empty());
 
 	// Define output columns
-	names.reserve(5);
-	return_types.reserve(5);
+	names.reserve(OUTPUT_COLUMN_COUNT);
+	return_types.reserve(OUTPUT_COLUMN_COUNT);
 	names.emplace_back("database_name");
 	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
 	names.emplace_back("schema_name");
@@ -129,22 +259,63 @@ unique_ptr<FunctionData> InspectDatabaseBindInternal(ClientContext &context, con
 	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
 	names.emplace_back("index_bytes");
 	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("exclusive_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("shared_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	const auto sampling = RowGroupSampling::FromNamedParameters(input.named_parameters, "inspect_database");
+	if (sampling.IsEnabled()) {
+		names.emplace_back("sampled_row_groups");
+		return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+		names.emplace_back("total_row_groups");
+		return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+		names.emplace_back("persisted_data_bytes_low");
+		return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+		names.emplace_back("persisted_data_bytes_high");
+		return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	}
+	const auto timeout_ms = InspectionDeadline::GetTimeout(input.named_parameters, "inspect_database");
+	if (timeout_ms.IsValid()) {
+		names.emplace_back("timed_out");
+		return_types.emplace_back(LogicalType {LogicalTypeId::BOOLEAN});
+	}
 
-	return make_uniq<InspectDatabaseBindData>(database_name);
+	const bool profile = InspectionProfile::IsEnabled(input.named_parameters);
+	auto attribute_entry = input.named_parameters.find("attribute");
+	const bool attribute = attribute_entry != input.named_parameters.end() && !attribute_entry->second.IsNull() &&
+	                       attribute_entry->second.GetValue<bool>();
+	// Sampled results only cover part of every table, so their blocks can't be attributed
+	if (attribute && sampling.IsEnabled()) {
+		throw InvalidInputException("inspect_database() can't combine attribute := true with sample or max_row_groups");
+	}
+	auto result = make_uniq<InspectDatabaseBindData>(database_name, sampling, timeout_ms, profile, attribute);
+	for (idx_t column_idx = 0; column_idx <= SHARED_BYTES_IDX; ++column_idx) {
+		result->schema_columns.push_back(column_idx);
+	}
+	if (sampling.IsEnabled()) {
+		for (idx_t column_idx = SAMPLED_ROW_GROUPS_IDX; column_idx <= DATA_BYTES_HIGH_IDX; ++column_idx) {
+			result->schema_columns.push_back(column_idx);
+		}
+	}
+	if (timeout_ms.IsValid()) {
+		result->schema_columns.push_back(TIMED_OUT_IDX);
+	}
+	return std::move(result);
 }
 
 // inspect_database(database_name)
 unique_ptr<FunctionData> InspectDatabaseBindWithDatabase(ClientContext &context, TableFunctionBindInput &input,
                                                          vector<LogicalType> &return_types, vector<string> &names) {
 	const auto database_name = input.inputs[0].GetValue<string>();
-	return InspectDatabaseBindInternal(context, database_name, return_types, names);
+	return InspectDatabaseBindInternal(context, input, database_name, return_types, names);
 }
 
 // inspect_database() — uses current database
 unique_ptr<FunctionData> InspectDatabaseBindCurrentDB(ClientContext &context, TableFunctionBindInput &input,
                                                       vector<LogicalType> &return_types, vector<string> &names) {
 	// INVALID_CATALOG retrieves the currently active catalog
-	return InspectDatabaseBindInternal(context, INVALID_CATALOG, return_types, names);
+	return InspectDatabaseBindInternal(context, input, INVALID_CATALOG, return_types, names);
 }
 
 unique_ptr<GlobalTableFunctionState> InspectDatabaseInit(ClientContext &context, TableFunctionInitInput &input) {
@@ -168,6 +339,38 @@ unique_ptr<GlobalTableFunctionState> InspectDatabaseInit(ClientContext &context,
 		                            "     D SELECT * FROM inspect_database('mydb');\n\n");
 	}
 
+	result->catalog = &catalog;
+	result->sampling = bind_data.sampling;
+	result->deadline = InspectionDeadline::Start(bind_data.timeout_ms);
+	if (bind_data.profile) {
+		result->profiler.Start(context, "inspect_database", catalog.GetName());
+	}
+	const auto profile = result->profiler.Get();
+	result->column_map = OutputWriter::BuildColumnMap(input.column_ids, OUTPUT_COLUMN_COUNT, bind_data.schema_columns);
+	result->need_attribution = bind_data.attribute &&
+	                           (result->column_map[EXCLUSIVE_BYTES_IDX] != DConstants::INVALID_INDEX ||
+	                            result->column_map[SHARED_BYTES_IDX] != DConstants::INVALID_INDEX);
+
+	result->version = ResultVersion::Get(context, catalog);
+	if (!result->sampling.IsEnabled()) {
+		ScopedPhaseTimer timer(profile, InspectionPhase::RESULT_CACHE);
+		auto cached_result = CachedInspectDatabaseResult::Lookup(context, catalog, result->version);
+		if (cached_result && (cached_result->has_attribution || !result->need_attribution)) {
+			if (profile) {
+				profile->Add(InspectionCounter::RESULT_CACHE_HITS, 1);
+			}
+			result->cached_result = std::move(cached_result);
+			return std::move(result);
+		}
+		if (result->version.IsCacheable() && IsResultCacheEnabled(context)) {
+			result->store_result = true;
+		}
+	}
+
+	ScopedPhaseTimer catalog_timer(profile, InspectionPhase::CATALOG_SCAN);
+	result->snapshot = SegmentSnapshot::Get(context, catalog);
+	result->total_blocks = result->version.checkpoint_id.total_blocks;
+
 	auto schemas = catalog.GetSchemas(context);
 
 	for (auto &schema_ref : schemas) {
@@ -178,56 +381,228 @@ unique_ptr<GlobalTableFunctionState> InspectDatabaseInit(ClientContext &context,
 			continue;
 		}
 
-		// Scan all tables in this schema
-		schema.Scan(context, CatalogType::TABLE_ENTRY, [&](CatalogEntry &entry) {
-			auto &table = entry.Cast<TableCatalogEntry>();
+		// Collect all tables in this schema, they're inspected in Execute
+		schema.Scan(context, CatalogType::TABLE_ENTRY,
+		            [&](CatalogEntry &entry) { result->tables.emplace_back(entry.Cast<TableCatalogEntry>()); });
+	}
 
-			// Calculate table data size using unique data blocks.
-			QueryContext query_context {context};
-			const auto segment_info = table.GetColumnSegmentInfo(query_context);
-			const idx_t data_bytes = CalculateTableDataSize(segment_info, table);
+	result->result = make_shared_ptr<InspectDatabaseResult>();
+	result->result->has_attribution = result->need_attribution;
+	if (result->need_attribution) {
+		result->result->rows.resize(result->tables.size());
+		result->table_segments.resize(result->tables.size());
+	}
 
-			const idx_t index_bytes = CalculateTableIndexSize(table);
+	// Without tables Execute never finishes one, so the (empty) result is complete already
+	if (result->store_result && result->tables.empty()) {
+		CachedInspectDatabaseResult::Store(context, catalog, result->version, std::move(result->result));
+	}
 
-			InspectDatabaseData::TableEntry table_entry;
-			table_entry.database_name = table.ParentCatalog().GetName();
-			table_entry.schema_name = schema.name;
-			table_entry.table_name = table.name;
-			table_entry.persisted_data_size_bytes = data_bytes;
-			table_entry.index_size_bytes = index_bytes;
+	return std::move(result);
+}
 
-			result->entries.push_back(std::move(table_entry));
-		});
+unique_ptr<LocalTableFunctionState> InspectDatabaseInitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                             GlobalTableFunctionState *global_state) {
+	auto &state = global_state->Cast<InspectDatabaseData>();
+	auto result = make_uniq<InspectDatabaseLocalState>(state.total_blocks);
+	const auto profile = state.profiler.Get();
+	if (profile) {
+		profile->Add(InspectionCounter::BLOCK_SET_BYTES, result->blocks.Capacity() / 8);
+	}
+	if (state.cached_result && !state.cached_result_claimed.exchange(true)) {
+		result->complete_result = state.cached_result;
 	}
-
 	return std::move(result);
 }
 
+void WriteTableRow(OutputWriter &writer, const string &database_name, const InspectDatabaseRow &row,
+                   bool has_attribution) {
+	writer.WriteString(DATABASE_NAME_IDX, database_name);
+	writer.WriteString(SCHEMA_NAME_IDX, row.schema_name);
+	writer.WriteString(TABLE_NAME_IDX, row.table_name);
+	writer.Write<bool>(TIMED_OUT_IDX, row.timed_out);
+	if (row.timed_out) {
+		for (idx_t column_idx = DATA_BYTES_IDX; column_idx <= DATA_BYTES_HIGH_IDX; ++column_idx) {
+			writer.WriteNull(column_idx);
+		}
+		writer.NextRow();
+		return;
+	}
+	writer.WriteBigint(DATA_BYTES_IDX, row.data_bytes);
+	writer.WriteBigint(INDEX_BYTES_IDX, row.index_bytes);
+	writer.WriteBigint(SAMPLED_ROW_GROUPS_IDX, row.sampled_row_groups);
+	writer.WriteBigint(TOTAL_ROW_GROUPS_IDX, row.total_row_groups);
+	if (row.has_interval) {
+		writer.WriteBigint(DATA_BYTES_LOW_IDX, row.data_bytes_low);
+		writer.WriteBigint(DATA_BYTES_HIGH_IDX, row.data_bytes_high);
+	} else {
+		writer.WriteNull(DATA_BYTES_LOW_IDX);
+		writer.WriteNull(DATA_BYTES_HIGH_IDX);
+	}
+	if (has_attribution) {
+		writer.WriteBigint(EXCLUSIVE_BYTES_IDX, row.exclusive_bytes);
+		writer.WriteBigint(SHARED_BYTES_IDX, row.shared_bytes);
+	} else {
+		writer.WriteNull(EXCLUSIVE_BYTES_IDX);
+		writer.WriteNull(SHARED_BYTES_IDX);
+	}
+	writer.NextRow();
+}
+
+// Splits the blocks of all tables into exclusive and shared bytes per table
+void AttributeTableBlocks(InspectDatabaseData &state) {
+	auto &rows = state.result->rows;
+	if (state.tables.empty()) {
+		return;
+	}
+	ScopedPhaseTimer timer(state.profiler.Get(), InspectionPhase::ATTRIBUTION);
+	auto &storage_manager = state.catalog->GetAttached().GetStorageManager();
+	const idx_t block_alloc_size = storage_manager.GetBlockManager().GetBlockAllocSize();
+
+	// Tables skipped because of the timeout have no segments
+	vector<reference<const vector<ColumnSegmentInfo>>> owners;
+	vector<idx_t> owner_tables;
+	owners.reserve(state.table_segments.size());
+	for (idx_t table_idx = 0; table_idx < state.table_segments.size(); ++table_idx) {
+		if (state.table_segments[table_idx]) {
+			owners.emplace_back(*state.table_segments[table_idx]);
+			owner_tables.push_back(table_idx);
+		}
+	}
+	const auto attribution = AttributeSharedBlocks(owners, block_alloc_size);
+	for (idx_t owner_idx = 0; owner_idx < owner_tables.size(); ++owner_idx) {
+		auto &row = rows[owner_tables[owner_idx]];
+		row.exclusive_bytes = attribution[owner_idx].exclusive_bytes;
+		row.shared_bytes = attribution[owner_idx].shared_bytes;
+	}
+	// Segments are no longer needed
+	state.table_segments.clear();
+}
+
+// Inspects one table. Segments are returned for the attribution. Once the deadline has passed, the table is only
+// named in its row.
+InspectDatabaseRow InspectTable(ClientContext &context, InspectDatabaseData &state,
+                                InspectDatabaseLocalState &local_state, TableCatalogEntry &table,
+                                SegmentSnapshot::TableSegments &segment_info) {
+	CheckInterrupted(context);
+
+	InspectDatabaseRow row;
+	row.schema_name = table.schema.name;
+	row.table_name = table.name;
+	if (state.deadline.Passed()) {
+		row.timed_out = true;
+		state.timed_out = true;
+		return row;
+	}
+
+	const auto profile = state.profiler.Get();
+	// Calculate table data size using unique data blocks, or extrapolate it from a sample of row groups, of which
+	// only the segments are walked
+	idx_t segment_count;
+	if (state.sampling.IsEnabled()) {
+		SegmentSnapshot::SampledSegments sampled;
+		{
+			ScopedPhaseTimer timer(profile, InspectionPhase::SEGMENT_COLLECTION);
+			sampled = state.snapshot->GetSampledSegments(context, table, state.sampling);
+		}
+		ScopedPhaseTimer timer(profile, InspectionPhase::BLOCK_COUNTING);
+		EstimateTableDataSize(sampled, table, local_state.blocks, row);
+		segment_count = sampled.segments.size();
+	} else {
+		{
+			ScopedPhaseTimer timer(profile, InspectionPhase::SEGMENT_COLLECTION);
+			segment_info = state.snapshot->GetTableSegments(context, table);
+		}
+		ScopedPhaseTimer timer(profile, InspectionPhase::BLOCK_COUNTING);
+		row.data_bytes = CalculateTableDataSize(*segment_info, table, local_state.blocks);
+		segment_count = segment_info->size();
+	}
+
+	{
+		ScopedPhaseTimer timer(profile, InspectionPhase::INDEX_WALK);
+		row.index_bytes = CalculateTableIndexSize(table, profile);
+	}
+
+	if (profile) {
+		profile->Add(InspectionCounter::TABLES_VISITED, 1);
+		profile->Add(InspectionCounter::SEGMENTS_VISITED, segment_count);
+		if (!state.sampling.IsEnabled()) {
+			profile->Add(InspectionCounter::UNIQUE_BLOCKS, local_state.blocks.Count());
+		}
+	}
+	return row;
+}
+
 void InspectDatabaseExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
 	auto &state = data.global_state->Cast<InspectDatabaseData>();
+	auto &local_state = data.local_state->Cast<InspectDatabaseLocalState>();
+	const auto &database_name = state.catalog->GetName();
+
+	OutputWriter writer(output, state.column_map);
+
+	// With attribution, rows are only emitted once all tables are done. Threads keep claiming tables until they have
+	// rows to emit, as an empty chunk would end the thread while there are tables left.
+	while (!local_state.complete_result) {
+		// Claim the next table; once all tables are claimed this thread is done
+		const idx_t table_idx = state.next_table++;
+		if (table_idx >= state.tables.size()) {
+			output.SetCardinality(0);
+			return;
+		}
+		SegmentSnapshot::TableSegments segment_info;
+		auto row = InspectTable(context, state, local_state, state.tables[table_idx].get(), segment_info);
 
-	idx_t count = 0;
+		if (!state.need_attribution) {
+			// Emit one row per table so results stream while other threads are still inspecting
+			WriteTableRow(writer, database_name, row, false);
+			writer.Finalize();
 
-	constexpr idx_t DATABASE_NAME_IDX = 0;
-	constexpr idx_t SCHEMA_NAME_IDX = 1;
-	constexpr idx_t TABLE_NAME_IDX = 2;
-	constexpr idx_t DATA_BYTES_IDX = 3;
-	constexpr idx_t INDEX_BYTES_IDX = 4;
+			if (!state.store_result) {
+				return;
+			}
+			// The thread that finishes the last table publishes the complete result, unless tables were skipped
+			lock_guard<mutex> guard(state.result_lock);
+			state.result->rows.push_back(std::move(row));
+			if (state.result->rows.size() == state.tables.size() && !state.timed_out) {
+				CachedInspectDatabaseResult::Store(context, *state.catalog, state.version, std::move(state.result));
+			}
+			return;
+		}
 
-	while (state.offset < state.entries.size() && count < STANDARD_VECTOR_SIZE) {
-		auto &entry = state.entries[state.offset];
+		{
+			lock_guard<mutex> guard(state.result_lock);
+			state.result->rows[table_idx] = std::move(row);
+			state.table_segments[table_idx] = std::move(segment_info);
+			if (++state.finished_tables < state.tables.size()) {
+				// Another thread emits the rows once all tables are done
+				continue;
+			}
+		}
 
-		output.SetValue(DATABASE_NAME_IDX, count, Value(entry.database_name));
-		output.SetValue(SCHEMA_NAME_IDX, count, Value(entry.schema_name));
-		output.SetValue(TABLE_NAME_IDX, count, Value(entry.table_name));
-		output.SetValue(DATA_BYTES_IDX, count, Value::BIGINT(NumericCast<int64_t>(entry.persisted_data_size_bytes)));
-		output.SetValue(INDEX_BYTES_IDX, count, Value::BIGINT(NumericCast<int64_t>(entry.index_size_bytes)));
+		// Last table done: every other thread has published its table, attribute the blocks and emit all rows
+		AttributeTableBlocks(state);
+		local_state.complete_result = std::move(state.result);
+		if (state.store_result && !state.timed_out) {
+			CachedInspectDatabaseResult::Store(context, *state.catalog, state.version, local_state.complete_result);
+		}
+	}
 
-		state.offset++;
-		count++;
+	// Complete result: served from the cache, or attributed by this thread
+	const auto &complete_result = *local_state.complete_result;
+	while (local_state.complete_offset < complete_result.rows.size() && !writer.IsFull()) {
+		WriteTableRow(writer, database_name, complete_result.rows[local_state.complete_offset++],
+		              complete_result.has_attribution);
 	}
+	writer.Finalize();
+}
 
-	output.SetCardinality(count);
+// Shows the profile in EXPLAIN ANALYZE
+InsertionOrderPreservingMap<string> InspectDatabaseDynamicToString(TableFunctionDynamicToStringInput &input) {
+	if (!input.global_state) {
+		return InsertionOrderPreservingMap<string>();
+	}
+	const auto profile = input.global_state->Cast<InspectDatabaseData>().profiler.Get();
+	return profile ? profile->ToProfilerInfo() : InsertionOrderPreservingMap<string>();
 }
 
 } // namespace
@@ -236,12 +611,25 @@ void RegisterInspectDatabaseFunction(ExtensionLoader &loader) {
 	// inspect_database(database_name)
 	TableFunction inspect_database_with_db("inspect_database", {LogicalType {LogicalTypeId::VARCHAR}},
 	                                       InspectDatabaseExecute, InspectDatabaseBindWithDatabase,
-	                                       InspectDatabaseInit);
+	                                       InspectDatabaseInit, InspectDatabaseInitLocal);
+	inspect_database_with_db.projection_pushdown = true;
+	inspect_database_with_db.dynamic_to_string = InspectDatabaseDynamicToString;
+	RowGroupSampling::AddNamedParameters(inspect_database_with_db);
+	InspectionDeadline::AddNamedParameter(inspect_database_with_db);
+	InspectionProfile::AddNamedParameter(inspect_database_with_db);
+	inspect_database_with_db.named_parameters["attribute"] = LogicalType {LogicalTypeId::BOOLEAN};
 	loader.RegisterFunction(std::move(inspect_database_with_db));
 
 	// inspect_database() — uses current database
 	TableFunction inspect_database_current_db("inspect_database", {}, InspectDatabaseExecute,
-	                                          InspectDatabaseBindCurrentDB, InspectDatabaseInit);
+	                                          InspectDatabaseBindCurrentDB, InspectDatabaseInit,
+	                                          InspectDatabaseInitLocal);
+	inspect_database_current_db.projection_pushdown = true;
+	inspect_database_current_db.dynamic_to_string = InspectDatabaseDynamicToString;
+	RowGroupSampling::AddNamedParameters(inspect_database_current_db);
+	InspectionDeadline::AddNamedParameter(inspect_database_current_db);
+	InspectionProfile::AddNamedParameter(inspect_database_current_db);
+	inspect_database_current_db.named_parameters["attribute"] = LogicalType {LogicalTypeId::BOOLEAN};
 	loader.RegisterFunction(std::move(inspect_database_current_db));
 }
 
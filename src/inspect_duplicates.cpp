@@ -0,0 +1,455 @@
+#include "inspect_duplicates.hpp"
+#include "database_file_reader.hpp"
+#include "output_writer.hpp"
+#include "segment_snapshot.hpp"
+#include "util.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/catalog/default/default_schemas.hpp"
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/storage/table_storage_info.hpp"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <tuple>
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// inspect_duplicates() - Identical segments across tables and columns
+//===--------------------------------------------------------------------===//
+
+// Fingerprints every persistent segment by hashing its compressed bytes, read straight from the database file at
+// block_id/block_offset, and reports the columns whose segments are byte-for-byte identical, e.g. a table copied
+// with CREATE TABLE ... AS SELECT * FROM ... or a column duplicated within a table.
+//
+// The first occurrence of a segment (in catalog and segment order) is the original; every later occurrence is a
+// duplicate of it. One row is reported per pair of original and duplicate column, with the number of duplicate
+// segments and their bytes. Every duplicate segment is counted once, so the duplicate_bytes of all rows add up to
+// the bytes deduplicating copies of tables and columns would save. Segments that repeat within one column (e.g. a
+// low-cardinality column with the same value in every row group) are not copies: only the first occurrence of a
+// segment in every column is considered, so a column is never reported as a duplicate of itself.
+//
+// Segment sizes within a block come from the offset of the next segment (see CalculateSegmentSizes), so the size
+// of the last segment in a block is an upper bound that includes the zeroed rest of the block. Trailing zero bytes
+// are therefore left out of the fingerprint, which also covers the type, compression and value count. Fingerprints
+// are 64-bit hashes: a collision would report a false duplicate, which is very unlikely.
+//
+// The file is read in a single pass: the blocks of all segments are sorted and split into runs of consecutive
+// blocks, which the threads claim in file order. Each run is read with one sequential read, and every segment
+// part within it is hashed. The thread finishing the last run groups the fingerprints and emits the rows. The
+// blocks are read as of the last checkpoint, without going through the buffer pool.
+
+// Most consecutive blocks read at once
+constexpr idx_t MAX_RUN_BLOCKS = 16;
+
+struct TableColumns {
+	string schema_name;
+	string table_name;
+	// Indexed by physical column id
+	vector<string> column_names;
+	// Keeps the fingerprinted segments alive
+	SegmentSnapshot::TableSegments segments;
+};
+
+// A persistent segment, hashed in parts: its bytes in the main block, and every additional block
+struct FingerprintedSegment {
+	idx_t table_idx;
+	const ColumnSegmentInfo *info;
+	idx_t size_bytes;
+	idx_t part_start;
+	idx_t part_count;
+};
+
+// Consecutive blocks read at once, and the sorted segment parts within them
+struct BlockRun {
+	block_id_t first_block;
+	idx_t block_count;
+	idx_t part_begin;
+	idx_t part_end;
+};
+
+// (original table, original column, duplicate table, duplicate column)
+using ColumnPair = std::tuple<idx_t, idx_t, idx_t, idx_t>;
+
+struct DuplicateRow {
+	ColumnPair columns;
+	idx_t duplicate_segments = 0;
+	idx_t duplicate_bytes = 0;
+};
+
+struct InspectDuplicatesBindData : public TableFunctionData {
+	explicit InspectDuplicatesBindData(string database_name_p) : database_name(std::move(database_name_p)) {
+	}
+
+	string database_name;
+};
+
+struct InspectDuplicatesState : public GlobalTableFunctionState {
+	InspectDuplicatesState() : next_run(0), finished_runs(0), emit_claimed(false), offset(0) {
+	}
+
+	idx_t MaxThreads() const override {
+		return MaxValue<idx_t>(runs.size(), 1);
+	}
+
+	string path;
+	DatabaseFileInfo file_info;
+	vector<TableColumns> tables;
+	vector<FingerprintedSegment> segments;
+
+	// Segment parts sorted by (block_id, offset), segment_idx is the part index
+	vector<SegmentOffset> sorted_parts;
+	vector<idx_t> part_sizes;
+	// Written by the thread that reads the part's block
+	vector<hash_t> part_hashes;
+	vector<idx_t> part_lengths;
+
+	vector<BlockRun> runs;
+	atomic<idx_t> next_run;
+	atomic<idx_t> finished_runs;
+	// Without runs, the first thread emits the (empty) result
+	atomic<bool> emit_claimed;
+
+	// Built and emitted by the thread that finished last
+	vector<DuplicateRow> rows;
+	idx_t offset;
+};
+
+struct InspectDuplicatesLocalState : public LocalTableFunctionState {
+	unique_ptr<DatabaseFileReader> reader;
+	vector<data_t> buffer;
+	bool emitting = false;
+};
+
+void DefineDuplicatesColumns(vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	names.reserve(8);
+	return_types.reserve(8);
+	names.emplace_back("schema_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("table_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("column_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("duplicate_schema_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("duplicate_table_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("duplicate_column_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("duplicate_segments");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("duplicate_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+}
+
+// inspect_duplicates(database_name)
+unique_ptr<FunctionData> InspectDuplicatesBindWithDatabase(ClientContext &context, TableFunctionBindInput &input,
+                                                           vector<LogicalType> &return_types, vector<string> &names) {
+	DefineDuplicatesColumns(return_types, names);
+	return make_uniq<InspectDuplicatesBindData>(input.inputs[0].GetValue<string>());
+}
+
+// inspect_duplicates() — uses current database
+unique_ptr<FunctionData> InspectDuplicatesBindCurrentDB(ClientContext &context, TableFunctionBindInput &input,
+                                                        vector<LogicalType> &return_types, vector<string> &names) {
+	DefineDuplicatesColumns(return_types, names);
+	// INVALID_CATALOG retrieves the currently active catalog
+	return make_uniq<InspectDuplicatesBindData>(INVALID_CATALOG);
+}
+
+// Adds the persistent segments of a table, with one part for the main block and one per additional block
+void CollectTableSegments(InspectDuplicatesState &state, idx_t table_idx) {
+	const auto &table = state.tables[table_idx];
+	const auto &segment_info = *table.segments;
+	const idx_t block_alloc_size = state.file_info.block_alloc_size;
+	const idx_t block_data_size = state.file_info.GetBlockDataSize();
+	const auto segment_sizes = CalculateSegmentSizes(segment_info, block_alloc_size);
+
+	for (idx_t segment_idx = 0; segment_idx < segment_info.size(); ++segment_idx) {
+		const auto &seg = segment_info[segment_idx];
+		if (!seg.persistent || seg.block_id == INVALID_BLOCK || seg.column_id >= table.column_names.size()) {
+			continue;
+		}
+		if (seg.block_offset >= block_data_size) {
+			continue;
+		}
+		// The upper bound of the last segment in a block would run into the next block's checksum
+		const idx_t main_size = MinValue<idx_t>(segment_sizes[segment_idx], block_data_size - seg.block_offset);
+
+		FingerprintedSegment segment;
+		segment.table_idx = table_idx;
+		segment.info = &seg;
+		segment.size_bytes = main_size + seg.additional_blocks.size() * block_alloc_size;
+		segment.part_start = state.part_sizes.size();
+		segment.part_count = 1 + seg.additional_blocks.size();
+
+		state.sorted_parts.push_back(SegmentOffset {seg.block_id, seg.block_offset, state.part_sizes.size()});
+		state.part_sizes.push_back(main_size);
+		for (const auto block_id : seg.additional_blocks) {
+			state.sorted_parts.push_back(SegmentOffset {block_id, 0, state.part_sizes.size()});
+			state.part_sizes.push_back(block_data_size);
+		}
+		state.segments.push_back(segment);
+	}
+}
+
+// Splits the sorted parts into runs of at most MAX_RUN_BLOCKS consecutive blocks
+vector<BlockRun> BuildBlockRuns(const vector<SegmentOffset> &sorted_parts) {
+	vector<BlockRun> runs;
+	for (idx_t part_idx = 0; part_idx < sorted_parts.size(); ++part_idx) {
+		const auto block_id = sorted_parts[part_idx].block_id;
+		if (!runs.empty()) {
+			auto &run = runs.back();
+			const auto last_block = run.first_block + NumericCast<block_id_t>(run.block_count) - 1;
+			if (block_id == last_block) {
+				run.part_end = part_idx + 1;
+				continue;
+			}
+			if (block_id == last_block + 1 && run.block_count < MAX_RUN_BLOCKS) {
+				run.block_count++;
+				run.part_end = part_idx + 1;
+				continue;
+			}
+		}
+		runs.push_back(BlockRun {block_id, 1, part_idx, part_idx + 1});
+	}
+	return runs;
+}
+
+unique_ptr<GlobalTableFunctionState> InspectDuplicatesInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<InspectDuplicatesState>();
+
+	auto &bind_data = input.bind_data->Cast<InspectDuplicatesBindData>();
+	auto &catalog = Catalog::GetCatalog(context, bind_data.database_name);
+
+	// Require persistent database
+	if (catalog.InMemory()) {
+		throw InvalidInputException(
+		    "inspect_duplicates() requires a persistent database file.\n"
+		    "Segments are fingerprinted from the bytes stored in the database file.\n\n"
+		    "Correct usage:\n"
+		    "  1. Open a database file directly:\n"
+		    "     $ duckdb mydata.duckdb\n"
+		    "     D SELECT * FROM inspect_duplicates();\n\n"
+		    "  2. Or attach a database file:\n"
+		    "     D ATTACH 'mydata.duckdb' AS mydb;\n"
+		    "     D SELECT * FROM inspect_duplicates('mydb');\n\n");
+	}
+
+	result->path = catalog.GetDBPath();
+	DatabaseFileReader reader(FileSystem::GetFileSystem(context), result->path);
+	result->file_info = reader.Read();
+
+	auto snapshot = SegmentSnapshot::Get(context, catalog);
+	auto schemas = catalog.GetSchemas(context);
+	for (auto &schema_ref : schemas) {
+		auto &schema = schema_ref.get();
+
+		// Skip internal schemas
+		if (DefaultSchemaGenerator::IsDefaultSchema(schema.name)) {
+			continue;
+		}
+
+		schema.Scan(context, CatalogType::TABLE_ENTRY, [&](CatalogEntry &entry) {
+			CheckInterrupted(context);
+			auto &table = entry.Cast<TableCatalogEntry>();
+
+			TableColumns columns;
+			columns.schema_name = schema.name;
+			columns.table_name = table.name;
+			for (auto &col : table.GetColumns().Physical()) {
+				const idx_t physical_id = col.Physical().index;
+				if (columns.column_names.size() <= physical_id) {
+					columns.column_names.resize(physical_id + 1);
+				}
+				columns.column_names[physical_id] = col.Name();
+			}
+			columns.segments = snapshot->GetTableSegments(context, table);
+			result->tables.push_back(std::move(columns));
+			CollectTableSegments(*result, result->tables.size() - 1);
+		});
+	}
+
+	RadixSortSegmentOffsets(result->sorted_parts);
+	result->runs = BuildBlockRuns(result->sorted_parts);
+	result->part_hashes.resize(result->part_sizes.size());
+	result->part_lengths.resize(result->part_sizes.size());
+	return std::move(result);
+}
+
+unique_ptr<LocalTableFunctionState> InspectDuplicatesInitLocal(ExecutionContext &context, TableFunctionInitInput &input,
+                                                               GlobalTableFunctionState *global_state) {
+	auto &state = global_state->Cast<InspectDuplicatesState>();
+	auto result = make_uniq<InspectDuplicatesLocalState>();
+	// Every thread reads through its own handle
+	result->reader = make_uniq<DatabaseFileReader>(FileSystem::GetFileSystem(context.client), state.path);
+	return std::move(result);
+}
+
+// Reads a run of blocks and hashes every segment part within it. Trailing zero bytes are not hashed.
+void HashBlockRun(InspectDuplicatesState &state, InspectDuplicatesLocalState &local_state, const BlockRun &run) {
+	const auto &file_info = state.file_info;
+	const idx_t block_alloc_size = file_info.block_alloc_size;
+	const auto first_block = NumericCast<idx_t>(run.first_block);
+
+	local_state.buffer.resize(run.block_count * block_alloc_size);
+	local_state.reader->ReadAt(local_state.buffer.data(), local_state.buffer.size(),
+	                           file_info.GetBlockLocation(first_block));
+
+	for (idx_t sorted_idx = run.part_begin; sorted_idx < run.part_end; ++sorted_idx) {
+		const auto &part = state.sorted_parts[sorted_idx];
+		const idx_t part_idx = part.segment_idx;
+		// Position of the part's block data within the run
+		const idx_t data_position =
+		    file_info.GetBlockDataLocation(NumericCast<idx_t>(part.block_id)) - file_info.GetBlockLocation(first_block);
+		const auto data = local_state.buffer.data() + data_position + part.offset;
+
+		idx_t length = state.part_sizes[part_idx];
+		while (length > 0 && data[length - 1] == 0) {
+			length--;
+		}
+		state.part_hashes[part_idx] = Hash(const_char_ptr_cast(data), length);
+		state.part_lengths[part_idx] = length;
+	}
+}
+
+hash_t FingerprintSegment(const InspectDuplicatesState &state, const FingerprintedSegment &segment) {
+	const auto &seg = *segment.info;
+	hash_t result = Hash(seg.segment_type.c_str(), seg.segment_type.size());
+	result = CombineHash(result, Hash(seg.compression_type.c_str(), seg.compression_type.size()));
+	result = CombineHash(result, Hash(seg.segment_count));
+	for (idx_t part_idx = segment.part_start; part_idx < segment.part_start + segment.part_count; ++part_idx) {
+		result = CombineHash(result, state.part_hashes[part_idx]);
+		result = CombineHash(result, Hash(state.part_lengths[part_idx]));
+	}
+	return result;
+}
+
+// Groups the segments by fingerprint and counts every duplicate towards its pair of original and duplicate column.
+// Rows come by duplicate_bytes, largest first.
+vector<DuplicateRow> BuildRows(const InspectDuplicatesState &state) {
+	// Fingerprint -> the original segment
+	unordered_map<hash_t, idx_t> originals;
+	// Columns that hold a fingerprint already, as (fingerprint, table, column)
+	std::set<std::tuple<hash_t, idx_t, idx_t>> column_fingerprints;
+	std::map<ColumnPair, DuplicateRow> pairs;
+	for (idx_t segment_idx = 0; segment_idx < state.segments.size(); ++segment_idx) {
+		const auto &segment = state.segments[segment_idx];
+		const auto fingerprint = FingerprintSegment(state, segment);
+		if (!column_fingerprints.emplace(fingerprint, segment.table_idx, segment.info->column_id).second) {
+			// Repeats within the column
+			continue;
+		}
+		const auto entry = originals.emplace(fingerprint, segment_idx);
+		if (entry.second) {
+			continue;
+		}
+		const auto &original = state.segments[entry.first->second];
+		const ColumnPair columns(original.table_idx, original.info->column_id, segment.table_idx,
+		                         segment.info->column_id);
+		auto &row = pairs[columns];
+		row.columns = columns;
+		row.duplicate_segments++;
+		row.duplicate_bytes += segment.size_bytes;
+	}
+
+	vector<DuplicateRow> result;
+	result.reserve(pairs.size());
+	for (auto &pair : pairs) {
+		result.push_back(pair.second);
+	}
+	std::stable_sort(result.begin(), result.end(), [](const DuplicateRow &lhs, const DuplicateRow &rhs) {
+		return lhs.duplicate_bytes > rhs.duplicate_bytes;
+	});
+	return result;
+}
+
+void InspectDuplicatesExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectDuplicatesState>();
+	auto &local_state = data.local_state->Cast<InspectDuplicatesLocalState>();
+
+	constexpr idx_t SCHEMA_NAME_IDX = 0;
+	constexpr idx_t TABLE_NAME_IDX = 1;
+	constexpr idx_t COLUMN_NAME_IDX = 2;
+	constexpr idx_t DUPLICATE_SCHEMA_NAME_IDX = 3;
+	constexpr idx_t DUPLICATE_TABLE_NAME_IDX = 4;
+	constexpr idx_t DUPLICATE_COLUMN_NAME_IDX = 5;
+	constexpr idx_t DUPLICATE_SEGMENTS_IDX = 6;
+	constexpr idx_t DUPLICATE_BYTES_IDX = 7;
+
+	// Threads keep reading runs until none are left; the one finishing the last run emits the rows
+	while (!local_state.emitting) {
+		const idx_t run_idx = state.next_run++;
+		if (run_idx >= state.runs.size()) {
+			if (state.runs.empty() && !state.emit_claimed.exchange(true)) {
+				local_state.emitting = true;
+				state.rows = BuildRows(state);
+				break;
+			}
+			output.SetCardinality(0);
+			return;
+		}
+		CheckInterrupted(context);
+		HashBlockRun(state, local_state, state.runs[run_idx]);
+		// Every other thread has published its hashes once the last run is counted
+		if (++state.finished_runs == state.runs.size()) {
+			local_state.emitting = true;
+			state.rows = BuildRows(state);
+		}
+	}
+
+	OutputWriter writer(output);
+	while (state.offset < state.rows.size() && !writer.IsFull()) {
+		const auto &row = state.rows[state.offset];
+		const auto &original = state.tables[std::get<0>(row.columns)];
+		const auto &duplicate = state.tables[std::get<2>(row.columns)];
+
+		writer.WriteString(SCHEMA_NAME_IDX, original.schema_name);
+		writer.WriteString(TABLE_NAME_IDX, original.table_name);
+		writer.WriteString(COLUMN_NAME_IDX, original.column_names[std::get<1>(row.columns)]);
+		writer.WriteString(DUPLICATE_SCHEMA_NAME_IDX, duplicate.schema_name);
+		writer.WriteString(DUPLICATE_TABLE_NAME_IDX, duplicate.table_name);
+		writer.WriteString(DUPLICATE_COLUMN_NAME_IDX, duplicate.column_names[std::get<3>(row.columns)]);
+		writer.WriteBigint(DUPLICATE_SEGMENTS_IDX, row.duplicate_segments);
+		writer.WriteBigint(DUPLICATE_BYTES_IDX, row.duplicate_bytes);
+		writer.NextRow();
+
+		state.offset++;
+	}
+
+	writer.Finalize();
+}
+
+} // namespace
+
+void RegisterInspectDuplicatesFunction(ExtensionLoader &loader) {
+	// inspect_duplicates(database_name)
+	TableFunction inspect_duplicates_with_db("inspect_duplicates", {LogicalType {LogicalTypeId::VARCHAR}},
+	                                         InspectDuplicatesExecute, InspectDuplicatesBindWithDatabase,
+	                                         InspectDuplicatesInit, InspectDuplicatesInitLocal);
+	loader.RegisterFunction(std::move(inspect_duplicates_with_db));
+
+	// inspect_duplicates() — uses current database
+	TableFunction inspect_duplicates_current_db("inspect_duplicates", {}, InspectDuplicatesExecute,
+	                                            InspectDuplicatesBindCurrentDB, InspectDuplicatesInit,
+	                                            InspectDuplicatesInitLocal);
+	loader.RegisterFunction(std::move(inspect_duplicates_current_db));
+}
+
+} // namespace duckdb
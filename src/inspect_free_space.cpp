@@ -0,0 +1,309 @@
+#include "inspect_free_space.hpp"
+#include "block_bitmap.hpp"
+#include "database_file_reader.hpp"
+#include "output_writer.hpp"
+#include "util.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// inspect_free_space() / inspect_free_space_summary() - Free block layout
+//===--------------------------------------------------------------------===//
+
+// Free blocks are reusable but only shrink the file when they sit at its end. Their spread over the file tells
+// whether rewriting it (e.g. with COPY FROM DATABASE) is worth it: many small extents in the middle of the file
+// are only reclaimed by a rewrite, a trailing extent is reclaimed by truncation.
+// The free list is read from the database file, so both functions report the state of the last checkpoint.
+
+struct FreeSpace {
+	vector<FreeExtent> extents;
+	idx_t total_blocks = 0;
+	idx_t block_alloc_size = 0;
+	// Byte offset of each block is derived from the file layout
+	DatabaseFileInfo file_info;
+};
+
+struct InspectFreeSpaceBindData : public TableFunctionData {
+	explicit InspectFreeSpaceBindData(string database_name_p) : database_name(std::move(database_name_p)) {
+	}
+
+	string database_name;
+};
+
+// Reads the free list of a persistent catalog and groups it into extents
+FreeSpace LoadFreeSpace(ClientContext &context, const string &database_name, const string &function_name) {
+	auto &catalog = Catalog::GetCatalog(context, database_name);
+
+	// Require persistent database
+	if (catalog.InMemory()) {
+		throw InvalidInputException(
+		    "%s requires a persistent database file.\n"
+		    "This tool is designed to analyze the free space of existing .duckdb files.\n\n"
+		    "Correct usage:\n"
+		    "  1. Open a database file directly:\n"
+		    "     $ duckdb mydata.duckdb\n"
+		    "     D SELECT * FROM %s;\n\n"
+		    "  2. Or attach a database file:\n"
+		    "     D ATTACH 'mydata.duckdb' AS mydb;\n"
+		    "     D SELECT * FROM %s;\n\n",
+		    function_name + "()", function_name + "()", function_name + "('mydb')");
+	}
+
+	FreeSpace result;
+	DatabaseFileReader reader(FileSystem::GetFileSystem(context), catalog.GetDBPath());
+	result.file_info = reader.Read();
+	result.total_blocks = result.file_info.block_count;
+	result.block_alloc_size = result.file_info.block_alloc_size;
+
+	BlockBitmap free_blocks(result.total_blocks);
+	for (const auto block_id : result.file_info.free_blocks) {
+		free_blocks.Set(block_id);
+	}
+	result.extents = CollectFreeExtents(free_blocks, result.total_blocks);
+	return result;
+}
+
+//===--------------------------------------------------------------------===//
+// inspect_free_space() - One row per free extent
+//===--------------------------------------------------------------------===//
+
+struct InspectFreeSpaceState : public GlobalTableFunctionState {
+	InspectFreeSpaceState() : offset(0) {
+	}
+
+	FreeSpace free_space;
+	idx_t offset;
+};
+
+void DefineFreeSpaceColumns(vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	names.reserve(5);
+	return_types.reserve(5);
+	names.emplace_back("start_block");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("block_count");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("file_offset");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("size_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("is_trailing");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BOOLEAN});
+}
+
+// inspect_free_space(database_name)
+unique_ptr<FunctionData> InspectFreeSpaceBindWithDatabase(ClientContext &context, TableFunctionBindInput &input,
+                                                          vector<LogicalType> &return_types, vector<string> &names) {
+	DefineFreeSpaceColumns(return_types, names);
+	return make_uniq<InspectFreeSpaceBindData>(input.inputs[0].GetValue<string>());
+}
+
+// inspect_free_space() — uses current database
+unique_ptr<FunctionData> InspectFreeSpaceBindCurrentDB(ClientContext &context, TableFunctionBindInput &input,
+                                                       vector<LogicalType> &return_types, vector<string> &names) {
+	DefineFreeSpaceColumns(return_types, names);
+	// INVALID_CATALOG retrieves the currently active catalog
+	return make_uniq<InspectFreeSpaceBindData>(INVALID_CATALOG);
+}
+
+unique_ptr<GlobalTableFunctionState> InspectFreeSpaceInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<InspectFreeSpaceState>();
+	auto &bind_data = input.bind_data->Cast<InspectFreeSpaceBindData>();
+	result->free_space = LoadFreeSpace(context, bind_data.database_name, "inspect_free_space");
+	return std::move(result);
+}
+
+void InspectFreeSpaceExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectFreeSpaceState>();
+	const auto &free_space = state.free_space;
+
+	constexpr idx_t START_BLOCK_IDX = 0;
+	constexpr idx_t BLOCK_COUNT_IDX = 1;
+	constexpr idx_t FILE_OFFSET_IDX = 2;
+	constexpr idx_t SIZE_BYTES_IDX = 3;
+	constexpr idx_t IS_TRAILING_IDX = 4;
+
+	OutputWriter writer(output);
+	while (state.offset < free_space.extents.size() && !writer.IsFull()) {
+		const auto &extent = free_space.extents[state.offset];
+
+		writer.WriteBigint(START_BLOCK_IDX, extent.start_block);
+		writer.WriteBigint(BLOCK_COUNT_IDX, extent.block_count);
+		writer.WriteBigint(FILE_OFFSET_IDX, free_space.file_info.GetBlockLocation(extent.start_block));
+		writer.WriteBigint(SIZE_BYTES_IDX, extent.block_count * free_space.block_alloc_size);
+		writer.Write<bool>(IS_TRAILING_IDX, extent.start_block + extent.block_count == free_space.total_blocks);
+		writer.NextRow();
+
+		state.offset++;
+	}
+
+	writer.Finalize();
+}
+
+//===--------------------------------------------------------------------===//
+// inspect_free_space_summary() - Histogram of free extent sizes
+//===--------------------------------------------------------------------===//
+
+// Extents are grouped by power-of-two length; empty buckets are skipped.
+struct ExtentBucket {
+	idx_t min_blocks;
+	idx_t max_blocks;
+	idx_t extent_count;
+	idx_t block_count;
+	idx_t trailing_blocks;
+};
+
+struct InspectFreeSpaceSummaryState : public GlobalTableFunctionState {
+	InspectFreeSpaceSummaryState() : offset(0) {
+	}
+
+	vector<ExtentBucket> buckets;
+	idx_t total_blocks = 0;
+	idx_t block_alloc_size = 0;
+	idx_t offset;
+};
+
+void DefineFreeSpaceSummaryColumns(vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	names.reserve(7);
+	return_types.reserve(7);
+	names.emplace_back("min_blocks");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("max_blocks");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("extent_count");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("block_count");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("size_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("percentage");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("trailing_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+}
+
+// inspect_free_space_summary(database_name)
+unique_ptr<FunctionData> InspectFreeSpaceSummaryBindWithDatabase(ClientContext &context,
+                                                                 TableFunctionBindInput &input,
+                                                                 vector<LogicalType> &return_types,
+                                                                 vector<string> &names) {
+	DefineFreeSpaceSummaryColumns(return_types, names);
+	return make_uniq<InspectFreeSpaceBindData>(input.inputs[0].GetValue<string>());
+}
+
+// inspect_free_space_summary() — uses current database
+unique_ptr<FunctionData> InspectFreeSpaceSummaryBindCurrentDB(ClientContext &context, TableFunctionBindInput &input,
+                                                              vector<LogicalType> &return_types,
+                                                              vector<string> &names) {
+	DefineFreeSpaceSummaryColumns(return_types, names);
+	// INVALID_CATALOG retrieves the currently active catalog
+	return make_uniq<InspectFreeSpaceBindData>(INVALID_CATALOG);
+}
+
+unique_ptr<GlobalTableFunctionState> InspectFreeSpaceSummaryInit(ClientContext &context,
+                                                                 TableFunctionInitInput &input) {
+	auto result = make_uniq<InspectFreeSpaceSummaryState>();
+	auto &bind_data = input.bind_data->Cast<InspectFreeSpaceBindData>();
+	const auto free_space = LoadFreeSpace(context, bind_data.database_name, "inspect_free_space_summary");
+
+	result->total_blocks = free_space.total_blocks;
+	result->block_alloc_size = free_space.block_alloc_size;
+
+	vector<ExtentBucket> buckets;
+	for (const auto &extent : free_space.extents) {
+		const idx_t bucket_idx = GetExtentSizeBucket(extent.block_count);
+		while (buckets.size() <= bucket_idx) {
+			const idx_t min_blocks = idx_t(1) << buckets.size();
+			buckets.push_back(ExtentBucket {min_blocks, min_blocks * 2 - 1, 0, 0, 0});
+		}
+		auto &bucket = buckets[bucket_idx];
+		bucket.extent_count++;
+		bucket.block_count += extent.block_count;
+		if (extent.start_block + extent.block_count == free_space.total_blocks) {
+			bucket.trailing_blocks += extent.block_count;
+		}
+	}
+	for (auto &bucket : buckets) {
+		if (bucket.extent_count > 0) {
+			result->buckets.push_back(bucket);
+		}
+	}
+
+	return std::move(result);
+}
+
+void InspectFreeSpaceSummaryExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectFreeSpaceSummaryState>();
+
+	constexpr idx_t MIN_BLOCKS_IDX = 0;
+	constexpr idx_t MAX_BLOCKS_IDX = 1;
+	constexpr idx_t EXTENT_COUNT_IDX = 2;
+	constexpr idx_t BLOCK_COUNT_IDX = 3;
+	constexpr idx_t SIZE_BYTES_IDX = 4;
+	constexpr idx_t PERCENTAGE_IDX = 5;
+	constexpr idx_t TRAILING_BYTES_IDX = 6;
+
+	OutputWriter writer(output);
+	while (state.offset < state.buckets.size() && !writer.IsFull()) {
+		const auto &bucket = state.buckets[state.offset];
+
+		writer.WriteBigint(MIN_BLOCKS_IDX, bucket.min_blocks);
+		writer.WriteBigint(MAX_BLOCKS_IDX, bucket.max_blocks);
+		writer.WriteBigint(EXTENT_COUNT_IDX, bucket.extent_count);
+		writer.WriteBigint(BLOCK_COUNT_IDX, bucket.block_count);
+		writer.WriteBigint(SIZE_BYTES_IDX, bucket.block_count * state.block_alloc_size);
+		writer.WriteString(PERCENTAGE_IDX, FormatPercentage(bucket.block_count, state.total_blocks));
+		writer.WriteBigint(TRAILING_BYTES_IDX, bucket.trailing_blocks * state.block_alloc_size);
+		writer.NextRow();
+
+		state.offset++;
+	}
+
+	writer.Finalize();
+}
+
+} // namespace
+
+void RegisterInspectFreeSpaceFunction(ExtensionLoader &loader) {
+	// inspect_free_space(database_name)
+	TableFunction inspect_free_space_with_db("inspect_free_space", {LogicalType {LogicalTypeId::VARCHAR}},
+	                                         InspectFreeSpaceExecute, InspectFreeSpaceBindWithDatabase,
+	                                         InspectFreeSpaceInit);
+	loader.RegisterFunction(std::move(inspect_free_space_with_db));
+
+	// inspect_free_space() — uses current database
+	TableFunction inspect_free_space_current_db("inspect_free_space", {}, InspectFreeSpaceExecute,
+	                                            InspectFreeSpaceBindCurrentDB, InspectFreeSpaceInit);
+	loader.RegisterFunction(std::move(inspect_free_space_current_db));
+}
+
+void RegisterInspectFreeSpaceSummaryFunction(ExtensionLoader &loader) {
+	// inspect_free_space_summary(database_name)
+	TableFunction inspect_free_space_summary_with_db(
+	    "inspect_free_space_summary", {LogicalType {LogicalTypeId::VARCHAR}}, InspectFreeSpaceSummaryExecute,
+	    InspectFreeSpaceSummaryBindWithDatabase, InspectFreeSpaceSummaryInit);
+	loader.RegisterFunction(std::move(inspect_free_space_summary_with_db));
+
+	// inspect_free_space_summary() — uses current database
+	TableFunction inspect_free_space_summary_current_db("inspect_free_space_summary", {},
+	                                                    InspectFreeSpaceSummaryExecute,
+	                                                    InspectFreeSpaceSummaryBindCurrentDB,
+	                                                    InspectFreeSpaceSummaryInit);
+	loader.RegisterFunction(std::move(inspect_free_space_summary_current_db));
+}
+
+} // namespace duckdb
@@ -0,0 +1,215 @@
+#include "inspect_index.hpp"
+#include "index_storage.hpp"
+#include "output_writer.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/common/assert.hpp"
+#include "duckdb/execution/index/fixed_size_allocator.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/attached_database.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "duckdb/planner/binder.hpp"
+#include "duckdb/storage/block_manager.hpp"
+#include "duckdb/storage/index_storage_info.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// inspect_index(table_name) - Per-index, per-node-type ART storage
+//===--------------------------------------------------------------------===//
+
+// Reports one row per ART allocator of every index on a table. Each allocator holds one node type in fixed-size
+// segments packed into buffers of one block each, so:
+// - allocated_bytes = buffer_count * buffer size
+// - used_bytes = segment_count * segment_size
+// - fill_ratio = used_bytes / allocated_bytes, low values point at a fragmented allocator
+// in_memory_bytes is what the buffer manager holds for the allocator right now (0 for indexes not loaded yet),
+// on_disk_bytes is what the last checkpoint wrote.
+
+struct IndexAllocatorRow {
+	string index_name;
+	string allocator;
+	bool is_loaded;
+	idx_t segment_size;
+	idx_t buffer_count;
+	idx_t segment_count;
+	idx_t allocated_bytes;
+	idx_t used_bytes;
+	idx_t in_memory_bytes;
+	idx_t on_disk_bytes;
+};
+
+struct InspectIndexBindData : public TableFunctionData {
+	explicit InspectIndexBindData(TableCatalogEntry &table_entry_p) : table_entry(table_entry_p) {
+	}
+
+	TableCatalogEntry &table_entry;
+};
+
+struct InspectIndexState : public GlobalTableFunctionState {
+	InspectIndexState() : offset(0) {
+	}
+
+	vector<IndexAllocatorRow> rows;
+	idx_t offset;
+};
+
+// Shared bind logic for all inspect_index overloads
+unique_ptr<FunctionData> InspectIndexBindInternal(ClientContext &context, const string &database_name,
+                                                  const string &table_name_str, vector<LogicalType> &return_types,
+                                                  vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	// Define output columns
+	names.reserve(11);
+	return_types.reserve(11);
+	names.emplace_back("index_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("allocator");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("is_loaded");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BOOLEAN});
+	names.emplace_back("segment_size");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("buffer_count");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("segment_count");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("allocated_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("used_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("fill_ratio");
+	return_types.emplace_back(LogicalType {LogicalTypeId::DOUBLE});
+	names.emplace_back("in_memory_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("on_disk_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	// Parse table name (handles schema.table format)
+	auto qname = QualifiedName::Parse(table_name_str);
+	Binder::BindSchemaOrCatalog(context, qname.catalog, qname.schema);
+
+	auto &catalog_entry = Catalog::GetEntry(context, CatalogType::TABLE_ENTRY, database_name, qname.schema, qname.name);
+	return make_uniq<InspectIndexBindData>(catalog_entry.Cast<TableCatalogEntry>());
+}
+
+// inspect_index(database_name, table_name)
+unique_ptr<FunctionData> InspectIndexBindWithDatabase(ClientContext &context, TableFunctionBindInput &input,
+                                                      vector<LogicalType> &return_types, vector<string> &names) {
+	const auto database_name = input.inputs[0].GetValue<string>();
+	const auto table_name_str = input.inputs[1].GetValue<string>();
+	return InspectIndexBindInternal(context, database_name, table_name_str, return_types, names);
+}
+
+// inspect_index(table_name) — uses current database
+unique_ptr<FunctionData> InspectIndexBindCurrentDB(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+	const auto table_name_str = input.inputs[0].GetValue<string>();
+	return InspectIndexBindInternal(context, INVALID_CATALOG, table_name_str, return_types, names);
+}
+
+unique_ptr<GlobalTableFunctionState> InspectIndexInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<InspectIndexState>();
+
+	auto &bind_data = input.bind_data->Cast<InspectIndexBindData>();
+	auto &table = bind_data.table_entry;
+
+	// Allocator buffers are one block of the table's block manager
+	auto &block_manager = table.ParentCatalog().GetAttached().GetStorageManager().GetBlockManager();
+	const idx_t buffer_size = block_manager.GetBlockSize();
+
+	ForEachIndexAllocator(table, [&](const IndexAllocator &allocator) {
+		const auto &info = allocator.info;
+
+		IndexAllocatorRow row;
+		row.index_name = allocator.index_name;
+		row.allocator = GetIndexAllocatorName(allocator.allocator_idx);
+		row.is_loaded = allocator.allocator != nullptr;
+		row.segment_size = info.segment_size;
+		row.buffer_count = info.buffer_ids.size();
+		row.segment_count = 0;
+		for (const auto &segment_count : info.segment_counts) {
+			row.segment_count += segment_count;
+		}
+		row.allocated_bytes = row.buffer_count * buffer_size;
+		row.used_bytes = row.segment_count * row.segment_size;
+		row.in_memory_bytes = allocator.allocator ? allocator.allocator->GetInMemorySize() : 0;
+		row.on_disk_bytes = 0;
+		for (idx_t buffer_idx = 0; buffer_idx < info.allocation_sizes.size(); ++buffer_idx) {
+			// Buffers created since the last checkpoint are not on disk yet
+			if (buffer_idx < info.block_pointers.size() && info.block_pointers[buffer_idx].IsValid()) {
+				row.on_disk_bytes += info.allocation_sizes[buffer_idx];
+			}
+		}
+		result->rows.push_back(std::move(row));
+	});
+
+	return std::move(result);
+}
+
+void InspectIndexExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectIndexState>();
+
+	constexpr idx_t INDEX_NAME_IDX = 0;
+	constexpr idx_t ALLOCATOR_IDX = 1;
+	constexpr idx_t IS_LOADED_IDX = 2;
+	constexpr idx_t SEGMENT_SIZE_IDX = 3;
+	constexpr idx_t BUFFER_COUNT_IDX = 4;
+	constexpr idx_t SEGMENT_COUNT_IDX = 5;
+	constexpr idx_t ALLOCATED_BYTES_IDX = 6;
+	constexpr idx_t USED_BYTES_IDX = 7;
+	constexpr idx_t FILL_RATIO_IDX = 8;
+	constexpr idx_t IN_MEMORY_BYTES_IDX = 9;
+	constexpr idx_t ON_DISK_BYTES_IDX = 10;
+
+	OutputWriter writer(output);
+	while (state.offset < state.rows.size() && !writer.IsFull()) {
+		const auto &row = state.rows[state.offset];
+
+		writer.WriteString(INDEX_NAME_IDX, row.index_name);
+		writer.WriteString(ALLOCATOR_IDX, row.allocator);
+		writer.Write<bool>(IS_LOADED_IDX, row.is_loaded);
+		writer.WriteBigint(SEGMENT_SIZE_IDX, row.segment_size);
+		writer.WriteBigint(BUFFER_COUNT_IDX, row.buffer_count);
+		writer.WriteBigint(SEGMENT_COUNT_IDX, row.segment_count);
+		writer.WriteBigint(ALLOCATED_BYTES_IDX, row.allocated_bytes);
+		writer.WriteBigint(USED_BYTES_IDX, row.used_bytes);
+		if (row.allocated_bytes == 0) {
+			writer.WriteNull(FILL_RATIO_IDX);
+		} else {
+			writer.Write<double>(FILL_RATIO_IDX,
+			                     static_cast<double>(row.used_bytes) / static_cast<double>(row.allocated_bytes));
+		}
+		writer.WriteBigint(IN_MEMORY_BYTES_IDX, row.in_memory_bytes);
+		writer.WriteBigint(ON_DISK_BYTES_IDX, row.on_disk_bytes);
+		writer.NextRow();
+
+		state.offset++;
+	}
+
+	writer.Finalize();
+}
+
+} // namespace
+
+void RegisterInspectIndexFunction(ExtensionLoader &loader) {
+	// inspect_index(database_name, table_name)
+	TableFunction inspect_index_with_db("inspect_index",
+	                                    {LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::VARCHAR}},
+	                                    InspectIndexExecute, InspectIndexBindWithDatabase, InspectIndexInit);
+	loader.RegisterFunction(std::move(inspect_index_with_db));
+
+	// inspect_index(table_name) — uses current database
+	TableFunction inspect_index_current_db("inspect_index", {LogicalType {LogicalTypeId::VARCHAR}},
+	                                       InspectIndexExecute, InspectIndexBindCurrentDB, InspectIndexInit);
+	loader.RegisterFunction(std::move(inspect_index_current_db));
+}
+
+} // namespace duckdb
@@ -0,0 +1,94 @@
+#include "inspect_last_profile.hpp"
+#include "inspection_profile.hpp"
+#include "output_writer.hpp"
+
+#include "duckdb/common/assert.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// inspect_last_profile() - Profile of the last profiled inspection
+//===--------------------------------------------------------------------===//
+
+// Reports the profile of the last inspection this connection ran with `profile := true`, one row per metric: the
+// wall time, the time of every phase summed across threads, and the counters. Without a profiled inspection the
+// result is empty.
+
+struct InspectLastProfileData : public GlobalTableFunctionState {
+	InspectLastProfileData() : offset(0) {
+	}
+
+	shared_ptr<InspectionProfile> profile;
+	vector<InspectionProfile::Metric> metrics;
+	idx_t offset;
+};
+
+unique_ptr<FunctionData> InspectLastProfileBind(ClientContext &context, TableFunctionBindInput &input,
+                                                vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	names.reserve(5);
+	return_types.reserve(5);
+	names.emplace_back("function_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("database_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("metric");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("value");
+	return_types.emplace_back(LogicalType {LogicalTypeId::DOUBLE});
+	names.emplace_back("unit");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	return nullptr;
+}
+
+unique_ptr<GlobalTableFunctionState> InspectLastProfileInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<InspectLastProfileData>();
+	result->profile = LastInspectionProfile::Get(context)->GetProfile();
+	if (result->profile) {
+		result->metrics = result->profile->GetMetrics();
+	}
+	return std::move(result);
+}
+
+void InspectLastProfileExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectLastProfileData>();
+
+	constexpr idx_t FUNCTION_NAME_IDX = 0;
+	constexpr idx_t DATABASE_NAME_IDX = 1;
+	constexpr idx_t METRIC_IDX = 2;
+	constexpr idx_t VALUE_IDX = 3;
+	constexpr idx_t UNIT_IDX = 4;
+
+	OutputWriter writer(output);
+	while (state.offset < state.metrics.size() && !writer.IsFull()) {
+		const auto &metric = state.metrics[state.offset];
+
+		writer.WriteString(FUNCTION_NAME_IDX, state.profile->GetFunctionName());
+		writer.WriteString(DATABASE_NAME_IDX, state.profile->GetDatabaseName());
+		writer.WriteString(METRIC_IDX, metric.name);
+		writer.Write<double>(VALUE_IDX, metric.value);
+		writer.WriteString(UNIT_IDX, string_t(metric.unit));
+		writer.NextRow();
+
+		state.offset++;
+	}
+
+	writer.Finalize();
+}
+
+} // namespace
+
+void RegisterInspectLastProfileFunction(ExtensionLoader &loader) {
+	TableFunction inspect_last_profile_func("inspect_last_profile", {}, InspectLastProfileExecute,
+	                                        InspectLastProfileBind, InspectLastProfileInit);
+	loader.RegisterFunction(std::move(inspect_last_profile_func));
+}
+
+} // namespace duckdb
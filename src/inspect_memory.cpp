@@ -0,0 +1,265 @@
+#include "inspect_memory.hpp"
+#include "inspection_deadline.hpp"
+#include "output_writer.hpp"
+#include "segment_snapshot.hpp"
+#include "util.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/catalog/default/default_schemas.hpp"
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/attached_database.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/storage/block_manager.hpp"
+#include "duckdb/storage/buffer/block_handle.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/storage/table_storage_info.hpp"
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// inspect_memory() - Buffer pool residency per table and column
+//===--------------------------------------------------------------------===//
+
+// Reports how much of every column's checkpointed data the buffer manager holds right now, to compare the working
+// set with memory_limit. The blocks of a column's persistent segments are looked up in the block manager:
+// - resident_bytes: bytes of segments whose block is loaded
+// - pinned_bytes: bytes of segments whose block is pinned by a running scan, which can't be evicted
+// Segments sharing a block are each credited with their own bytes within it (see CalculateSegmentSizes), so the
+// rows of a database add up to its resident blocks. Additional blocks of large segments count in full.
+// Transient (not yet checkpointed) segments are always in memory and not reported. Residency changes constantly;
+// the result is a snapshot and never cached.
+
+struct ColumnMemoryRow {
+	string schema_name;
+	string table_name;
+	string column_name;
+	idx_t persisted_bytes = 0;
+	idx_t resident_bytes = 0;
+	idx_t pinned_bytes = 0;
+};
+
+// Buffer state of one persistent block
+struct BlockResidency {
+	bool is_loaded = false;
+	bool is_pinned = false;
+};
+
+// Looks up block states, once per block
+class BlockResidencyCache {
+public:
+	explicit BlockResidencyCache(BlockManager &block_manager_p) : block_manager(block_manager_p) {
+	}
+
+	BlockResidency Get(block_id_t block_id) {
+		auto entry = blocks.find(block_id);
+		if (entry != blocks.end()) {
+			return entry->second;
+		}
+		// Returns the registered handle of a block that is in use, or a fresh unloaded one that is unregistered again
+		// as soon as it goes out of scope
+		auto handle = block_manager.RegisterBlock(block_id);
+		BlockResidency residency;
+		residency.is_loaded = handle->GetState() == BlockState::BLOCK_LOADED;
+		residency.is_pinned = residency.is_loaded && handle->Readers() > 0;
+		blocks.emplace(block_id, residency);
+		return residency;
+	}
+
+private:
+	BlockManager &block_manager;
+	unordered_map<block_id_t, BlockResidency> blocks;
+};
+
+void CollectTableMemory(TableCatalogEntry &table, const vector<ColumnSegmentInfo> &segment_info,
+                        idx_t block_alloc_size, BlockResidencyCache &residency, vector<ColumnMemoryRow> &rows) {
+	// One row per physical column, indexed by physical column id
+	vector<idx_t> row_index;
+	for (auto &col : table.GetColumns().Physical()) {
+		const idx_t physical_id = col.Physical().index;
+		if (physical_id >= row_index.size()) {
+			row_index.resize(physical_id + 1, DConstants::INVALID_INDEX);
+		}
+		row_index[physical_id] = rows.size();
+		ColumnMemoryRow row;
+		row.schema_name = table.schema.name;
+		row.table_name = table.name;
+		row.column_name = col.Name();
+		rows.push_back(std::move(row));
+	}
+
+	const auto segment_sizes = CalculateSegmentSizes(segment_info, block_alloc_size);
+	for (idx_t segment_idx = 0; segment_idx < segment_info.size(); ++segment_idx) {
+		const auto &seg = segment_info[segment_idx];
+		if (seg.column_id >= row_index.size() || row_index[seg.column_id] == DConstants::INVALID_INDEX) {
+			continue;
+		}
+		auto &row = rows[row_index[seg.column_id]];
+
+		const auto add_block = [&](block_id_t block_id, idx_t bytes) {
+			row.persisted_bytes += bytes;
+			const auto block = residency.Get(block_id);
+			if (block.is_loaded) {
+				row.resident_bytes += bytes;
+			}
+			if (block.is_pinned) {
+				row.pinned_bytes += bytes;
+			}
+		};
+		add_block(seg.block_id, segment_sizes[segment_idx]);
+		for (const auto block_id : seg.additional_blocks) {
+			add_block(block_id, block_alloc_size);
+		}
+	}
+}
+
+struct InspectMemoryBindData : public TableFunctionData {
+	explicit InspectMemoryBindData(string database_name_p) : database_name(std::move(database_name_p)) {
+	}
+
+	string database_name;
+};
+
+struct InspectMemoryState : public GlobalTableFunctionState {
+	InspectMemoryState() : offset(0) {
+	}
+
+	vector<ColumnMemoryRow> rows;
+	idx_t offset;
+};
+
+// Shared bind logic for all inspect_memory overloads
+unique_ptr<FunctionData> InspectMemoryBindInternal(const string &database_name, vector<LogicalType> &return_types,
+                                                   vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	names.reserve(7);
+	return_types.reserve(7);
+	names.emplace_back("schema_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("table_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("column_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("persisted_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("resident_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("pinned_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("resident_percentage");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	return make_uniq<InspectMemoryBindData>(database_name);
+}
+
+// inspect_memory(database_name)
+unique_ptr<FunctionData> InspectMemoryBindWithDatabase(ClientContext &context, TableFunctionBindInput &input,
+                                                       vector<LogicalType> &return_types, vector<string> &names) {
+	return InspectMemoryBindInternal(input.inputs[0].GetValue<string>(), return_types, names);
+}
+
+// inspect_memory() — uses current database
+unique_ptr<FunctionData> InspectMemoryBindCurrentDB(ClientContext &context, TableFunctionBindInput &input,
+                                                    vector<LogicalType> &return_types, vector<string> &names) {
+	// INVALID_CATALOG retrieves the currently active catalog
+	return InspectMemoryBindInternal(INVALID_CATALOG, return_types, names);
+}
+
+unique_ptr<GlobalTableFunctionState> InspectMemoryInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<InspectMemoryState>();
+
+	auto &bind_data = input.bind_data->Cast<InspectMemoryBindData>();
+	auto &catalog = Catalog::GetCatalog(context, bind_data.database_name);
+
+	// Require persistent database
+	if (catalog.InMemory()) {
+		throw InvalidInputException(
+		    "inspect_memory() requires a persistent database file.\n"
+		    "In-memory databases keep all their data in memory, there is no persistent data to page in or out.\n\n"
+		    "Correct usage:\n"
+		    "  1. Open a database file directly:\n"
+		    "     $ duckdb mydata.duckdb\n"
+		    "     D SELECT * FROM inspect_memory();\n\n"
+		    "  2. Or attach a database file:\n"
+		    "     D ATTACH 'mydata.duckdb' AS mydb;\n"
+		    "     D SELECT * FROM inspect_memory('mydb');\n\n");
+	}
+
+	auto &block_manager = catalog.GetAttached().GetStorageManager().GetBlockManager();
+	const idx_t block_alloc_size = block_manager.GetBlockAllocSize();
+	BlockResidencyCache residency(block_manager);
+	auto snapshot = SegmentSnapshot::Get(context, catalog);
+
+	auto schemas = catalog.GetSchemas(context);
+	for (auto &schema_ref : schemas) {
+		auto &schema = schema_ref.get();
+
+		// Skip internal schemas
+		if (DefaultSchemaGenerator::IsDefaultSchema(schema.name)) {
+			continue;
+		}
+
+		schema.Scan(context, CatalogType::TABLE_ENTRY, [&](CatalogEntry &entry) {
+			CheckInterrupted(context);
+			auto &table = entry.Cast<TableCatalogEntry>();
+			const auto segment_info = snapshot->GetTableSegments(context, table);
+			CollectTableMemory(table, *segment_info, block_alloc_size, residency, result->rows);
+		});
+	}
+
+	return std::move(result);
+}
+
+void InspectMemoryExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectMemoryState>();
+
+	constexpr idx_t SCHEMA_NAME_IDX = 0;
+	constexpr idx_t TABLE_NAME_IDX = 1;
+	constexpr idx_t COLUMN_NAME_IDX = 2;
+	constexpr idx_t PERSISTED_BYTES_IDX = 3;
+	constexpr idx_t RESIDENT_BYTES_IDX = 4;
+	constexpr idx_t PINNED_BYTES_IDX = 5;
+	constexpr idx_t RESIDENT_PERCENTAGE_IDX = 6;
+
+	OutputWriter writer(output);
+	while (state.offset < state.rows.size() && !writer.IsFull()) {
+		const auto &row = state.rows[state.offset];
+
+		writer.WriteString(SCHEMA_NAME_IDX, row.schema_name);
+		writer.WriteString(TABLE_NAME_IDX, row.table_name);
+		writer.WriteString(COLUMN_NAME_IDX, row.column_name);
+		writer.WriteBigint(PERSISTED_BYTES_IDX, row.persisted_bytes);
+		writer.WriteBigint(RESIDENT_BYTES_IDX, row.resident_bytes);
+		writer.WriteBigint(PINNED_BYTES_IDX, row.pinned_bytes);
+		writer.WriteString(RESIDENT_PERCENTAGE_IDX, FormatPercentage(row.resident_bytes, row.persisted_bytes));
+		writer.NextRow();
+
+		state.offset++;
+	}
+
+	writer.Finalize();
+}
+
+} // namespace
+
+void RegisterInspectMemoryFunction(ExtensionLoader &loader) {
+	// inspect_memory(database_name)
+	TableFunction inspect_memory_with_db("inspect_memory", {LogicalType {LogicalTypeId::VARCHAR}},
+	                                     InspectMemoryExecute, InspectMemoryBindWithDatabase, InspectMemoryInit);
+	loader.RegisterFunction(std::move(inspect_memory_with_db));
+
+	// inspect_memory() — uses current database
+	TableFunction inspect_memory_current_db("inspect_memory", {}, InspectMemoryExecute, InspectMemoryBindCurrentDB,
+	                                        InspectMemoryInit);
+	loader.RegisterFunction(std::move(inspect_memory_current_db));
+}
+
+} // namespace duckdb
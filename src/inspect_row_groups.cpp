@@ -0,0 +1,468 @@
+#include "inspect_row_groups.hpp"
+#include "output_writer.hpp"
+#include "sampling.hpp"
+#include "segment_snapshot.hpp"
+#include "util.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/common/algorithm.hpp"
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/numeric_utils.hpp"
+#include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/function/partition_stats.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/attached_database.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "duckdb/planner/binder.hpp"
+#include "duckdb/storage/block_manager.hpp"
+#include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/storage_index.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/storage/table/scan_state.hpp"
+#include "duckdb/storage/table_storage_info.hpp"
+#include "duckdb/transaction/duck_transaction.hpp"
+
+#include <cmath>
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// inspect_row_groups() / inspect_row_group_summary() - Row group health
+//===--------------------------------------------------------------------===//
+
+// Small appends and deletes leave row groups that hold far fewer live rows than the table's row group size. Every
+// row group is scanned as a unit, so a table of underfilled row groups costs more row groups (and bytes) per scan
+// than a rewritten copy of it would.
+//
+// Per row group, from the checkpointed segments in the segment snapshot:
+// - row_count: rows stored, deleted ones included: the largest segment count sum of any column's main data
+// - segment_count, compressed_bytes (see CalculateRowGroupSizes) and block_count, the distinct blocks it touches
+// Deleted rows come from the row groups' partition statistics: a row group without version info has an exact count
+// and no deleted rows. The version info of the others (deletes, or appends that were not checkpointed yet) doesn't
+// expose its deleted count, so their deleted_rows is NULL unless `count_deletes := true`, which counts the rows of
+// just these row groups that are visible to the transaction. A row group whose stored rows differ from its
+// partition's count (e.g. appends that were not checkpointed yet, or constant columns only, which have no stored
+// segments) can't be attributed and has NULL deleted_rows.
+
+// Row groups under this fill ratio are reported as underfilled by the summary
+constexpr double UNDERFILLED_FILL_RATIO = 0.5;
+
+struct RowGroupHealth {
+	idx_t row_count = 0;
+	optional_idx deleted_rows;
+	idx_t segment_count = 0;
+	idx_t compressed_bytes = 0;
+	idx_t block_count = 0;
+
+	idx_t LiveRows() const {
+		return row_count - (deleted_rows.IsValid() ? deleted_rows.GetIndex() : 0);
+	}
+};
+
+struct TableRowGroups {
+	vector<RowGroupHealth> row_groups;
+	idx_t row_group_size = 0;
+};
+
+struct InspectRowGroupsBindData : public TableFunctionData {
+	InspectRowGroupsBindData(TableCatalogEntry &table_entry_p, bool count_deletes_p)
+	    : table_entry(table_entry_p), count_deletes(count_deletes_p) {
+	}
+
+	TableCatalogEntry &table_entry;
+	bool count_deletes;
+};
+
+// Counts the rows of a row group that are visible to the transaction
+idx_t CountVisibleRows(ClientContext &context, TableCatalogEntry &table, const PartitionStatistics &partition) {
+	auto &storage = table.GetStorage();
+	auto &transaction = DuckTransaction::Get(context, table.ParentCatalog());
+	vector<StorageIndex> column_ids;
+	column_ids.emplace_back(COLUMN_IDENTIFIER_ROW_ID);
+	TableScanState scan_state;
+	storage.InitializeScanWithOffset(transaction, scan_state, column_ids, partition.row_start,
+	                                 partition.row_start + partition.count);
+	DataChunk chunk;
+	chunk.Initialize(context, {LogicalType::ROW_TYPE});
+
+	idx_t visible_rows = 0;
+	while (true) {
+		CheckInterrupted(context);
+		chunk.Reset();
+		if (!scan_state.table_state.Scan(transaction, chunk) || chunk.size() == 0) {
+			break;
+		}
+		visible_rows += chunk.size();
+	}
+	return visible_rows;
+}
+
+// Fills in the deleted rows of the row groups whose count can be attributed, see above
+void CountDeletedRows(ClientContext &context, TableCatalogEntry &table, bool count_deletes,
+                      vector<RowGroupHealth> &row_groups) {
+	const auto partitions = table.GetStorage().GetPartitionStats(context);
+	const idx_t row_group_count = MinValue<idx_t>(row_groups.size(), partitions.size());
+	for (idx_t row_group_idx = 0; row_group_idx < row_group_count; ++row_group_idx) {
+		auto &row_group = row_groups[row_group_idx];
+		const auto &partition = partitions[row_group_idx];
+		if (partition.count != row_group.row_count) {
+			continue;
+		}
+		if (partition.count_type == CountType::COUNT_EXACT) {
+			row_group.deleted_rows = 0;
+		} else if (count_deletes) {
+			row_group.deleted_rows = row_group.row_count - CountVisibleRows(context, table, partition);
+		}
+	}
+}
+
+TableRowGroups CollectRowGroups(ClientContext &context, TableCatalogEntry &table, bool count_deletes) {
+	TableRowGroups result;
+	result.row_group_size = table.GetStorage().GetRowGroupSize();
+
+	auto &storage_manager = table.ParentCatalog().GetAttached().GetStorageManager();
+	const idx_t block_alloc_size = storage_manager.GetBlockManager().GetBlockAllocSize();
+	auto snapshot = SegmentSnapshot::Get(context, table.ParentCatalog());
+	const auto segments = snapshot->GetTableSegments(context, table);
+	const auto &segment_info = *segments;
+
+	const auto row_group_sizes = CalculateRowGroupSizes(segment_info, block_alloc_size);
+	result.row_groups.resize(row_group_sizes.size());
+
+	// Rows per (row group, column), from the main data segments: their path has no child index, e.g. "[2]"
+	idx_t column_count = 0;
+	for (const auto &seg : segment_info) {
+		column_count = MaxValue<idx_t>(column_count, seg.column_id + 1);
+	}
+	vector<idx_t> column_rows(row_group_sizes.size() * column_count, 0);
+	// Blocks per row group, deduplicated below
+	vector<vector<block_id_t>> row_group_blocks(row_group_sizes.size());
+	for (const auto &seg : segment_info) {
+		auto &row_group = result.row_groups[seg.row_group_index];
+		row_group.segment_count++;
+		if (seg.column_path.find(',') == string::npos) {
+			column_rows[seg.row_group_index * column_count + seg.column_id] += seg.segment_count;
+		}
+		auto &blocks = row_group_blocks[seg.row_group_index];
+		blocks.push_back(seg.block_id);
+		blocks.insert(blocks.end(), seg.additional_blocks.begin(), seg.additional_blocks.end());
+	}
+
+	for (idx_t row_group_idx = 0; row_group_idx < result.row_groups.size(); ++row_group_idx) {
+		auto &row_group = result.row_groups[row_group_idx];
+		row_group.compressed_bytes = row_group_sizes[row_group_idx];
+		for (idx_t column_id = 0; column_id < column_count; ++column_id) {
+			row_group.row_count = MaxValue(row_group.row_count, column_rows[row_group_idx * column_count + column_id]);
+		}
+		auto &blocks = row_group_blocks[row_group_idx];
+		std::sort(blocks.begin(), blocks.end());
+		row_group.block_count = NumericCast<idx_t>(std::unique(blocks.begin(), blocks.end()) - blocks.begin());
+	}
+
+	CountDeletedRows(context, table, count_deletes, result.row_groups);
+	return result;
+}
+
+double FillRatio(const RowGroupHealth &row_group, idx_t row_group_size) {
+	return static_cast<double>(row_group.LiveRows()) / static_cast<double>(row_group_size);
+}
+
+// Shared bind logic: resolves the table, which may be schema-qualified
+TableCatalogEntry &BindRowGroupsTable(ClientContext &context, const string &database_name, const Value &table_name,
+                                      const char *function_name) {
+	if (table_name.IsNull()) {
+		throw InvalidInputException("%s table name must not be NULL", function_name);
+	}
+	auto qname = QualifiedName::Parse(table_name.GetValue<string>());
+	Binder::BindSchemaOrCatalog(context, qname.catalog, qname.schema);
+	auto &catalog_entry = Catalog::GetEntry(context, CatalogType::TABLE_ENTRY, database_name, qname.schema, qname.name);
+	return catalog_entry.Cast<TableCatalogEntry>();
+}
+
+bool CountDeletesParameter(const named_parameter_map_t &named_parameters) {
+	auto entry = named_parameters.find("count_deletes");
+	return entry != named_parameters.end() && !entry->second.IsNull() && entry->second.GetValue<bool>();
+}
+
+//===--------------------------------------------------------------------===//
+// inspect_row_groups() - One row per row group
+//===--------------------------------------------------------------------===//
+
+struct InspectRowGroupsState : public GlobalTableFunctionState {
+	InspectRowGroupsState() : offset(0) {
+	}
+
+	TableRowGroups table;
+	idx_t offset;
+};
+
+void DefineRowGroupsColumns(vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	names.reserve(7);
+	return_types.reserve(7);
+	names.emplace_back("row_group_id");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("row_count");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("deleted_rows");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("fill_ratio");
+	return_types.emplace_back(LogicalType {LogicalTypeId::DOUBLE});
+	names.emplace_back("segment_count");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("compressed_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("block_count");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+}
+
+// inspect_row_groups(database_name, table_name)
+unique_ptr<FunctionData> InspectRowGroupsBindWithDatabase(ClientContext &context, TableFunctionBindInput &input,
+                                                          vector<LogicalType> &return_types, vector<string> &names) {
+	DefineRowGroupsColumns(return_types, names);
+	if (input.inputs[0].IsNull()) {
+		throw InvalidInputException("inspect_row_groups() database name must not be NULL");
+	}
+	auto &table = BindRowGroupsTable(context, input.inputs[0].GetValue<string>(), input.inputs[1],
+	                                 "inspect_row_groups()");
+	return make_uniq<InspectRowGroupsBindData>(table, CountDeletesParameter(input.named_parameters));
+}
+
+// inspect_row_groups(table_name) — uses current database
+unique_ptr<FunctionData> InspectRowGroupsBindCurrentDB(ClientContext &context, TableFunctionBindInput &input,
+                                                       vector<LogicalType> &return_types, vector<string> &names) {
+	DefineRowGroupsColumns(return_types, names);
+	auto &table = BindRowGroupsTable(context, INVALID_CATALOG, input.inputs[0], "inspect_row_groups()");
+	return make_uniq<InspectRowGroupsBindData>(table, CountDeletesParameter(input.named_parameters));
+}
+
+unique_ptr<GlobalTableFunctionState> InspectRowGroupsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<InspectRowGroupsBindData>();
+	auto result = make_uniq<InspectRowGroupsState>();
+	result->table = CollectRowGroups(context, bind_data.table_entry, bind_data.count_deletes);
+	return std::move(result);
+}
+
+void InspectRowGroupsExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectRowGroupsState>();
+	const auto &row_groups = state.table.row_groups;
+
+	constexpr idx_t ROW_GROUP_ID_IDX = 0;
+	constexpr idx_t ROW_COUNT_IDX = 1;
+	constexpr idx_t DELETED_ROWS_IDX = 2;
+	constexpr idx_t FILL_RATIO_IDX = 3;
+	constexpr idx_t SEGMENT_COUNT_IDX = 4;
+	constexpr idx_t COMPRESSED_BYTES_IDX = 5;
+	constexpr idx_t BLOCK_COUNT_IDX = 6;
+
+	OutputWriter writer(output);
+	while (state.offset < row_groups.size() && !writer.IsFull()) {
+		const auto &row_group = row_groups[state.offset];
+
+		writer.WriteBigint(ROW_GROUP_ID_IDX, state.offset);
+		writer.WriteBigint(ROW_COUNT_IDX, row_group.row_count);
+		if (row_group.deleted_rows.IsValid()) {
+			writer.WriteBigint(DELETED_ROWS_IDX, row_group.deleted_rows.GetIndex());
+		} else {
+			writer.WriteNull(DELETED_ROWS_IDX);
+		}
+		writer.Write<double>(FILL_RATIO_IDX, FillRatio(row_group, state.table.row_group_size));
+		writer.WriteBigint(SEGMENT_COUNT_IDX, row_group.segment_count);
+		writer.WriteBigint(COMPRESSED_BYTES_IDX, row_group.compressed_bytes);
+		writer.WriteBigint(BLOCK_COUNT_IDX, row_group.block_count);
+		writer.NextRow();
+
+		state.offset++;
+	}
+
+	writer.Finalize();
+}
+
+//===--------------------------------------------------------------------===//
+// inspect_row_group_summary() - What a rewrite of the table would save
+//===--------------------------------------------------------------------===//
+
+// A rewrite (e.g. CREATE TABLE ... AS SELECT, or an INSERT into a fresh table) packs the live rows into full row
+// groups. Its bytes are estimated row group by row group, assuming a row group's bytes are spread evenly over its
+// rows, so deleted rows free their share of the bytes. Full row groups usually compress at least as well, so the
+// savings are a lower bound for the bytes and exact for the row groups.
+
+struct InspectRowGroupSummaryState : public GlobalTableFunctionState {
+	InspectRowGroupSummaryState() : finished(false) {
+	}
+
+	TableRowGroups table;
+	bool finished;
+};
+
+void DefineRowGroupSummaryColumns(vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	names.reserve(10);
+	return_types.reserve(10);
+	names.emplace_back("row_groups");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("row_count");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("deleted_rows");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("underfilled_row_groups");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("average_fill_ratio");
+	return_types.emplace_back(LogicalType {LogicalTypeId::DOUBLE});
+	names.emplace_back("compressed_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("rewrite_row_groups");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("rewrite_compressed_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("saved_row_groups");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("saved_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+}
+
+// inspect_row_group_summary(database_name, table_name)
+unique_ptr<FunctionData> InspectRowGroupSummaryBindWithDatabase(ClientContext &context,
+                                                                TableFunctionBindInput &input,
+                                                                vector<LogicalType> &return_types,
+                                                                vector<string> &names) {
+	DefineRowGroupSummaryColumns(return_types, names);
+	if (input.inputs[0].IsNull()) {
+		throw InvalidInputException("inspect_row_group_summary() database name must not be NULL");
+	}
+	auto &table = BindRowGroupsTable(context, input.inputs[0].GetValue<string>(), input.inputs[1],
+	                                 "inspect_row_group_summary()");
+	return make_uniq<InspectRowGroupsBindData>(table, CountDeletesParameter(input.named_parameters));
+}
+
+// inspect_row_group_summary(table_name) — uses current database
+unique_ptr<FunctionData> InspectRowGroupSummaryBindCurrentDB(ClientContext &context, TableFunctionBindInput &input,
+                                                             vector<LogicalType> &return_types,
+                                                             vector<string> &names) {
+	DefineRowGroupSummaryColumns(return_types, names);
+	auto &table = BindRowGroupsTable(context, INVALID_CATALOG, input.inputs[0], "inspect_row_group_summary()");
+	return make_uniq<InspectRowGroupsBindData>(table, CountDeletesParameter(input.named_parameters));
+}
+
+unique_ptr<GlobalTableFunctionState> InspectRowGroupSummaryInit(ClientContext &context,
+                                                                TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<InspectRowGroupsBindData>();
+	auto result = make_uniq<InspectRowGroupSummaryState>();
+	result->table = CollectRowGroups(context, bind_data.table_entry, bind_data.count_deletes);
+	return std::move(result);
+}
+
+void InspectRowGroupSummaryExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectRowGroupSummaryState>();
+	if (state.finished) {
+		output.SetCardinality(0);
+		return;
+	}
+	const auto &table = state.table;
+
+	constexpr idx_t ROW_GROUPS_IDX = 0;
+	constexpr idx_t ROW_COUNT_IDX = 1;
+	constexpr idx_t DELETED_ROWS_IDX = 2;
+	constexpr idx_t UNDERFILLED_ROW_GROUPS_IDX = 3;
+	constexpr idx_t AVERAGE_FILL_RATIO_IDX = 4;
+	constexpr idx_t COMPRESSED_BYTES_IDX = 5;
+	constexpr idx_t REWRITE_ROW_GROUPS_IDX = 6;
+	constexpr idx_t REWRITE_COMPRESSED_BYTES_IDX = 7;
+	constexpr idx_t SAVED_ROW_GROUPS_IDX = 8;
+	constexpr idx_t SAVED_BYTES_IDX = 9;
+
+	idx_t row_count = 0;
+	idx_t live_rows = 0;
+	idx_t underfilled_row_groups = 0;
+	idx_t compressed_bytes = 0;
+	double rewrite_bytes = 0;
+	bool has_deleted_rows = true;
+	for (const auto &row_group : table.row_groups) {
+		row_count += row_group.row_count;
+		live_rows += row_group.LiveRows();
+		compressed_bytes += row_group.compressed_bytes;
+		has_deleted_rows = has_deleted_rows && row_group.deleted_rows.IsValid();
+		if (FillRatio(row_group, table.row_group_size) < UNDERFILLED_FILL_RATIO) {
+			underfilled_row_groups++;
+		}
+		if (row_group.row_count > 0) {
+			rewrite_bytes += static_cast<double>(row_group.compressed_bytes) *
+			                 static_cast<double>(row_group.LiveRows()) / static_cast<double>(row_group.row_count);
+		}
+	}
+	const idx_t row_group_count = table.row_groups.size();
+	const idx_t rewrite_row_groups = (live_rows + table.row_group_size - 1) / table.row_group_size;
+	const auto rewrite_compressed_bytes = MinValue<idx_t>(static_cast<idx_t>(std::llround(rewrite_bytes)),
+	                                                      compressed_bytes);
+
+	OutputWriter writer(output);
+	writer.WriteBigint(ROW_GROUPS_IDX, row_group_count);
+	writer.WriteBigint(ROW_COUNT_IDX, row_count);
+	if (has_deleted_rows) {
+		writer.WriteBigint(DELETED_ROWS_IDX, row_count - live_rows);
+	} else {
+		writer.WriteNull(DELETED_ROWS_IDX);
+	}
+	writer.WriteBigint(UNDERFILLED_ROW_GROUPS_IDX, underfilled_row_groups);
+	if (row_group_count > 0) {
+		writer.Write<double>(AVERAGE_FILL_RATIO_IDX,
+		                     static_cast<double>(live_rows) /
+		                         static_cast<double>(row_group_count * table.row_group_size));
+	} else {
+		writer.WriteNull(AVERAGE_FILL_RATIO_IDX);
+	}
+	writer.WriteBigint(COMPRESSED_BYTES_IDX, compressed_bytes);
+	writer.WriteBigint(REWRITE_ROW_GROUPS_IDX, rewrite_row_groups);
+	writer.WriteBigint(REWRITE_COMPRESSED_BYTES_IDX, rewrite_compressed_bytes);
+	writer.WriteBigint(SAVED_ROW_GROUPS_IDX, row_group_count - MinValue(rewrite_row_groups, row_group_count));
+	writer.WriteBigint(SAVED_BYTES_IDX, compressed_bytes - rewrite_compressed_bytes);
+	writer.NextRow();
+	writer.Finalize();
+
+	state.finished = true;
+}
+
+} // namespace
+
+void RegisterInspectRowGroupsFunction(ExtensionLoader &loader) {
+	// inspect_row_groups(database_name, table_name)
+	TableFunction inspect_row_groups_with_db(
+	    "inspect_row_groups", {LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::VARCHAR}},
+	    InspectRowGroupsExecute, InspectRowGroupsBindWithDatabase, InspectRowGroupsInit);
+	inspect_row_groups_with_db.named_parameters["count_deletes"] = LogicalType {LogicalTypeId::BOOLEAN};
+	loader.RegisterFunction(std::move(inspect_row_groups_with_db));
+
+	// inspect_row_groups(table_name) — uses current database
+	TableFunction inspect_row_groups_current_db("inspect_row_groups", {LogicalType {LogicalTypeId::VARCHAR}},
+	                                            InspectRowGroupsExecute, InspectRowGroupsBindCurrentDB,
+	                                            InspectRowGroupsInit);
+	inspect_row_groups_current_db.named_parameters["count_deletes"] = LogicalType {LogicalTypeId::BOOLEAN};
+	loader.RegisterFunction(std::move(inspect_row_groups_current_db));
+}
+
+void RegisterInspectRowGroupSummaryFunction(ExtensionLoader &loader) {
+	// inspect_row_group_summary(database_name, table_name)
+	TableFunction inspect_row_group_summary_with_db(
+	    "inspect_row_group_summary", {LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::VARCHAR}},
+	    InspectRowGroupSummaryExecute, InspectRowGroupSummaryBindWithDatabase, InspectRowGroupSummaryInit);
+	inspect_row_group_summary_with_db.named_parameters["count_deletes"] = LogicalType {LogicalTypeId::BOOLEAN};
+	loader.RegisterFunction(std::move(inspect_row_group_summary_with_db));
+
+	// inspect_row_group_summary(table_name) — uses current database
+	TableFunction inspect_row_group_summary_current_db(
+	    "inspect_row_group_summary", {LogicalType {LogicalTypeId::VARCHAR}}, InspectRowGroupSummaryExecute,
+	    InspectRowGroupSummaryBindCurrentDB, InspectRowGroupSummaryInit);
+	inspect_row_group_summary_current_db.named_parameters["count_deletes"] = LogicalType {LogicalTypeId::BOOLEAN};
+	loader.RegisterFunction(std::move(inspect_row_group_summary_current_db));
+}
+
+} // namespace duckdb
@@ -0,0 +1,378 @@
+#include "inspect_scan_cost.hpp"
+#include "output_writer.hpp"
+#include "sampling.hpp"
+#include "segment_snapshot.hpp"
+#include "util.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/attached_database.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/parser/qualified_name.hpp"
+#include "duckdb/planner/binder.hpp"
+#include "duckdb/storage/block_manager.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/storage/table_storage_info.hpp"
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// inspect_scan_cost(table, column, predicate_min, predicate_max) - Zonemap pruning estimate
+//===--------------------------------------------------------------------===//
+
+// Estimates what a scan with `column BETWEEN predicate_min AND predicate_max` reads, from the min/max statistics of
+// the column's checkpointed segments. A NULL bound leaves that side open. The scan skips:
+// - every row group whose bounds (over all its segments of the column) don't overlap the range, including the
+//   segments of all other columns in it
+// - within the scanned row groups, segments of the column whose own bounds don't overlap the range
+// Segments without usable bounds (e.g. unparsable or ambiguous statistics) are assumed to be read. String bounds are
+// prefixes of the actual values, which the comparison accounts for. Data that wasn't checkpointed yet is always scanned
+// and not included.
+
+struct InspectScanCostBindData : public TableFunctionData {
+	InspectScanCostBindData(TableCatalogEntry &table_entry_p, string column_name_p, LogicalType column_type_p,
+	                        idx_t physical_id_p, Value predicate_min_p, Value predicate_max_p)
+	    : table_entry(table_entry_p), column_name(std::move(column_name_p)), column_type(std::move(column_type_p)),
+	      physical_id(physical_id_p), predicate_min(std::move(predicate_min_p)),
+	      predicate_max(std::move(predicate_max_p)) {
+	}
+
+	TableCatalogEntry &table_entry;
+	string column_name;
+	LogicalType column_type;
+	idx_t physical_id;
+	// Cast to the column type, NULL for an open bound
+	Value predicate_min;
+	Value predicate_max;
+};
+
+// Bounds of a segment or row group, in the column type
+struct ValueRange {
+	bool has_bounds = false;
+	Value min;
+	Value max;
+
+	void Union(const ValueRange &other) {
+		if (!has_bounds) {
+			*this = other;
+			return;
+		}
+		if (other.min < min) {
+			min = other.min;
+		}
+		// String max values are prefixes of different lengths. The union max is cut to the shortest one, so it doesn't
+		// rule out values that the max of either part allows.
+		const bool is_string = max.type().id() == LogicalTypeId::VARCHAR;
+		const idx_t prefix_length =
+		    is_string ? MinValue(StringValue::Get(max).size(), StringValue::Get(other.max).size()) : 0;
+		if (other.max > max) {
+			max = other.max;
+		}
+		if (is_string) {
+			max = Value(StringValue::Get(max).substr(0, prefix_length));
+		}
+	}
+};
+
+struct ScanCost {
+	idx_t row_groups = 0;
+	idx_t row_groups_scanned = 0;
+	idx_t segments = 0;
+	idx_t segments_scanned = 0;
+	idx_t column_bytes = 0;
+	idx_t column_bytes_scanned = 0;
+	idx_t table_bytes = 0;
+	idx_t table_bytes_scanned = 0;
+};
+
+// Reads the bounds of a data segment; segments without usable bounds have none
+ValueRange GetSegmentRange(const ColumnSegmentInfo &seg, const LogicalType &type) {
+	ValueRange result;
+	string min_str;
+	string max_str;
+	if (!ParseSegmentMinMax(seg.segment_stats, min_str, max_str)) {
+		return result;
+	}
+	string error;
+	if (!Value(min_str).DefaultTryCastAs(type, result.min, &error) ||
+	    !Value(max_str).DefaultTryCastAs(type, result.max, &error)) {
+		return result;
+	}
+	result.has_bounds = true;
+	return result;
+}
+
+// Whether values in the range can satisfy the predicate
+bool MayMatch(const ValueRange &range, const InspectScanCostBindData &bind_data) {
+	if (!range.has_bounds) {
+		return true;
+	}
+	const bool is_string = bind_data.column_type.id() == LogicalTypeId::VARCHAR;
+	const auto &predicate_min = bind_data.predicate_min;
+	const auto &predicate_max = bind_data.predicate_max;
+	// The actual min starts with the min prefix, so it is never smaller than it
+	if (!predicate_max.IsNull() && predicate_max < range.min) {
+		return false;
+	}
+	if (!predicate_min.IsNull()) {
+		// Values starting with the max prefix can be larger than it; only a larger prefix of the bound of the same
+		// length rules them out. The printed prefix can be much shorter than the stored one (e.g. "z" for "zürich").
+		auto lower_bound = predicate_min;
+		if (is_string) {
+			const auto max_prefix_length = StringValue::Get(range.max).size();
+			lower_bound = Value(StringValue::Get(predicate_min).substr(0, max_prefix_length));
+		}
+		if (range.max < lower_bound) {
+			return false;
+		}
+	}
+	return true;
+}
+
+ScanCost EstimateScanCost(const vector<ColumnSegmentInfo> &segment_info, const InspectScanCostBindData &bind_data,
+                          idx_t block_alloc_size) {
+	ScanCost result;
+	const idx_t row_group_count = CountRowGroups(segment_info);
+	result.row_groups = row_group_count;
+	const auto segment_sizes = CalculateSegmentSizes(segment_info, block_alloc_size);
+	const auto data_path = "[" + std::to_string(bind_data.physical_id) + "]";
+
+	// Bounds of every segment of the column, and of every row group
+	vector<ValueRange> segment_ranges(segment_info.size());
+	vector<ValueRange> row_group_ranges(row_group_count);
+	vector<bool> row_group_has_unknown(row_group_count, false);
+	for (idx_t segment_idx = 0; segment_idx < segment_info.size(); ++segment_idx) {
+		const auto &seg = segment_info[segment_idx];
+		if (seg.column_id != bind_data.physical_id || seg.column_path != data_path) {
+			continue;
+		}
+		segment_ranges[segment_idx] = GetSegmentRange(seg, bind_data.column_type);
+		if (!segment_ranges[segment_idx].has_bounds) {
+			row_group_has_unknown[seg.row_group_index] = true;
+			continue;
+		}
+		row_group_ranges[seg.row_group_index].Union(segment_ranges[segment_idx]);
+	}
+
+	vector<bool> row_group_scanned(row_group_count);
+	for (idx_t row_group_idx = 0; row_group_idx < row_group_count; ++row_group_idx) {
+		row_group_scanned[row_group_idx] =
+		    row_group_has_unknown[row_group_idx] || MayMatch(row_group_ranges[row_group_idx], bind_data);
+		if (row_group_scanned[row_group_idx]) {
+			result.row_groups_scanned++;
+		}
+	}
+
+	for (idx_t segment_idx = 0; segment_idx < segment_info.size(); ++segment_idx) {
+		const auto &seg = segment_info[segment_idx];
+		const idx_t bytes = segment_sizes[segment_idx] + seg.additional_blocks.size() * block_alloc_size;
+		const bool in_scanned_row_group = row_group_scanned[seg.row_group_index];
+		result.table_bytes += bytes;
+		if (in_scanned_row_group) {
+			result.table_bytes_scanned += bytes;
+		}
+		if (seg.column_id != bind_data.physical_id) {
+			continue;
+		}
+
+		// Validity and child segments are read along with the data segments of a scanned row group
+		const bool is_data_segment = seg.column_path == data_path;
+		const bool scanned =
+		    in_scanned_row_group && (!is_data_segment || MayMatch(segment_ranges[segment_idx], bind_data));
+		result.column_bytes += bytes;
+		if (is_data_segment) {
+			result.segments++;
+		}
+		if (scanned) {
+			result.column_bytes_scanned += bytes;
+			if (is_data_segment) {
+				result.segments_scanned++;
+			}
+		}
+	}
+	return result;
+}
+
+struct InspectScanCostState : public GlobalTableFunctionState {
+	InspectScanCostState() : finished(false) {
+	}
+
+	ScanCost cost;
+	bool finished;
+};
+
+// Shared bind logic for all inspect_scan_cost overloads
+unique_ptr<FunctionData> InspectScanCostBindInternal(ClientContext &context, const string &database_name,
+                                                     const vector<Value> &inputs, vector<LogicalType> &return_types,
+                                                     vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+	D_ASSERT(inputs.size() == 4);
+
+	names.reserve(11);
+	return_types.reserve(11);
+	names.emplace_back("row_groups");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("row_groups_scanned");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("row_groups_skipped");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("segments");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("segments_scanned");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("column_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("column_bytes_scanned");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("column_bytes_skipped");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("table_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("table_bytes_scanned");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("skipped_percentage");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+
+	if (inputs[0].IsNull() || inputs[1].IsNull()) {
+		throw InvalidInputException("inspect_scan_cost() table and column names must not be NULL");
+	}
+	const auto table_name_str = inputs[0].GetValue<string>();
+	const auto column_name = inputs[1].GetValue<string>();
+
+	// Parse table name (handles schema.table format)
+	auto qname = QualifiedName::Parse(table_name_str);
+	Binder::BindSchemaOrCatalog(context, qname.catalog, qname.schema);
+
+	auto &catalog_entry = Catalog::GetEntry(context, CatalogType::TABLE_ENTRY, database_name, qname.schema, qname.name);
+	auto &table_entry = catalog_entry.Cast<TableCatalogEntry>();
+
+	auto &columns = table_entry.GetColumns();
+	if (!columns.ColumnExists(column_name)) {
+		throw InvalidInputException("Column '%s' not found in table '%s'", column_name, table_entry.name);
+	}
+	const auto &col = columns.GetColumn(column_name);
+	if (col.Generated()) {
+		throw InvalidInputException("Column '%s' in table '%s' is a generated column and has no storage", column_name,
+		                            table_entry.name);
+	}
+	if (col.Type().IsNested()) {
+		throw InvalidInputException("inspect_scan_cost() requires a column with min/max statistics, '%s' is %s",
+		                            column_name, col.Type().ToString());
+	}
+
+	// Bounds are compared in the column type
+	auto cast_bound = [&](const Value &bound, const char *bound_name) {
+		Value result;
+		string error;
+		if (!bound.DefaultTryCastAs(col.Type(), result, &error)) {
+			throw InvalidInputException("inspect_scan_cost() %s %s can't be cast to %s", bound_name, bound.ToString(),
+			                            col.Type().ToString());
+		}
+		return result;
+	};
+	auto predicate_min = cast_bound(inputs[2], "predicate_min");
+	auto predicate_max = cast_bound(inputs[3], "predicate_max");
+
+	return make_uniq<InspectScanCostBindData>(table_entry, col.Name(), col.Type(), col.Physical().index,
+	                                          std::move(predicate_min), std::move(predicate_max));
+}
+
+// inspect_scan_cost(database_name, table_name, column_name, predicate_min, predicate_max)
+unique_ptr<FunctionData> InspectScanCostBindWithDatabase(ClientContext &context, TableFunctionBindInput &input,
+                                                         vector<LogicalType> &return_types, vector<string> &names) {
+	if (input.inputs[0].IsNull()) {
+		throw InvalidInputException("inspect_scan_cost() database name must not be NULL");
+	}
+	const auto database_name = input.inputs[0].GetValue<string>();
+	const vector<Value> inputs(input.inputs.begin() + 1, input.inputs.end());
+	return InspectScanCostBindInternal(context, database_name, inputs, return_types, names);
+}
+
+// inspect_scan_cost(table_name, column_name, predicate_min, predicate_max) — uses current database
+unique_ptr<FunctionData> InspectScanCostBindCurrentDB(ClientContext &context, TableFunctionBindInput &input,
+                                                      vector<LogicalType> &return_types, vector<string> &names) {
+	return InspectScanCostBindInternal(context, INVALID_CATALOG, input.inputs, return_types, names);
+}
+
+unique_ptr<GlobalTableFunctionState> InspectScanCostInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<InspectScanCostBindData>();
+	auto result = make_uniq<InspectScanCostState>();
+
+	auto &table_entry = bind_data.table_entry;
+	auto &storage_manager = table_entry.ParentCatalog().GetAttached().GetStorageManager();
+	const idx_t block_alloc_size = storage_manager.GetBlockManager().GetBlockAllocSize();
+
+	auto snapshot = SegmentSnapshot::Get(context, table_entry.ParentCatalog());
+	const auto segments = snapshot->GetTableSegments(context, table_entry);
+	result->cost = EstimateScanCost(*segments, bind_data, block_alloc_size);
+
+	return std::move(result);
+}
+
+void InspectScanCostExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectScanCostState>();
+	if (state.finished) {
+		output.SetCardinality(0);
+		return;
+	}
+	const auto &cost = state.cost;
+
+	constexpr idx_t ROW_GROUPS_IDX = 0;
+	constexpr idx_t ROW_GROUPS_SCANNED_IDX = 1;
+	constexpr idx_t ROW_GROUPS_SKIPPED_IDX = 2;
+	constexpr idx_t SEGMENTS_IDX = 3;
+	constexpr idx_t SEGMENTS_SCANNED_IDX = 4;
+	constexpr idx_t COLUMN_BYTES_IDX = 5;
+	constexpr idx_t COLUMN_BYTES_SCANNED_IDX = 6;
+	constexpr idx_t COLUMN_BYTES_SKIPPED_IDX = 7;
+	constexpr idx_t TABLE_BYTES_IDX = 8;
+	constexpr idx_t TABLE_BYTES_SCANNED_IDX = 9;
+	constexpr idx_t SKIPPED_PERCENTAGE_IDX = 10;
+
+	OutputWriter writer(output);
+	writer.WriteBigint(ROW_GROUPS_IDX, cost.row_groups);
+	writer.WriteBigint(ROW_GROUPS_SCANNED_IDX, cost.row_groups_scanned);
+	writer.WriteBigint(ROW_GROUPS_SKIPPED_IDX, cost.row_groups - cost.row_groups_scanned);
+	writer.WriteBigint(SEGMENTS_IDX, cost.segments);
+	writer.WriteBigint(SEGMENTS_SCANNED_IDX, cost.segments_scanned);
+	writer.WriteBigint(COLUMN_BYTES_IDX, cost.column_bytes);
+	writer.WriteBigint(COLUMN_BYTES_SCANNED_IDX, cost.column_bytes_scanned);
+	writer.WriteBigint(COLUMN_BYTES_SKIPPED_IDX, cost.column_bytes - cost.column_bytes_scanned);
+	writer.WriteBigint(TABLE_BYTES_IDX, cost.table_bytes);
+	writer.WriteBigint(TABLE_BYTES_SCANNED_IDX, cost.table_bytes_scanned);
+	writer.WriteString(SKIPPED_PERCENTAGE_IDX,
+	                   FormatPercentage(cost.column_bytes - cost.column_bytes_scanned, cost.column_bytes));
+	writer.NextRow();
+	writer.Finalize();
+
+	state.finished = true;
+}
+
+} // namespace
+
+void RegisterInspectScanCostFunction(ExtensionLoader &loader) {
+	// inspect_scan_cost(database_name, table_name, column_name, predicate_min, predicate_max)
+	TableFunction inspect_scan_cost_with_db(
+	    "inspect_scan_cost",
+	    {LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::VARCHAR},
+	     LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::ANY}, LogicalType {LogicalTypeId::ANY}},
+	    InspectScanCostExecute, InspectScanCostBindWithDatabase, InspectScanCostInit);
+	loader.RegisterFunction(std::move(inspect_scan_cost_with_db));
+
+	// inspect_scan_cost(table_name, column_name, predicate_min, predicate_max) — uses current database
+	TableFunction inspect_scan_cost_current_db(
+	    "inspect_scan_cost",
+	    {LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::ANY},
+	     LogicalType {LogicalTypeId::ANY}},
+	    InspectScanCostExecute, InspectScanCostBindCurrentDB, InspectScanCostInit);
+	loader.RegisterFunction(std::move(inspect_scan_cost_current_db));
+}
+
+} // namespace duckdb
@@ -0,0 +1,430 @@
+#include "inspect_snapshot.hpp"
+#include "block_usage.hpp"
+#include "index_storage.hpp"
+#include "inspection_deadline.hpp"
+#include "output_writer.hpp"
+#include "segment_snapshot.hpp"
+#include "util.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/schema_catalog_entry.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/catalog/default/default_schemas.hpp"
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/numeric_utils.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/execution/index/fixed_size_allocator.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/appender.hpp"
+#include "duckdb/main/attached_database.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/connection.hpp"
+#include "duckdb/main/database.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/main/pending_query_result.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+#include "duckdb/parser/parser.hpp"
+#include "duckdb/parser/statement/select_statement.hpp"
+#include "duckdb/parser/tableref/subqueryref.hpp"
+#include "duckdb/storage/block_manager.hpp"
+#include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/index_storage_info.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+
+#include <map>
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// inspect_snapshot() / inspect_diff() - Storage layout snapshots
+//===--------------------------------------------------------------------===//
+
+// A snapshot is one file with one record per table, column, index and block usage component of a database:
+// - snapshot_time, database_name: when and from which attached database the snapshot was taken
+// - record_type: 'table', 'column', 'index' or 'block_usage'
+// - schema_name, table_name: NULL for block usage components
+// - object_name: the column or index name, or the block usage component; NULL for tables
+// - row_count: rows of tables, NULL otherwise
+// - bytes: persisted_data_bytes of inspect_database(), the compressed bytes of the column's segments as in
+//   inspect_compression(), on_disk_bytes of inspect_index() summed per index, and size_bytes of
+//   inspect_block_usage()
+// The records are collected in the caller's transaction, from the same segment snapshot, result cache and settings
+// as the inspections, checking for interruption before every table. A COPY can't run inside a query, so the records
+// of every table are appended to a temporary table of a connection of its own as soon as they're collected, and
+// written by a COPY there once all tables are done, which is interrupted along with the caller's query. Only one
+// table's records are held in memory at a time; the temporary table is buffer-managed and spills to disk. The file
+// format follows the extension of the path.
+
+enum class SnapshotFormat : uint8_t { PARQUET, JSON };
+
+SnapshotFormat GetSnapshotFormat(const string &path, const char *function_name) {
+	const auto lower_path = StringUtil::Lower(path);
+	if (StringUtil::EndsWith(lower_path, ".parquet")) {
+		return SnapshotFormat::PARQUET;
+	}
+	if (StringUtil::EndsWith(lower_path, ".json") || StringUtil::EndsWith(lower_path, ".jsonl") ||
+	    StringUtil::EndsWith(lower_path, ".ndjson")) {
+		return SnapshotFormat::JSON;
+	}
+	throw InvalidInputException("%s snapshot path must end in .parquet, .json, .jsonl or .ndjson, got '%s'",
+	                            function_name, path);
+}
+
+string GetSnapshotPath(const Value &path, const char *function_name) {
+	if (path.IsNull()) {
+		throw InvalidInputException("%s snapshot path must not be NULL", function_name);
+	}
+	return path.GetValue<string>();
+}
+
+string QuoteLiteral(const string &text) {
+	return KeywordHelper::WriteQuoted(text, '\'');
+}
+
+// Table expression that reads a snapshot file, with the snapshot's column types
+string ReadSnapshotSQL(const string &path) {
+	if (GetSnapshotFormat(path, "inspect_diff()") == SnapshotFormat::PARQUET) {
+		return "read_parquet(" + QuoteLiteral(path) + ")";
+	}
+	return "read_json(" + QuoteLiteral(path) +
+	       ", format = 'newline_delimited', columns = {snapshot_time: 'TIMESTAMP', database_name: 'VARCHAR', "
+	       "record_type: 'VARCHAR', schema_name: 'VARCHAR', table_name: 'VARCHAR', object_name: 'VARCHAR', "
+	       "row_count: 'BIGINT', bytes: 'BIGINT'})";
+}
+
+//===--------------------------------------------------------------------===//
+// inspect_snapshot() - Writes a snapshot file
+//===--------------------------------------------------------------------===//
+
+struct InspectSnapshotBindData : public TableFunctionData {
+	InspectSnapshotBindData(string database_name_p, string path_p)
+	    : database_name(std::move(database_name_p)), path(std::move(path_p)) {
+	}
+
+	string database_name;
+	string path;
+};
+
+struct InspectSnapshotState : public GlobalTableFunctionState {
+	InspectSnapshotState() : finished(false) {
+	}
+
+	bool finished;
+};
+
+void DefineSnapshotColumns(vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	names.reserve(4);
+	return_types.reserve(4);
+	names.emplace_back("path");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("database_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("snapshot_time");
+	return_types.emplace_back(LogicalType {LogicalTypeId::TIMESTAMP});
+	names.emplace_back("records");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+}
+
+// Shared bind logic: resolves the database, so the snapshot records the name it is attached under
+unique_ptr<FunctionData> BindSnapshot(ClientContext &context, const string &database_name, const Value &path) {
+	auto snapshot_path = GetSnapshotPath(path, "inspect_snapshot()");
+	GetSnapshotFormat(snapshot_path, "inspect_snapshot()");
+
+	auto &catalog = Catalog::GetCatalog(context, database_name);
+	if (catalog.InMemory()) {
+		throw InvalidInputException(
+		    "inspect_snapshot() requires a persistent database file.\n"
+		    "Snapshots record the checkpointed storage layout of a database file.\n\n"
+		    "Correct usage:\n"
+		    "  1. Open a database file directly:\n"
+		    "     $ duckdb mydata.duckdb\n"
+		    "     D SELECT * FROM inspect_snapshot('layout.parquet');\n\n"
+		    "  2. Or attach a database file:\n"
+		    "     D ATTACH 'mydata.duckdb' AS mydb;\n"
+		    "     D SELECT * FROM inspect_snapshot('mydb', 'layout.parquet');\n\n");
+	}
+	return make_uniq<InspectSnapshotBindData>(catalog.GetName(), std::move(snapshot_path));
+}
+
+// inspect_snapshot(database_name, path)
+unique_ptr<FunctionData> InspectSnapshotBindWithDatabase(ClientContext &context, TableFunctionBindInput &input,
+                                                         vector<LogicalType> &return_types, vector<string> &names) {
+	DefineSnapshotColumns(return_types, names);
+	if (input.inputs[0].IsNull()) {
+		throw InvalidInputException("inspect_snapshot() database name must not be NULL");
+	}
+	return BindSnapshot(context, input.inputs[0].GetValue<string>(), input.inputs[1]);
+}
+
+// inspect_snapshot(path) — uses current database
+unique_ptr<FunctionData> InspectSnapshotBindCurrentDB(ClientContext &context, TableFunctionBindInput &input,
+                                                      vector<LogicalType> &return_types, vector<string> &names) {
+	DefineSnapshotColumns(return_types, names);
+	// INVALID_CATALOG retrieves the currently active catalog
+	return BindSnapshot(context, INVALID_CATALOG, input.inputs[0]);
+}
+
+unique_ptr<GlobalTableFunctionState> InspectSnapshotInit(ClientContext &context, TableFunctionInitInput &input) {
+	return make_uniq<InspectSnapshotState>();
+}
+
+// Runs a statement on the writer connection, interrupting it along with the caller's query
+void RunWriterStatement(ClientContext &context, Connection &connection, const string &query) {
+	auto pending = connection.PendingQuery(query, false);
+	if (pending->HasError()) {
+		pending->ThrowError("inspect_snapshot(): ");
+	}
+	auto execution = PendingExecutionResult::RESULT_NOT_READY;
+	while (!PendingQueryResult::IsResultReady(execution) && execution != PendingExecutionResult::EXECUTION_ERROR) {
+		if (context.interrupted) {
+			connection.Interrupt();
+		}
+		execution = pending->ExecuteTask();
+	}
+	auto result = pending->Execute();
+	CheckInterrupted(context);
+	if (result->HasError()) {
+		result->ThrowError("inspect_snapshot(): ");
+	}
+}
+
+// Appends records to the temporary snapshot_records table of a connection of its own, and copies the table to the
+// snapshot file. Records are flushed after every table, so they're held in the buffer-managed temporary table, which
+// can spill to disk, rather than in memory.
+struct SnapshotRecordWriter {
+	SnapshotRecordWriter(ClientContext &context_p, const string &database_name_p, timestamp_t snapshot_time_p)
+	    : context(context_p), connection(DatabaseInstance::GetDatabase(context_p)),
+	      snapshot_time(Value::TIMESTAMP(snapshot_time_p)), database_name(database_name_p) {
+		RunWriterStatement(context, connection,
+		                   "CREATE TEMPORARY TABLE snapshot_records (snapshot_time TIMESTAMP, database_name VARCHAR, "
+		                   "record_type VARCHAR, schema_name VARCHAR, table_name VARCHAR, object_name VARCHAR, "
+		                   "row_count BIGINT, bytes BIGINT)");
+		appender = make_uniq<Appender>(connection, "snapshot_records");
+	}
+
+	// NULL fields are null values
+	void Append(const char *record_type, const Value &schema_name, const Value &table_name, const Value &object_name,
+	            const Value &row_count, const Value &bytes) {
+		appender->BeginRow();
+		appender->Append(snapshot_time);
+		appender->Append(database_name);
+		appender->Append(Value(record_type));
+		appender->Append(schema_name);
+		appender->Append(table_name);
+		appender->Append(object_name);
+		appender->Append(row_count);
+		appender->Append(bytes);
+		appender->EndRow();
+		record_count++;
+	}
+
+	void Flush() {
+		appender->Flush();
+	}
+
+	// Writes the appended records to the snapshot file
+	void WriteFile(const string &path) {
+		const auto format =
+		    GetSnapshotFormat(path, "inspect_snapshot()") == SnapshotFormat::PARQUET ? "PARQUET" : "JSON";
+		appender->Close();
+		CheckInterrupted(context);
+		RunWriterStatement(context, connection,
+		                   "COPY snapshot_records TO " + QuoteLiteral(path) + " (FORMAT " + format + ")");
+	}
+
+	ClientContext &context;
+	Connection connection;
+	unique_ptr<Appender> appender;
+	const Value snapshot_time;
+	const Value database_name;
+	idx_t record_count = 0;
+};
+
+// Appends the table, column and index records of a table
+void CollectTableRecords(ClientContext &context, SegmentSnapshot &snapshot, TableCatalogEntry &table,
+                         BlockBitmap &blocks, SnapshotRecordWriter &writer) {
+	auto &block_manager = table.ParentCatalog().GetAttached().GetStorageManager().GetBlockManager();
+	const idx_t block_alloc_size = block_manager.GetBlockAllocSize();
+	const auto segments = snapshot.GetTableSegments(context, table);
+	const Value schema_name(table.schema.name);
+	const Value table_name(table.name);
+
+	const auto data_bytes = CountUniqueBlocks(*segments, blocks) * block_alloc_size;
+	writer.Append("table", schema_name, table_name, Value(),
+	              Value::BIGINT(NumericCast<int64_t>(table.GetStorage().GetTotalRows())),
+	              Value::BIGINT(NumericCast<int64_t>(data_bytes)));
+
+	// Segments of nested columns count towards their top-level column
+	vector<string> column_names;
+	for (auto &col : table.GetColumns().Physical()) {
+		const idx_t physical_id = col.Physical().index;
+		if (column_names.size() <= physical_id) {
+			column_names.resize(physical_id + 1);
+		}
+		column_names[physical_id] = col.Name();
+	}
+	vector<idx_t> column_bytes(column_names.size(), 0);
+	const auto segment_sizes = CalculateSegmentSizes(*segments, block_alloc_size);
+	for (idx_t segment_idx = 0; segment_idx < segments->size(); ++segment_idx) {
+		const auto &seg = (*segments)[segment_idx];
+		if (seg.column_id < column_bytes.size()) {
+			column_bytes[seg.column_id] += segment_sizes[segment_idx] + seg.additional_blocks.size() * block_alloc_size;
+		}
+	}
+	for (auto &col : table.GetColumns().Physical()) {
+		const idx_t physical_id = col.Physical().index;
+		writer.Append("column", schema_name, table_name, Value(col.Name()), Value(),
+		              Value::BIGINT(NumericCast<int64_t>(column_bytes[physical_id])));
+	}
+
+	// Bytes the last checkpoint wrote for every index, in name order
+	std::map<string, idx_t> index_bytes;
+	ForEachIndexAllocator(table, [&](const IndexAllocator &allocator) {
+		const auto &info = allocator.info;
+		auto &bytes = index_bytes[allocator.index_name];
+		for (idx_t buffer_idx = 0; buffer_idx < info.allocation_sizes.size(); ++buffer_idx) {
+			if (buffer_idx < info.block_pointers.size() && info.block_pointers[buffer_idx].IsValid()) {
+				bytes += info.allocation_sizes[buffer_idx];
+			}
+		}
+	});
+	for (const auto &index : index_bytes) {
+		writer.Append("index", schema_name, table_name, Value(index.first), Value(),
+		              Value::BIGINT(NumericCast<int64_t>(index.second)));
+	}
+}
+
+void CollectSnapshotRecords(ClientContext &context, Catalog &catalog, SnapshotRecordWriter &writer) {
+	auto snapshot = SegmentSnapshot::Get(context, catalog);
+	BlockBitmap blocks;
+	auto schemas = catalog.GetSchemas(context);
+	for (auto &schema_ref : schemas) {
+		auto &schema = schema_ref.get();
+
+		// Skip internal schemas
+		if (DefaultSchemaGenerator::IsDefaultSchema(schema.name)) {
+			continue;
+		}
+
+		vector<reference<TableCatalogEntry>> tables;
+		schema.Scan(context, CatalogType::TABLE_ENTRY,
+		            [&](CatalogEntry &entry) { tables.emplace_back(entry.Cast<TableCatalogEntry>()); });
+		for (auto &table : tables) {
+			CheckInterrupted(context);
+			CollectTableRecords(context, *snapshot, table.get(), blocks, writer);
+			writer.Flush();
+		}
+	}
+
+	BlockUsageInspection inspection(RowGroupSampling(), InspectionDeadline(), nullptr);
+	shared_ptr<const BlockUsageResult> usage = inspection.Prepare(context, catalog);
+	if (!usage) {
+		usage = inspection.Compute(context);
+	}
+	for (const auto &entry : usage->entries) {
+		writer.Append("block_usage", Value(), Value(), Value(entry.component), Value(),
+		              Value::BIGINT(NumericCast<int64_t>(entry.block_count * usage->block_alloc_size)));
+	}
+}
+
+void InspectSnapshotExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectSnapshotState>();
+	if (state.finished) {
+		output.SetCardinality(0);
+		return;
+	}
+	auto &bind_data = data.bind_data->Cast<InspectSnapshotBindData>();
+
+	constexpr idx_t PATH_IDX = 0;
+	constexpr idx_t DATABASE_NAME_IDX = 1;
+	constexpr idx_t SNAPSHOT_TIME_IDX = 2;
+	constexpr idx_t RECORDS_IDX = 3;
+
+	const auto snapshot_time = Timestamp::GetCurrentTimestamp();
+	auto &catalog = Catalog::GetCatalog(context, bind_data.database_name);
+	SnapshotRecordWriter record_writer(context, bind_data.database_name, snapshot_time);
+	CollectSnapshotRecords(context, catalog, record_writer);
+	record_writer.WriteFile(bind_data.path);
+
+	OutputWriter writer(output);
+	writer.WriteString(PATH_IDX, bind_data.path);
+	writer.WriteString(DATABASE_NAME_IDX, bind_data.database_name);
+	writer.Write<timestamp_t>(SNAPSHOT_TIME_IDX, snapshot_time);
+	writer.WriteBigint(RECORDS_IDX, record_writer.record_count);
+	writer.NextRow();
+	writer.Finalize();
+
+	state.finished = true;
+}
+
+//===--------------------------------------------------------------------===//
+// inspect_diff() - Growth between two snapshot files
+//===--------------------------------------------------------------------===//
+
+// Records of the two snapshots are matched on record type, schema, table and object name, so snapshots of databases
+// attached under different names, or taken on different nodes, compare as well. The function is replaced by a query
+// over both files when it is bound; neither database needs to be attached.
+
+unique_ptr<TableRef> InspectDiffBindReplace(ClientContext &context, TableFunctionBindInput &input) {
+	const auto path_a = GetSnapshotPath(input.inputs[0], "inspect_diff()");
+	const auto path_b = GetSnapshotPath(input.inputs[1], "inspect_diff()");
+
+	const string query =
+	    "SELECT * FROM (SELECT COALESCE(b.record_type, a.record_type) AS record_type, "
+	    "COALESCE(b.schema_name, a.schema_name) AS schema_name, COALESCE(b.table_name, a.table_name) AS table_name, "
+	    "COALESCE(b.object_name, a.object_name) AS object_name, "
+	    "CASE WHEN a.record_type IS NULL THEN 'added' WHEN b.record_type IS NULL THEN 'removed' "
+	    "WHEN a.bytes IS NOT DISTINCT FROM b.bytes AND a.row_count IS NOT DISTINCT FROM b.row_count THEN 'unchanged' "
+	    "ELSE 'changed' END AS status, "
+	    "a.row_count AS row_count_a, b.row_count AS row_count_b, "
+	    "CASE WHEN a.row_count IS NOT NULL OR b.row_count IS NOT NULL "
+	    "THEN (COALESCE(b.row_count, 0) - COALESCE(a.row_count, 0))::BIGINT END AS row_count_growth, "
+	    "a.bytes AS bytes_a, b.bytes AS bytes_b, "
+	    "(COALESCE(b.bytes, 0) - COALESCE(a.bytes, 0))::BIGINT AS bytes_growth, "
+	    "CASE WHEN a.bytes > 0 THEN b.bytes::DOUBLE / a.bytes::DOUBLE END AS growth_ratio "
+	    "FROM " +
+	    ReadSnapshotSQL(path_a) + " a FULL OUTER JOIN " + ReadSnapshotSQL(path_b) +
+	    " b ON a.record_type = b.record_type AND a.schema_name IS NOT DISTINCT FROM b.schema_name "
+	    "AND a.table_name IS NOT DISTINCT FROM b.table_name AND a.object_name IS NOT DISTINCT FROM b.object_name) "
+	    "ORDER BY abs(bytes_growth) DESC, record_type, schema_name, table_name, object_name";
+
+	Parser parser(context.GetParserOptions());
+	parser.ParseQuery(query);
+	D_ASSERT(parser.statements.size() == 1);
+	auto select = unique_ptr_cast<SQLStatement, SelectStatement>(std::move(parser.statements[0]));
+	return make_uniq<SubqueryRef>(std::move(select));
+}
+
+} // namespace
+
+void RegisterInspectSnapshotFunction(ExtensionLoader &loader) {
+	// inspect_snapshot(database_name, path)
+	TableFunction inspect_snapshot_with_db(
+	    "inspect_snapshot", {LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::VARCHAR}},
+	    InspectSnapshotExecute, InspectSnapshotBindWithDatabase, InspectSnapshotInit);
+	loader.RegisterFunction(std::move(inspect_snapshot_with_db));
+
+	// inspect_snapshot(path) — uses current database
+	TableFunction inspect_snapshot_current_db("inspect_snapshot", {LogicalType {LogicalTypeId::VARCHAR}},
+	                                          InspectSnapshotExecute, InspectSnapshotBindCurrentDB,
+	                                          InspectSnapshotInit);
+	loader.RegisterFunction(std::move(inspect_snapshot_current_db));
+}
+
+void RegisterInspectDiffFunction(ExtensionLoader &loader) {
+	// inspect_diff(snapshot_a, snapshot_b)
+	TableFunction inspect_diff_func("inspect_diff",
+	                                {LogicalType {LogicalTypeId::VARCHAR}, LogicalType {LogicalTypeId::VARCHAR}},
+	                                nullptr, nullptr);
+	inspect_diff_func.bind_replace = InspectDiffBindReplace;
+	loader.RegisterFunction(std::move(inspect_diff_func));
+}
+
+} // namespace duckdb
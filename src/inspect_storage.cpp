@@ -1,4 +1,5 @@
 #include "inspect_storage.hpp"
+#include "output_writer.hpp"
 
 #include "duckdb/catalog/catalog.hpp"
 #include "duckdb/common/assert.hpp"
@@ -21,17 +22,12 @@ namespace {
 // databases and reports their .duckdb file size and WAL file size.
 // Both sizes are retrieved from Catalog::GetDatabaseSize().
 
+// Init only selects the databases to report; sizes are read lazily while emitting rows.
 struct InspectStorageData : public GlobalTableFunctionState {
 	InspectStorageData() : offset(0) {
 	}
 
-	struct DatabaseEntry {
-		string database_name;
-		idx_t database_file_size_bytes = 0;
-		idx_t wal_file_size_bytes = 0;
-	};
-
-	vector<DatabaseEntry> entries;
+	vector<shared_ptr<AttachedDatabase>> databases;
 	idx_t offset;
 };
 
@@ -60,14 +56,7 @@ unique_ptr<GlobalTableFunctionState> InspectStorageInit(ClientContext &context,
 		if (db->IsSystem() || db->IsTemporary() || db->GetCatalog().InMemory()) {
 			continue;
 		}
-
-		auto ds = db->GetCatalog().GetDatabaseSize(context);
-
-		InspectStorageData::DatabaseEntry entry;
-		entry.database_name = db->GetName();
-		entry.database_file_size_bytes = static_cast<idx_t>(ds.bytes);
-		entry.wal_file_size_bytes = static_cast<idx_t>(ds.wal_size);
-		result->entries.push_back(std::move(entry));
+		result->databases.push_back(std::move(db));
 	}
 
 	return std::move(result);
@@ -76,25 +65,24 @@ unique_ptr<GlobalTableFunctionState> InspectStorageInit(ClientContext &context,
 void InspectStorageExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
 	auto &state = data.global_state->Cast<InspectStorageData>();
 
-	idx_t count = 0;
-
 	constexpr idx_t DATABASE_NAME_IDX = 0;
 	constexpr idx_t DATABASE_FILE_BYTES_IDX = 1;
 	constexpr idx_t WAL_FILE_BYTES_IDX = 2;
 
-	while (state.offset < state.entries.size() && count < STANDARD_VECTOR_SIZE) {
-		auto &entry = state.entries[state.offset];
+	OutputWriter writer(output);
+	while (state.offset < state.databases.size() && !writer.IsFull()) {
+		auto &db = *state.databases[state.offset];
+		const auto ds = db.GetCatalog().GetDatabaseSize(context);
 
-		output.SetValue(DATABASE_NAME_IDX, count, Value(entry.database_name));
-		output.SetValue(DATABASE_FILE_BYTES_IDX, count,
-		                Value::BIGINT(NumericCast<int64_t>(entry.database_file_size_bytes)));
-		output.SetValue(WAL_FILE_BYTES_IDX, count, Value::BIGINT(NumericCast<int64_t>(entry.wal_file_size_bytes)));
+		writer.WriteString(DATABASE_NAME_IDX, db.GetName());
+		writer.WriteBigint(DATABASE_FILE_BYTES_IDX, static_cast<idx_t>(ds.bytes));
+		writer.WriteBigint(WAL_FILE_BYTES_IDX, static_cast<idx_t>(ds.wal_size));
+		writer.NextRow();
 
 		state.offset++;
-		count++;
 	}
 
-	output.SetCardinality(count);
+	writer.Finalize();
 }
 
 } // namespace
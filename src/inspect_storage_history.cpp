@@ -0,0 +1,135 @@
+#include "inspect_storage_history.hpp"
+#include "output_writer.hpp"
+#include "storage_history.hpp"
+
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/vector.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+namespace {
+
+//===--------------------------------------------------------------------===//
+// inspect_storage_history() - Storage samples of the background collector
+//===--------------------------------------------------------------------===//
+
+// Reports the samples captured while table_inspector_sample_interval is set, oldest first: one row per persistent
+// attached database and interval. Sizes of the block usage components are 0 if the database couldn't be inspected.
+//
+// With `capture := true`, Init first samples every database in the caller's transaction and appends the samples to
+// the history, e.g. to take a sample right after a checkpoint without waiting for the collector.
+
+struct InspectStorageHistoryBindData : public TableFunctionData {
+	explicit InspectStorageHistoryBindData(bool capture_p) : capture(capture_p) {
+	}
+
+	bool capture;
+};
+
+// Init copies the samples, so the collector can keep appending while rows are emitted.
+struct InspectStorageHistoryData : public GlobalTableFunctionState {
+	InspectStorageHistoryData() : offset(0) {
+	}
+
+	vector<StorageHistorySample> samples;
+	idx_t offset;
+};
+
+unique_ptr<FunctionData> InspectStorageHistoryBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+	D_ASSERT(names.empty());
+	D_ASSERT(return_types.empty());
+
+	names.reserve(11);
+	return_types.reserve(11);
+	names.emplace_back("sample_time");
+	return_types.emplace_back(LogicalType {LogicalTypeId::TIMESTAMP_TZ});
+	names.emplace_back("database_name");
+	return_types.emplace_back(LogicalType {LogicalTypeId::VARCHAR});
+	names.emplace_back("database_file_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("wal_file_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("table_data_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("index_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("metadata_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("free_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("unaccounted_bytes");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("total_blocks");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+	names.emplace_back("free_blocks");
+	return_types.emplace_back(LogicalType {LogicalTypeId::BIGINT});
+
+	auto entry = input.named_parameters.find("capture");
+	const bool capture =
+	    entry != input.named_parameters.end() && !entry->second.IsNull() && entry->second.GetValue<bool>();
+	return make_uniq<InspectStorageHistoryBindData>(capture);
+}
+
+unique_ptr<GlobalTableFunctionState> InspectStorageHistoryInit(ClientContext &context,
+                                                               TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<InspectStorageHistoryBindData>();
+	auto result = make_uniq<InspectStorageHistoryData>();
+	auto history = StorageHistory::Get(context);
+	if (bind_data.capture) {
+		history->Capture(context);
+	}
+	result->samples = history->GetSamples();
+	return std::move(result);
+}
+
+void InspectStorageHistoryExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &state = data.global_state->Cast<InspectStorageHistoryData>();
+
+	constexpr idx_t SAMPLE_TIME_IDX = 0;
+	constexpr idx_t DATABASE_NAME_IDX = 1;
+	constexpr idx_t DATABASE_FILE_BYTES_IDX = 2;
+	constexpr idx_t WAL_FILE_BYTES_IDX = 3;
+	constexpr idx_t TABLE_DATA_BYTES_IDX = 4;
+	constexpr idx_t INDEX_BYTES_IDX = 5;
+	constexpr idx_t METADATA_BYTES_IDX = 6;
+	constexpr idx_t FREE_BYTES_IDX = 7;
+	constexpr idx_t UNACCOUNTED_BYTES_IDX = 8;
+	constexpr idx_t TOTAL_BLOCKS_IDX = 9;
+	constexpr idx_t FREE_BLOCKS_IDX = 10;
+
+	OutputWriter writer(output);
+	while (state.offset < state.samples.size() && !writer.IsFull()) {
+		const auto &sample = state.samples[state.offset];
+
+		writer.Write<timestamp_tz_t>(SAMPLE_TIME_IDX, timestamp_tz_t(sample.sample_time));
+		writer.WriteString(DATABASE_NAME_IDX, sample.database_name);
+		writer.WriteBigint(DATABASE_FILE_BYTES_IDX, sample.database_file_bytes);
+		writer.WriteBigint(WAL_FILE_BYTES_IDX, sample.wal_file_bytes);
+		writer.WriteBigint(TABLE_DATA_BYTES_IDX, sample.table_data_bytes);
+		writer.WriteBigint(INDEX_BYTES_IDX, sample.index_bytes);
+		writer.WriteBigint(METADATA_BYTES_IDX, sample.metadata_bytes);
+		writer.WriteBigint(FREE_BYTES_IDX, sample.free_bytes);
+		writer.WriteBigint(UNACCOUNTED_BYTES_IDX, sample.unaccounted_bytes);
+		writer.WriteBigint(TOTAL_BLOCKS_IDX, sample.total_blocks);
+		writer.WriteBigint(FREE_BLOCKS_IDX, sample.free_blocks);
+		writer.NextRow();
+
+		state.offset++;
+	}
+
+	writer.Finalize();
+}
+
+} // namespace
+
+void RegisterInspectStorageHistoryFunction(ExtensionLoader &loader) {
+	TableFunction inspect_storage_history_func("inspect_storage_history", {}, InspectStorageHistoryExecute,
+	                                           InspectStorageHistoryBind, InspectStorageHistoryInit);
+	inspect_storage_history_func.named_parameters["capture"] = LogicalType {LogicalTypeId::BOOLEAN};
+	loader.RegisterFunction(std::move(inspect_storage_history_func));
+}
+
+} // namespace duckdb
@@ -0,0 +1,47 @@
+#include "inspection_deadline.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+
+namespace duckdb {
+
+optional_idx InspectionDeadline::GetTimeout(const named_parameter_map_t &named_parameters,
+                                            const string &function_name) {
+	auto entry = named_parameters.find("timeout_ms");
+	if (entry == named_parameters.end() || entry->second.IsNull()) {
+		return optional_idx();
+	}
+	const auto timeout_ms = entry->second.GetValue<int64_t>();
+	if (timeout_ms < 0) {
+		throw InvalidInputException("%s() timeout_ms must not be negative", function_name);
+	}
+	return optional_idx(NumericCast<idx_t>(timeout_ms));
+}
+
+void InspectionDeadline::AddNamedParameter(TableFunction &function) {
+	function.named_parameters["timeout_ms"] = LogicalType {LogicalTypeId::BIGINT};
+}
+
+InspectionDeadline InspectionDeadline::Start(optional_idx timeout_ms) {
+	InspectionDeadline result;
+	if (timeout_ms.IsValid()) {
+		result.has_timeout = true;
+		result.deadline =
+		    std::chrono::steady_clock::now() + std::chrono::milliseconds(NumericCast<int64_t>(timeout_ms.GetIndex()));
+	}
+	return result;
+}
+
+bool InspectionDeadline::Passed() const {
+	return has_timeout && std::chrono::steady_clock::now() >= deadline;
+}
+
+void CheckInterrupted(ClientContext &context) {
+	if (context.interrupted) {
+		throw InterruptException();
+	}
+}
+
+} // namespace duckdb
@@ -0,0 +1,137 @@
+#include "inspection_profile.hpp"
+
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/client_context.hpp"
+
+namespace duckdb {
+
+namespace {
+
+constexpr const char *LAST_PROFILE_STATE_KEY = "table_inspector_last_profile";
+constexpr double NANOS_PER_MS = 1000000.0;
+
+} // namespace
+
+InspectionProfile::InspectionProfile(string function_name_p, string database_name_p)
+    : function_name(std::move(function_name_p)), database_name(std::move(database_name_p)),
+      start(std::chrono::steady_clock::now()), wall_nanos(0) {
+	for (auto &nanos : phase_nanos) {
+		nanos = 0;
+	}
+	for (auto &counter : counters) {
+		counter = 0;
+	}
+}
+
+bool InspectionProfile::IsEnabled(const named_parameter_map_t &named_parameters) {
+	auto entry = named_parameters.find("profile");
+	return entry != named_parameters.end() && !entry->second.IsNull() && entry->second.GetValue<bool>();
+}
+
+void InspectionProfile::AddNamedParameter(TableFunction &function) {
+	function.named_parameters["profile"] = LogicalType {LogicalTypeId::BOOLEAN};
+}
+
+const char *InspectionProfile::PhaseName(InspectionPhase phase) {
+	switch (phase) {
+	case InspectionPhase::CATALOG_SCAN:
+		return "catalog_scan";
+	case InspectionPhase::RESULT_CACHE:
+		return "result_cache";
+	case InspectionPhase::SEGMENT_COLLECTION:
+		return "segment_collection";
+	case InspectionPhase::BLOCK_COUNTING:
+		return "block_counting";
+	case InspectionPhase::INDEX_WALK:
+		return "index_walk";
+	case InspectionPhase::ATTRIBUTION:
+		return "attribution";
+	}
+	return "unknown";
+}
+
+const char *InspectionProfile::CounterName(InspectionCounter counter) {
+	switch (counter) {
+	case InspectionCounter::TABLES_VISITED:
+		return "tables_visited";
+	case InspectionCounter::SEGMENTS_VISITED:
+		return "segments_visited";
+	case InspectionCounter::UNIQUE_BLOCKS:
+		return "unique_blocks";
+	case InspectionCounter::BLOCK_SET_BYTES:
+		return "block_set_bytes";
+	case InspectionCounter::INDEX_ALLOCATORS:
+		return "index_allocators";
+	case InspectionCounter::RESULT_CACHE_HITS:
+		return "result_cache_hits";
+	}
+	return "unknown";
+}
+
+void InspectionProfile::Finish() {
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	wall_nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+vector<InspectionProfile::Metric> InspectionProfile::GetMetrics() const {
+	vector<Metric> result;
+	result.reserve(1 + INSPECTION_PHASE_COUNT + INSPECTION_COUNTER_COUNT);
+	result.push_back(Metric {"wall_time", static_cast<double>(wall_nanos.load()) / NANOS_PER_MS, "ms"});
+	for (idx_t phase_idx = 0; phase_idx < INSPECTION_PHASE_COUNT; ++phase_idx) {
+		const auto phase = static_cast<InspectionPhase>(phase_idx);
+		result.push_back(Metric {PhaseName(phase), static_cast<double>(phase_nanos[phase_idx].load()) / NANOS_PER_MS,
+		                         "ms"});
+	}
+	for (idx_t counter_idx = 0; counter_idx < INSPECTION_COUNTER_COUNT; ++counter_idx) {
+		const auto counter = static_cast<InspectionCounter>(counter_idx);
+		result.push_back(Metric {CounterName(counter), static_cast<double>(counters[counter_idx].load()), "count"});
+	}
+	return result;
+}
+
+InsertionOrderPreservingMap<string> InspectionProfile::ToProfilerInfo() const {
+	InsertionOrderPreservingMap<string> result;
+	for (const auto &metric : GetMetrics()) {
+		// The wall time is only known once the query ended, the profiler shows the operator's own timing instead
+		if (metric.name == "wall_time") {
+			continue;
+		}
+		if (StringUtil::Equals(metric.unit, "ms")) {
+			result[metric.name] = StringUtil::Format("%.3f ms", metric.value);
+		} else {
+			result[metric.name] = std::to_string(static_cast<idx_t>(metric.value));
+		}
+	}
+	return result;
+}
+
+shared_ptr<LastInspectionProfile> LastInspectionProfile::Get(ClientContext &context) {
+	return context.registered_state->GetOrCreate<LastInspectionProfile>(LAST_PROFILE_STATE_KEY);
+}
+
+void LastInspectionProfile::Store(shared_ptr<InspectionProfile> profile_p) {
+	lock_guard<mutex> guard(lock);
+	profile = std::move(profile_p);
+}
+
+shared_ptr<InspectionProfile> LastInspectionProfile::GetProfile() {
+	lock_guard<mutex> guard(lock);
+	return profile;
+}
+
+InspectionProfiler::~InspectionProfiler() {
+	if (!profile) {
+		return;
+	}
+	profile->Finish();
+	last_profile->Store(std::move(profile));
+}
+
+void InspectionProfiler::Start(ClientContext &context, const string &function_name, const string &database_name) {
+	profile = make_shared_ptr<InspectionProfile>(function_name, database_name);
+	last_profile = LastInspectionProfile::Get(context);
+}
+
+} // namespace duckdb
@@ -0,0 +1,33 @@
+#include "result_cache.hpp"
+
+#include "duckdb/common/types/value.hpp"
+
+namespace duckdb {
+
+bool IsResultCacheEnabled(ClientContext &context) {
+	Value enabled;
+	if (!context.TryGetCurrentSetting(ENABLE_CACHE_SETTING, enabled) || enabled.IsNull()) {
+		return true;
+	}
+	return BooleanValue::Get(enabled);
+}
+
+bool ResultVersion::operator==(const ResultVersion &other) const {
+	return checkpoint_id == other.checkpoint_id && catalog_version == other.catalog_version;
+}
+
+bool ResultVersion::operator!=(const ResultVersion &other) const {
+	return !(*this == other);
+}
+
+ResultVersion ResultVersion::Get(ClientContext &context, Catalog &catalog) {
+	ResultVersion result;
+	result.checkpoint_id = CheckpointId::Get(context, catalog);
+	const auto catalog_version = catalog.GetCatalogVersion(context);
+	if (catalog_version.IsValid()) {
+		result.catalog_version = catalog_version.GetIndex();
+	}
+	return result;
+}
+
+} // namespace duckdb
@@ -0,0 +1,183 @@
+#include "sampling.hpp"
+#include "util.hpp"
+
+#include "duckdb/common/assert.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/function/table_function.hpp"
+
+#include <cmath>
+
+namespace duckdb {
+
+namespace {
+
+// Two-sided 95% quantile of the normal distribution
+constexpr double CONFIDENCE_Z = 1.96;
+
+} // namespace
+
+RowGroupSampling RowGroupSampling::FromNamedParameters(const named_parameter_map_t &named_parameters,
+                                                       const string &function_name) {
+	RowGroupSampling result;
+
+	auto sample = named_parameters.find("sample");
+	if (sample != named_parameters.end() && !sample->second.IsNull()) {
+		const auto fraction = sample->second.GetValue<double>();
+		if (!(fraction > 0.0 && fraction <= 1.0)) {
+			throw InvalidInputException("%s() sample must be in (0, 1], got %s", function_name,
+			                            sample->second.ToString());
+		}
+		result.enabled = true;
+		result.fraction = fraction;
+	}
+
+	auto max_row_groups = named_parameters.find("max_row_groups");
+	if (max_row_groups != named_parameters.end() && !max_row_groups->second.IsNull()) {
+		const auto value = max_row_groups->second.GetValue<int64_t>();
+		if (value <= 0) {
+			throw InvalidInputException("%s() max_row_groups must be positive", function_name);
+		}
+		result.enabled = true;
+		result.max_row_groups = NumericCast<idx_t>(value);
+	}
+
+	return result;
+}
+
+void RowGroupSampling::AddNamedParameters(TableFunction &function) {
+	function.named_parameters["sample"] = LogicalType {LogicalTypeId::DOUBLE};
+	function.named_parameters["max_row_groups"] = LogicalType {LogicalTypeId::BIGINT};
+}
+
+idx_t RowGroupSampling::SampleSize(idx_t row_group_count) const {
+	if (row_group_count == 0) {
+		return 0;
+	}
+	auto sample_size = static_cast<idx_t>(std::ceil(fraction * static_cast<double>(row_group_count)));
+	if (max_row_groups.IsValid()) {
+		sample_size = MinValue(sample_size, max_row_groups.GetIndex());
+	}
+	return MaxValue<idx_t>(MinValue(sample_size, row_group_count), 1);
+}
+
+vector<SampledRowGroup> RowGroupSampling::SelectRowGroups(idx_t row_group_count, hash_t seed) const {
+	const idx_t sample_size = SampleSize(row_group_count);
+
+	vector<SampledRowGroup> result;
+	result.reserve(sample_size);
+	for (idx_t stratum = 0; stratum < sample_size; ++stratum) {
+		const idx_t start = stratum * row_group_count / sample_size;
+		const idx_t end = (stratum + 1) * row_group_count / sample_size;
+		D_ASSERT(end > start);
+		const idx_t pick = CombineHash(seed, Hash(stratum)) % (end - start);
+		result.push_back(SampledRowGroup {start + pick, end - start});
+	}
+	return result;
+}
+
+void SampleEstimate::Add(const SampleEstimate &other) {
+	estimate += other.estimate;
+	variance += other.variance;
+	has_variance = has_variance && other.has_variance;
+	sampled_total += other.sampled_total;
+}
+
+double SampleEstimate::Low() const {
+	D_ASSERT(has_variance);
+	return MaxValue(estimate - CONFIDENCE_Z * std::sqrt(variance), sampled_total);
+}
+
+double SampleEstimate::High() const {
+	D_ASSERT(has_variance);
+	return estimate + CONFIDENCE_Z * std::sqrt(variance);
+}
+
+SampleEstimate ExtrapolateTotal(const vector<SampledRowGroup> &sample, const vector<double> &sampled_values,
+                                idx_t population_size) {
+	D_ASSERT(sample.size() == sampled_values.size());
+	SampleEstimate result;
+	const idx_t sample_size = sample.size();
+	if (sample_size == 0) {
+		return result;
+	}
+
+	double mean = 0;
+	for (idx_t i = 0; i < sample_size; ++i) {
+		result.estimate += static_cast<double>(sample[i].weight) * sampled_values[i];
+		result.sampled_total += sampled_values[i];
+		mean += sampled_values[i];
+	}
+	mean /= static_cast<double>(sample_size);
+
+	// A fully inspected table is exact
+	if (sample_size >= population_size) {
+		return result;
+	}
+	if (sample_size < 2) {
+		result.has_variance = false;
+		return result;
+	}
+
+	double squared_deviations = 0;
+	for (const auto value : sampled_values) {
+		squared_deviations += (value - mean) * (value - mean);
+	}
+	const double n = static_cast<double>(sample_size);
+	const double population = static_cast<double>(population_size);
+	const double sample_variance = squared_deviations / (n - 1);
+	result.variance = population * population * (1.0 - n / population) * sample_variance / n;
+	return result;
+}
+
+idx_t CountRowGroups(const vector<ColumnSegmentInfo> &segment_info) {
+	idx_t row_group_count = 0;
+	for (const auto &seg : segment_info) {
+		row_group_count = MaxValue(row_group_count, seg.row_group_index + 1);
+	}
+	return row_group_count;
+}
+
+vector<idx_t> CalculateRowGroupSizes(const vector<ColumnSegmentInfo> &segment_info, idx_t block_alloc_size) {
+	vector<idx_t> result(CountRowGroups(segment_info), 0);
+	const auto segment_sizes = CalculateSegmentSizes(segment_info, block_alloc_size);
+	for (idx_t segment_idx = 0; segment_idx < segment_info.size(); ++segment_idx) {
+		const auto &seg = segment_info[segment_idx];
+		if (!seg.persistent || seg.block_id == INVALID_BLOCK) {
+			continue;
+		}
+		result[seg.row_group_index] += segment_sizes[segment_idx] + seg.additional_blocks.size() * block_alloc_size;
+	}
+	return result;
+}
+
+vector<double> MeasureSampledBlocks(const vector<SampledRowGroup> &sample,
+                                    const vector<ColumnSegmentInfo> &segment_info, idx_t block_alloc_size,
+                                    BlockBitmap &blocks) {
+	// Position of every sampled row group in the sample
+	unordered_map<idx_t, idx_t> sample_positions;
+	for (idx_t sample_idx = 0; sample_idx < sample.size(); ++sample_idx) {
+		sample_positions.emplace(sample[sample_idx].row_group_index, sample_idx);
+	}
+
+	vector<double> result(sample.size(), 0);
+	for (const auto &seg : segment_info) {
+		if (!seg.persistent || seg.block_id == INVALID_BLOCK) {
+			continue;
+		}
+		auto position = sample_positions.find(seg.row_group_index);
+		if (position == sample_positions.end()) {
+			continue;
+		}
+		idx_t added_blocks = blocks.Set(seg.block_id) ? 1 : 0;
+		for (const auto block_id : seg.additional_blocks) {
+			added_blocks += blocks.Set(block_id) ? 1 : 0;
+		}
+		result[position->second] += static_cast<double>(added_blocks * block_alloc_size);
+	}
+	return result;
+}
+
+} // namespace duckdb
@@ -0,0 +1,256 @@
+#include "segment_snapshot.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/catalog/catalog_entry/table_catalog_entry.hpp"
+#include "duckdb/common/algorithm.hpp"
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/function/partition_stats.hpp"
+#include "duckdb/main/attached_database.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/storage/block.hpp"
+#include "duckdb/storage/block_manager.hpp"
+#include "duckdb/storage/data_table.hpp"
+#include "duckdb/storage/database_size.hpp"
+#include "duckdb/storage/statistics/base_statistics.hpp"
+#include "duckdb/storage/storage_index.hpp"
+#include "duckdb/storage/storage_manager.hpp"
+#include "duckdb/storage/table/row_group.hpp"
+#include "duckdb/storage/table/scan_state.hpp"
+#include "duckdb/transaction/duck_transaction.hpp"
+
+namespace duckdb {
+
+namespace {
+
+constexpr const char *SEGMENT_SNAPSHOT_KEY_PREFIX = "table_inspector_segment_snapshot:";
+
+bool IsCheckpointedSegment(const ColumnSegmentInfo &seg) {
+	return seg.persistent && seg.block_id != INVALID_BLOCK;
+}
+
+// Rough memory usage of one cached segment info, used for the object cache memory estimate.
+idx_t EstimateSegmentMemory(const ColumnSegmentInfo &seg) {
+	return sizeof(ColumnSegmentInfo) + seg.column_path.size() + seg.segment_type.size() +
+	       seg.compression_type.size() + seg.segment_stats.size() + seg.segment_info.size() +
+	       seg.additional_blocks.size() * sizeof(block_id_t);
+}
+
+} // namespace
+
+bool CheckpointId::operator==(const CheckpointId &other) const {
+	return meta_block == other.meta_block && total_blocks == other.total_blocks && free_blocks == other.free_blocks;
+}
+
+bool CheckpointId::operator!=(const CheckpointId &other) const {
+	return !(*this == other);
+}
+
+CheckpointId CheckpointId::Get(ClientContext &context, Catalog &catalog) {
+	D_ASSERT(!catalog.InMemory());
+	const auto ds = catalog.GetDatabaseSize(context);
+	auto &block_manager = catalog.GetAttached().GetStorageManager().GetBlockManager();
+
+	CheckpointId result;
+	result.meta_block = block_manager.GetMetaBlock();
+	result.total_blocks = ds.total_blocks;
+	result.free_blocks = ds.free_blocks;
+	return result;
+}
+
+bool TableFingerprint::operator==(const TableFingerprint &other) const {
+	return storage.get() == other.storage.get() && total_rows == other.total_rows &&
+	       column_count == other.column_count && statistics_hash == other.statistics_hash;
+}
+
+bool TableFingerprint::operator!=(const TableFingerprint &other) const {
+	return !(*this == other);
+}
+
+TableFingerprint TableFingerprint::Get(ClientContext &context, TableCatalogEntry &table) {
+	auto &storage = table.GetStorage();
+
+	TableFingerprint result;
+	result.storage = &storage;
+	result.total_rows = storage.GetTotalRows();
+	result.column_count = table.GetColumns().LogicalColumnCount();
+	for (idx_t column_idx = 0; column_idx < result.column_count; ++column_idx) {
+		auto stats = table.GetStatistics(context, column_idx);
+		if (!stats) {
+			// Generated columns have no storage
+			continue;
+		}
+		const auto stats_str = stats->ToString();
+		result.statistics_hash = CombineHash(result.statistics_hash, Hash(stats_str.c_str(), stats_str.size()));
+	}
+	return result;
+}
+
+SegmentSnapshot::SegmentSnapshot(string database_name_p, CheckpointId checkpoint_id_p)
+    : database_name(std::move(database_name_p)), checkpoint_id(checkpoint_id_p) {
+}
+
+SegmentSnapshot::SegmentSnapshot(string database_name_p, CheckpointId checkpoint_id_p,
+                                 const SegmentSnapshot &previous)
+    : SegmentSnapshot(std::move(database_name_p), checkpoint_id_p) {
+	lock_guard<mutex> guard(previous.lock);
+	// Only tables accessed at the previous checkpoint are carried over, so dropped tables age out
+	for (const auto &entry : previous.table_segments) {
+		if (entry.second.reusable) {
+			previous_segments.emplace(entry.first, entry.second);
+			estimated_memory += entry.second.estimated_memory;
+		}
+	}
+}
+
+string SegmentSnapshot::ObjectType() {
+	return "table_inspector_segment_snapshot";
+}
+
+string SegmentSnapshot::GetObjectType() {
+	return ObjectType();
+}
+
+optional_idx SegmentSnapshot::GetEstimatedCacheMemory() const {
+	lock_guard<mutex> guard(lock);
+	return optional_idx(estimated_memory);
+}
+
+shared_ptr<SegmentSnapshot> SegmentSnapshot::Get(ClientContext &context, Catalog &catalog) {
+	if (catalog.InMemory()) {
+		return make_shared_ptr<SegmentSnapshot>(catalog.GetName(), CheckpointId());
+	}
+
+	// Key by name and path, so a different file attached under the same alias never sees a stale snapshot
+	const auto key = SEGMENT_SNAPSHOT_KEY_PREFIX + catalog.GetName() + ":" + catalog.GetDBPath();
+	const auto checkpoint_id = CheckpointId::Get(context, catalog);
+
+	auto &cache = ObjectCache::GetObjectCache(context);
+	auto snapshot = cache.Get<SegmentSnapshot>(key);
+	if (snapshot && snapshot->GetCheckpointId() == checkpoint_id) {
+		return snapshot;
+	}
+
+	// No snapshot yet, or it was taken before the latest checkpoint. Unchanged tables keep their segments.
+	if (snapshot) {
+		snapshot = make_shared_ptr<SegmentSnapshot>(catalog.GetName(), checkpoint_id, *snapshot);
+	} else {
+		snapshot = make_shared_ptr<SegmentSnapshot>(catalog.GetName(), checkpoint_id);
+	}
+	cache.Put(key, snapshot);
+	return snapshot;
+}
+
+SegmentSnapshot::TableSegments SegmentSnapshot::GetTableSegments(ClientContext &context, TableCatalogEntry &table) {
+	{
+		lock_guard<mutex> guard(lock);
+		auto entry = table_segments.find(table.oid);
+		if (entry != table_segments.end()) {
+			return entry->second.segments;
+		}
+	}
+
+	const auto fingerprint = TableFingerprint::Get(context, table);
+	{
+		lock_guard<mutex> guard(lock);
+		auto previous = previous_segments.find(table.oid);
+		if (previous != previous_segments.end()) {
+			auto entry = std::move(previous->second);
+			previous_segments.erase(previous);
+			if (entry.fingerprint == fingerprint) {
+				// Not rewritten by the checkpoint(s) since the segments were collected, memory is accounted already
+				auto inserted = table_segments.emplace(table.oid, std::move(entry));
+				return inserted.first->second.segments;
+			}
+			estimated_memory -= entry.estimated_memory;
+		}
+	}
+
+	// Collect outside of the lock so that tables can be collected in parallel.
+	// Only persistent segments are kept: transient segments are not part of the checkpoint this snapshot describes.
+	QueryContext query_context {context};
+	auto segments = table.GetColumnSegmentInfo(query_context);
+	bool has_changes = false;
+	for (const auto &seg : segments) {
+		if (!seg.persistent || seg.block_id == INVALID_BLOCK || seg.has_updates) {
+			has_changes = true;
+			break;
+		}
+	}
+	segments.erase(std::remove_if(segments.begin(), segments.end(),
+	                              [](const ColumnSegmentInfo &seg) { return !IsCheckpointedSegment(seg); }),
+	               segments.end());
+
+	TableEntry entry;
+	entry.estimated_memory = 0;
+	for (const auto &seg : segments) {
+		entry.estimated_memory += EstimateSegmentMemory(seg);
+	}
+	entry.segments = make_shared_ptr<vector<ColumnSegmentInfo>>(std::move(segments));
+	entry.fingerprint = fingerprint;
+	// In-memory changes are not reflected in the segments but are in the fingerprint, which would let a later
+	// snapshot adopt segments that the next checkpoint rewrites
+	entry.reusable = !has_changes;
+
+	lock_guard<mutex> guard(lock);
+	auto inserted = table_segments.emplace(table.oid, std::move(entry));
+	if (inserted.second) {
+		estimated_memory += inserted.first->second.estimated_memory;
+	}
+	// If another thread collected this table concurrently, its result wins
+	return inserted.first->second.segments;
+}
+
+SegmentSnapshot::SampledSegments SegmentSnapshot::GetSampledSegments(ClientContext &context,
+                                                                    TableCatalogEntry &table,
+                                                                    const RowGroupSampling &sampling) {
+	auto &storage = table.GetStorage();
+	const auto partitions = storage.GetPartitionStats(context);
+
+	SampledSegments result;
+	result.row_group_count = partitions.size();
+	result.sample = sampling.SelectRowGroups(result.row_group_count, Hash(table.oid));
+
+	TableSegments collected;
+	{
+		lock_guard<mutex> guard(lock);
+		auto entry = table_segments.find(table.oid);
+		if (entry != table_segments.end()) {
+			collected = entry->second.segments;
+		}
+	}
+	if (collected) {
+		vector<bool> is_sampled(result.row_group_count, false);
+		for (const auto &row_group : result.sample) {
+			is_sampled[row_group.row_group_index] = true;
+		}
+		for (const auto &seg : *collected) {
+			if (seg.row_group_index < is_sampled.size() && is_sampled[seg.row_group_index]) {
+				result.segments.push_back(seg);
+			}
+		}
+		return result;
+	}
+
+	// Positions a scan at every sampled row group, which only loads the row group itself, and walks its segments
+	auto &transaction = DuckTransaction::Get(context, table.ParentCatalog());
+	QueryContext query_context {context};
+	vector<StorageIndex> column_ids;
+	column_ids.emplace_back(COLUMN_IDENTIFIER_ROW_ID);
+	for (const auto &row_group : result.sample) {
+		const auto &partition = partitions[row_group.row_group_index];
+		TableScanState scan_state;
+		storage.InitializeScanWithOffset(transaction, scan_state, column_ids, partition.row_start,
+		                                 partition.row_start + partition.count);
+		if (!scan_state.table_state.row_group) {
+			continue;
+		}
+		scan_state.table_state.row_group->GetColumnSegmentInfo(query_context, row_group.row_group_index,
+		                                                       result.segments);
+	}
+	result.segments.erase(std::remove_if(result.segments.begin(), result.segments.end(),
+	                                     [](const ColumnSegmentInfo &seg) { return !IsCheckpointedSegment(seg); }),
+	                      result.segments.end());
+	return result;
+}
+
+} // namespace duckdb
@@ -0,0 +1,199 @@
+#include "storage_history.hpp"
+#include "block_usage.hpp"
+#include "inspection_deadline.hpp"
+
+#include "duckdb/catalog/catalog.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/main/attached_database.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/main/connection_manager.hpp"
+#include "duckdb/main/database.hpp"
+#include "duckdb/main/database_manager.hpp"
+
+#include <chrono>
+
+namespace duckdb {
+
+namespace {
+
+// Fills the block usage figures of a sample. Block usage is served from the result cache between checkpoints, so a
+// sample of an unchanged database costs little more than reading the file sizes.
+void CaptureBlockUsage(ClientContext &context, Catalog &catalog, StorageHistorySample &sample) {
+	BlockUsageInspection inspection(RowGroupSampling(), InspectionDeadline(), nullptr);
+	shared_ptr<const BlockUsageResult> usage = inspection.Prepare(context, catalog);
+	if (!usage) {
+		usage = inspection.Compute(context);
+	}
+
+	for (auto &entry : usage->entries) {
+		const string component = entry.component;
+		const auto size_bytes = entry.block_count * usage->block_alloc_size;
+		if (component == "table_data") {
+			sample.table_data_bytes = size_bytes;
+		} else if (component == "index") {
+			sample.index_bytes = size_bytes;
+		} else if (component == "metadata") {
+			sample.metadata_bytes = size_bytes;
+		} else if (component == "free_blocks") {
+			sample.free_bytes = size_bytes;
+			sample.free_blocks = entry.block_count;
+		} else if (component == "unaccounted") {
+			sample.unaccounted_bytes = size_bytes;
+		} else if (component == "total") {
+			sample.total_blocks = entry.block_count;
+		}
+	}
+}
+
+// Captures one sample per persistent attached database, in the context's transaction
+vector<StorageHistorySample> CaptureSamples(ClientContext &context) {
+	vector<StorageHistorySample> result;
+	const auto sample_time = Timestamp::GetCurrentTimestamp();
+
+	auto databases = DatabaseManager::Get(context).GetDatabases(context);
+	for (auto &db : databases) {
+		if (db->IsSystem() || db->IsTemporary() || db->GetCatalog().InMemory()) {
+			continue;
+		}
+		CheckInterrupted(context);
+
+		auto &catalog = db->GetCatalog();
+		const auto database_size = catalog.GetDatabaseSize(context);
+
+		StorageHistorySample sample;
+		sample.sample_time = sample_time;
+		sample.database_name = db->GetName();
+		sample.database_file_bytes = static_cast<idx_t>(database_size.bytes);
+		sample.wal_file_bytes = static_cast<idx_t>(database_size.wal_size);
+		try {
+			CaptureBlockUsage(context, catalog, sample);
+		} catch (InterruptException &) {
+			throw;
+		} catch (std::exception &) {
+			// Unsupported databases (e.g. encrypted) are sampled with their file sizes only
+		}
+		result.push_back(std::move(sample));
+	}
+	return result;
+}
+
+} // namespace
+
+StorageHistory::StorageHistory() : state(make_shared_ptr<CollectorState>()) {
+}
+
+StorageHistory::~StorageHistory() {
+	lock_guard<mutex> guard(collector_lock);
+	StopCollector();
+}
+
+string StorageHistory::ObjectType() {
+	return "table_inspector_storage_history";
+}
+
+string StorageHistory::GetObjectType() {
+	return ObjectType();
+}
+
+optional_idx StorageHistory::GetEstimatedCacheMemory() const {
+	return optional_idx();
+}
+
+shared_ptr<StorageHistory> StorageHistory::Get(ClientContext &context) {
+	return ObjectCache::GetObjectCache(context).GetOrCreate<StorageHistory>(ObjectType());
+}
+
+void StorageHistory::SetInterval(DatabaseInstance &db, idx_t interval_ms) {
+	lock_guard<mutex> guard(collector_lock);
+	if (interval_ms == 0) {
+		StopCollector();
+		return;
+	}
+	{
+		lock_guard<mutex> state_guard(state->lock);
+		state->interval_ms = interval_ms;
+		++state->generation;
+		state->interval_changed.notify_all();
+	}
+	if (!collector.joinable()) {
+		collector = std::thread(RunCollector, state, weak_ptr<DatabaseInstance>(db.shared_from_this()));
+	}
+}
+
+void StorageHistory::Capture(ClientContext &context) {
+	auto samples = CaptureSamples(context);
+	lock_guard<mutex> guard(state->lock);
+	for (auto &sample : samples) {
+		state->samples.Push(std::move(sample));
+	}
+}
+
+vector<StorageHistorySample> StorageHistory::GetSamples() const {
+	lock_guard<mutex> guard(state->lock);
+	return state->samples.ToVector();
+}
+
+void StorageHistory::SetSampleInterval(ClientContext &context, SetScope scope, Value &parameter) {
+	const auto interval_ms = parameter.IsNull() ? 0 : parameter.GetValue<int64_t>();
+	if (interval_ms < 0) {
+		throw InvalidInputException("%s must not be negative", SAMPLE_INTERVAL_SETTING);
+	}
+	Get(context)->SetInterval(*context.db, NumericCast<idx_t>(interval_ms));
+}
+
+void StorageHistory::StopCollector() {
+	{
+		lock_guard<mutex> state_guard(state->lock);
+		state->interval_ms = 0;
+		++state->generation;
+		state->interval_changed.notify_all();
+	}
+	if (!collector.joinable()) {
+		return;
+	}
+	if (collector.get_id() == std::this_thread::get_id()) {
+		// The collector released the last reference to the instance, which is destroying this entry. The thread only
+		// touches the shared state from here on, and ends as soon as it sees the interval reset
+		collector.detach();
+		return;
+	}
+	collector.join();
+}
+
+void StorageHistory::RunCollector(shared_ptr<CollectorState> state, weak_ptr<DatabaseInstance> weak_db) {
+	unique_lock<mutex> guard(state->lock);
+	while (state->interval_ms != 0) {
+		const auto generation = state->generation;
+		const auto retimed = state->interval_changed.wait_for(guard, std::chrono::milliseconds(state->interval_ms),
+		                                                      [&]() { return state->generation != generation; });
+		if (retimed) {
+			// Stopped, or wait for the new interval
+			continue;
+		}
+
+		guard.unlock();
+		vector<StorageHistorySample> samples;
+		{
+			auto db = weak_db.lock();
+			if (!db) {
+				return;
+			}
+			// Without open connections the instance is idle or being closed; sampling it would only delay the close
+			if (ConnectionManager::Get(*db).GetConnectionCount() > 0) {
+				auto context = make_shared_ptr<ClientContext>(db);
+				try {
+					context->RunFunctionInTransaction([&]() { samples = CaptureSamples(*context); });
+				} catch (std::exception &) {
+					// A failed capture only loses this sample, the next interval tries again
+				}
+			}
+		}
+		guard.lock();
+		for (auto &sample : samples) {
+			state->samples.Push(std::move(sample));
+		}
+	}
+}
+
+} // namespace duckdb
@@ -2,11 +2,30 @@
 
 #include "table_inspector_extension.hpp"
 
+#include "column_activity.hpp"
+#include "inspect_all_databases.hpp"
+#include "inspect_checkpoint.hpp"
 #include "inspect_column.hpp"
+#include "inspect_column_activity.hpp"
+#include "inspect_compression.hpp"
+#include "inspect_compression_candidates.hpp"
 #include "inspect_database.hpp"
+#include "inspect_duplicates.hpp"
+#include "inspect_file.hpp"
+#include "inspect_free_space.hpp"
+#include "inspect_index.hpp"
+#include "inspect_last_profile.hpp"
+#include "inspect_memory.hpp"
+#include "inspect_row_groups.hpp"
+#include "inspect_scan_cost.hpp"
+#include "inspect_snapshot.hpp"
 #include "inspect_storage.hpp"
+#include "inspect_storage_history.hpp"
 #include "inspect_block_usage.hpp"
+#include "result_cache.hpp"
+#include "storage_history.hpp"
 
+#include "duckdb/main/config.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
 
 namespace duckdb {
@@ -14,10 +33,44 @@ namespace duckdb {
 static void LoadInternal(ExtensionLoader &loader) {
 	loader.SetDescription("Provides observability into DuckDB storage internals");
 
+	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
+	config.AddExtensionOption(ENABLE_CACHE_SETTING,
+	                          "Serve inspect_database() and inspect_block_usage() results from a per-database cache "
+	                          "until the next checkpoint or schema change",
+	                          LogicalType {LogicalTypeId::BOOLEAN}, Value::BOOLEAN(true));
+	config.AddExtensionOption(SAMPLE_INTERVAL_SETTING,
+	                          "Interval in milliseconds at which a background thread samples the storage figures "
+	                          "reported by inspect_storage_history(), 0 to disable",
+	                          LogicalType {LogicalTypeId::BIGINT}, Value::BIGINT(0), StorageHistory::SetSampleInterval);
+	config.AddExtensionOption(TRACK_COLUMN_ACTIVITY_SETTING,
+	                          "Count the rows and bytes that table scans return per column, reported by "
+	                          "inspect_column_activity(). Applies to queries planned while enabled",
+	                          LogicalType {LogicalTypeId::BOOLEAN}, Value::BOOLEAN(false));
+	ColumnActivity::RegisterOptimizer(config);
+
 	RegisterInspectColumnFunction(loader);
+	RegisterInspectColumnsFunction(loader);
 	RegisterInspectDatabaseFunction(loader);
 	RegisterInspectStorageFunction(loader);
 	RegisterInspectBlockUsageFunction(loader);
+	RegisterInspectFileFunction(loader);
+	RegisterInspectIndexFunction(loader);
+	RegisterInspectFreeSpaceFunction(loader);
+	RegisterInspectFreeSpaceSummaryFunction(loader);
+	RegisterInspectCompressionFunction(loader);
+	RegisterInspectStorageHistoryFunction(loader);
+	RegisterInspectCheckpointFunction(loader);
+	RegisterInspectMemoryFunction(loader);
+	RegisterInspectScanCostFunction(loader);
+	RegisterInspectLastProfileFunction(loader);
+	RegisterInspectAllDatabasesFunction(loader);
+	RegisterInspectDuplicatesFunction(loader);
+	RegisterInspectColumnActivityFunction(loader);
+	RegisterInspectRowGroupsFunction(loader);
+	RegisterInspectRowGroupSummaryFunction(loader);
+	RegisterInspectSnapshotFunction(loader);
+	RegisterInspectDiffFunction(loader);
+	RegisterInspectCompressionCandidatesFunction(loader);
 }
 
 void TableInspectorExtension::Load(ExtensionLoader &loader) {
@@ -1,8 +1,8 @@
 #include "util.hpp"
 
 #include "duckdb/common/assert.hpp"
+#include "duckdb/common/helper.hpp"
 #include "duckdb/common/string_util.hpp"
-#include "duckdb/common/unordered_set.hpp"
 #include "duckdb/storage/block.hpp"
 
 namespace duckdb {
@@ -15,20 +15,262 @@ string FormatPercentage(idx_t blocks, idx_t total_blocks) {
 	return StringUtil::Format("%.1f%%", pct);
 }
 
-idx_t CountUniqueBlocks(const vector<ColumnSegmentInfo> &segment_info) {
-	unordered_set<block_id_t> unique_blocks;
-
+void CollectSegmentBlocks(const vector<ColumnSegmentInfo> &segment_info, BlockBitmap &blocks) {
 	for (const auto &seg : segment_info) {
 		if (seg.persistent && seg.block_id != INVALID_BLOCK) {
-			unique_blocks.insert(seg.block_id);
+			blocks.Set(seg.block_id);
 			for (const auto &block_id : seg.additional_blocks) {
 				D_ASSERT(block_id != INVALID_BLOCK);
-				unique_blocks.insert(block_id);
+				blocks.Set(block_id);
+			}
+		}
+	}
+}
+
+idx_t CountUniqueBlocks(const vector<ColumnSegmentInfo> &segment_info, BlockBitmap &blocks) {
+	blocks.Clear();
+	CollectSegmentBlocks(segment_info, blocks);
+	return blocks.Count();
+}
+
+namespace {
+
+constexpr idx_t RADIX_BITS = 8;
+constexpr idx_t RADIX_BUCKETS = idx_t(1) << RADIX_BITS;
+
+// Number of bytes needed to represent every value up to max_value
+idx_t SignificantBytes(uint64_t max_value) {
+	idx_t bytes = 0;
+	while (max_value > 0) {
+		++bytes;
+		max_value >>= RADIX_BITS;
+	}
+	return bytes;
+}
+
+// One stable counting-sort pass on byte `byte_idx` of the key
+template <class GET_KEY>
+void RadixSortPass(vector<SegmentOffset> &entries, vector<SegmentOffset> &buffer, idx_t byte_idx, GET_KEY get_key) {
+	idx_t counts[RADIX_BUCKETS] = {0};
+	const idx_t shift = byte_idx * RADIX_BITS;
+	for (const auto &entry : entries) {
+		++counts[(get_key(entry) >> shift) & (RADIX_BUCKETS - 1)];
+	}
+
+	idx_t position = 0;
+	for (idx_t bucket = 0; bucket < RADIX_BUCKETS; ++bucket) {
+		const idx_t count = counts[bucket];
+		counts[bucket] = position;
+		position += count;
+	}
+
+	for (const auto &entry : entries) {
+		buffer[counts[(get_key(entry) >> shift) & (RADIX_BUCKETS - 1)]++] = entry;
+	}
+	entries.swap(buffer);
+}
+
+} // namespace
+
+void RadixSortSegmentOffsets(vector<SegmentOffset> &entries) {
+	if (entries.size() <= 1) {
+		return;
+	}
+
+	uint64_t max_offset = 0;
+	uint64_t max_block_id = 0;
+	for (const auto &entry : entries) {
+		D_ASSERT(entry.block_id >= 0);
+		max_offset = MaxValue<uint64_t>(max_offset, entry.offset);
+		max_block_id = MaxValue<uint64_t>(max_block_id, static_cast<uint64_t>(entry.block_id));
+	}
+
+	// LSD: sort by the secondary key (offset) first, then by the primary key (block_id)
+	vector<SegmentOffset> buffer(entries.size());
+	const idx_t offset_bytes = SignificantBytes(max_offset);
+	for (idx_t byte_idx = 0; byte_idx < offset_bytes; ++byte_idx) {
+		RadixSortPass(entries, buffer, byte_idx, [](const SegmentOffset &entry) { return uint64_t(entry.offset); });
+	}
+	const idx_t block_id_bytes = SignificantBytes(max_block_id);
+	for (idx_t byte_idx = 0; byte_idx < block_id_bytes; ++byte_idx) {
+		RadixSortPass(entries, buffer, byte_idx,
+		              [](const SegmentOffset &entry) { return static_cast<uint64_t>(entry.block_id); });
+	}
+}
+
+vector<idx_t> CalculateSegmentSizes(const vector<ColumnSegmentInfo> &segment_info, idx_t block_alloc_size) {
+	vector<idx_t> sizes(segment_info.size(), 0);
+
+	vector<SegmentOffset> offsets;
+	offsets.reserve(segment_info.size());
+	for (idx_t segment_idx = 0; segment_idx < segment_info.size(); ++segment_idx) {
+		const auto &seg = segment_info[segment_idx];
+		if (!seg.persistent || seg.block_id == INVALID_BLOCK) {
+			continue;
+		}
+		offsets.push_back(SegmentOffset {seg.block_id, seg.block_offset, segment_idx});
+	}
+	RadixSortSegmentOffsets(offsets);
+
+	// Each run of equal (block_id, offset) entries takes its size from the neighbour that follows the run.
+	// Segments sharing an offset have no distinguishable size and get 0.
+	idx_t run_start = 0;
+	while (run_start < offsets.size()) {
+		const auto &current = offsets[run_start];
+		idx_t run_end = run_start + 1;
+		while (run_end < offsets.size() && offsets[run_end].block_id == current.block_id &&
+		       offsets[run_end].offset == current.offset) {
+			++run_end;
+		}
+
+		idx_t size = 0;
+		if (run_end - run_start == 1) {
+			if (run_end < offsets.size() && offsets[run_end].block_id == current.block_id) {
+				// There's a next segment in this block - exact size
+				size = offsets[run_end].offset - current.offset;
+			} else {
+				// Last segment in block: upper bound
+				size = block_alloc_size - current.offset;
+			}
+		}
+		for (idx_t idx = run_start; idx < run_end; ++idx) {
+			sizes[offsets[idx].segment_idx] = size;
+		}
+		run_start = run_end;
+	}
+
+	return sizes;
+}
+
+vector<BlockAttribution> AttributeSharedBlocks(const vector<reference<const vector<ColumnSegmentInfo>>> &owners,
+                                               idx_t block_alloc_size) {
+	vector<BlockAttribution> result(owners.size());
+
+	// One flat array of main block offsets for all owners; segment_idx holds the owner here
+	vector<SegmentOffset> offsets;
+	for (idx_t owner_idx = 0; owner_idx < owners.size(); ++owner_idx) {
+		for (const auto &seg : owners[owner_idx].get()) {
+			if (seg.persistent && seg.block_id != INVALID_BLOCK) {
+				offsets.push_back(SegmentOffset {seg.block_id, seg.block_offset, owner_idx});
+			}
+		}
+	}
+	RadixSortSegmentOffsets(offsets);
+
+	BlockBitmap main_blocks;
+	idx_t block_start = 0;
+	while (block_start < offsets.size()) {
+		const auto block_id = offsets[block_start].block_id;
+		main_blocks.Set(block_id);
+
+		idx_t block_end = block_start + 1;
+		bool shared = false;
+		while (block_end < offsets.size() && offsets[block_end].block_id == block_id) {
+			shared = shared || offsets[block_end].segment_idx != offsets[block_start].segment_idx;
+			++block_end;
+		}
+
+		if (!shared) {
+			result[offsets[block_start].segment_idx].exclusive_bytes += block_alloc_size;
+		} else {
+			// The first segment also owns any bytes before it, the last one the rest of the block
+			idx_t owned_from = 0;
+			for (idx_t idx = block_start; idx < block_end; ++idx) {
+				const idx_t owned_to = idx + 1 < block_end ? offsets[idx + 1].offset : block_alloc_size;
+				result[offsets[idx].segment_idx].shared_bytes += owned_to - owned_from;
+				owned_from = owned_to;
+			}
+		}
+		block_start = block_end;
+	}
+
+	// Additional blocks hold the overflow of one large segment, they belong to its owner alone
+	BlockBitmap additional_blocks;
+	for (idx_t owner_idx = 0; owner_idx < owners.size(); ++owner_idx) {
+		for (const auto &seg : owners[owner_idx].get()) {
+			if (!seg.persistent || seg.block_id == INVALID_BLOCK) {
+				continue;
+			}
+			for (const auto &block_id : seg.additional_blocks) {
+				if (!main_blocks.Test(block_id) && additional_blocks.Set(block_id)) {
+					result[owner_idx].exclusive_bytes += block_alloc_size;
+				}
 			}
 		}
 	}
 
-	return unique_blocks.size();
+	return result;
+}
+
+vector<FreeExtent> CollectFreeExtents(const BlockBitmap &free_blocks, idx_t total_blocks) {
+	vector<FreeExtent> extents;
+	idx_t start = free_blocks.FindNext(0, total_blocks, true);
+	while (start < total_blocks) {
+		const idx_t end = free_blocks.FindNext(start, total_blocks, false);
+		extents.push_back(FreeExtent {start, end - start});
+		start = free_blocks.FindNext(end, total_blocks, true);
+	}
+	return extents;
+}
+
+idx_t GetExtentSizeBucket(idx_t block_count) {
+	D_ASSERT(block_count > 0);
+	idx_t bucket = 0;
+	while (block_count >>= 1) {
+		++bucket;
+	}
+	return bucket;
+}
+
+optional_idx ParseMaxStringLength(const string &segment_stats) {
+	static constexpr const char *MAX_STRING_LENGTH = "Max String Length: ";
+	// The entry follows the min and max values, which may contain the marker themselves
+	const auto pos = segment_stats.rfind(MAX_STRING_LENGTH);
+	if (pos == string::npos) {
+		return optional_idx();
+	}
+	const idx_t start = pos + strlen(MAX_STRING_LENGTH);
+	idx_t end = start;
+	idx_t length = 0;
+	while (end < segment_stats.size() && StringUtil::CharacterIsDigit(segment_stats[end])) {
+		length = length * 10 + static_cast<idx_t>(segment_stats[end] - '0');
+		++end;
+	}
+	if (end == start) {
+		return optional_idx();
+	}
+	return optional_idx(length);
+}
+
+bool ParseSegmentMinMax(const string &segment_stats, string &min, string &max) {
+	static constexpr const char *MIN_MARKER = "[Min: ";
+	static constexpr const char *MAX_MARKER = ", Max: ";
+	static constexpr const char *STRING_STATS_MARKER = ", Has Unicode: ";
+	if (!StringUtil::StartsWith(segment_stats, MIN_MARKER)) {
+		return false;
+	}
+	const idx_t min_start = strlen(MIN_MARKER);
+	const auto max_pos = segment_stats.find(MAX_MARKER, min_start);
+	if (max_pos == string::npos) {
+		return false;
+	}
+	const idx_t max_start = max_pos + strlen(MAX_MARKER);
+	// String statistics continue after the max value, numeric statistics end with it
+	auto max_end = segment_stats.find(STRING_STATS_MARKER, max_start);
+	if (max_end == string::npos) {
+		max_end = segment_stats.find(']', max_start);
+	}
+	if (max_end == string::npos) {
+		return false;
+	}
+	// A string bound can contain the max marker itself, which leaves no way to tell where the min ends
+	if (segment_stats.find(MAX_MARKER, max_pos + 1) < max_end) {
+		return false;
+	}
+	min = segment_stats.substr(min_start, max_pos - min_start);
+	max = segment_stats.substr(max_start, max_end - max_start);
+	// Segments without non-NULL values have no bounds
+	return min != "NULL" && max != "NULL";
 }
 
 } // namespace duckdb
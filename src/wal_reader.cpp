@@ -0,0 +1,115 @@
+#include "wal_reader.hpp"
+
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/helper.hpp"
+
+namespace duckdb {
+
+namespace {
+
+// [uint64 size][uint64 checksum] before every entry's payload
+constexpr idx_t ENTRY_HEADER_SIZE = 2 * sizeof(uint64_t);
+// The payload starts with field 100, the entry type, as a uint16 field id and a single varint byte
+constexpr idx_t ENTRY_TYPE_PREFIX_SIZE = sizeof(uint16_t) + 1;
+constexpr uint16_t ENTRY_TYPE_FIELD_ID = 100;
+
+// The log starts with the version marker, written without size and checksum: field 100 (the entry type), field 101
+// (the WAL version) and the end of the object, e.g. 64 00 62 65 00 02 FF FF
+constexpr uint16_t VERSION_FIELD_ID = 101;
+constexpr uint16_t OBJECT_END_FIELD_ID = 0xFFFF;
+// Encrypted logs (version 3) carry more fields in the marker, and their entries can't be read
+constexpr uint64_t PLAIN_WAL_VERSION = 2;
+// Enough for all fields of a plain version marker, with varints of up to 10 bytes
+constexpr idx_t MAX_VERSION_MARKER_SIZE = 3 * sizeof(uint16_t) + 2 * 10;
+
+// WALType values
+constexpr uint8_t WAL_VERSION_TYPE = 98;
+constexpr uint8_t WAL_FLUSH_TYPE = 100;
+
+// Reads the fields of the version marker; reads past the end of the data set exhausted and return 0
+struct VersionMarkerReader {
+	VersionMarkerReader(const data_t *data_p, idx_t size_p) : data(data_p), size(size_p) {
+	}
+
+	uint16_t ReadFieldId() {
+		if (position + sizeof(uint16_t) > size) {
+			exhausted = true;
+			return 0;
+		}
+		const auto field_id = Load<uint16_t>(data + position);
+		position += sizeof(uint16_t);
+		return field_id;
+	}
+
+	uint64_t ReadVarint() {
+		uint64_t result = 0;
+		for (idx_t shift = 0; shift < 64; shift += 7) {
+			if (position >= size) {
+				exhausted = true;
+				return 0;
+			}
+			const auto byte = data[position++];
+			result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80)) {
+				break;
+			}
+		}
+		return result;
+	}
+
+	const data_t *data;
+	idx_t size;
+	idx_t position = 0;
+	bool exhausted = false;
+};
+
+} // namespace
+
+WalSummary ReadWalSummary(FileSystem &fs, const string &path) {
+	WalSummary result;
+	auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ | FileFlags::FILE_FLAGS_NULL_IF_NOT_EXISTS);
+	if (!handle) {
+		return result;
+	}
+	result.file_bytes = NumericCast<idx_t>(handle->GetFileSize());
+	if (result.file_bytes == 0) {
+		return result;
+	}
+
+	data_t marker[MAX_VERSION_MARKER_SIZE];
+	const idx_t marker_bytes = MinValue(result.file_bytes, MAX_VERSION_MARKER_SIZE);
+	handle->Read(marker, marker_bytes, 0);
+	VersionMarkerReader reader(marker, marker_bytes);
+	const bool is_plain_marker =
+	    reader.ReadFieldId() == ENTRY_TYPE_FIELD_ID && reader.ReadVarint() == WAL_VERSION_TYPE &&
+	    reader.ReadFieldId() == VERSION_FIELD_ID && reader.ReadVarint() == PLAIN_WAL_VERSION &&
+	    reader.ReadFieldId() == OBJECT_END_FIELD_ID;
+	if (!is_plain_marker) {
+		// A marker that is still being written leaves the whole file as trailing bytes
+		result.readable = reader.exhausted;
+		result.trailing_bytes = result.file_bytes;
+		return result;
+	}
+
+	idx_t offset = reader.position;
+	while (offset + ENTRY_HEADER_SIZE + ENTRY_TYPE_PREFIX_SIZE <= result.file_bytes) {
+		data_t header[ENTRY_HEADER_SIZE + ENTRY_TYPE_PREFIX_SIZE];
+		handle->Read(header, sizeof(header), offset);
+		const auto payload_size = Load<uint64_t>(header);
+		// An entry that is still being written ends the log, as does garbage after the last entry
+		if (payload_size < ENTRY_TYPE_PREFIX_SIZE || payload_size > result.file_bytes - offset - ENTRY_HEADER_SIZE ||
+		    Load<uint16_t>(header + ENTRY_HEADER_SIZE) != ENTRY_TYPE_FIELD_ID) {
+			break;
+		}
+
+		result.entry_count++;
+		if (header[ENTRY_HEADER_SIZE + sizeof(uint16_t)] == WAL_FLUSH_TYPE) {
+			result.commit_count++;
+		}
+		offset += ENTRY_HEADER_SIZE + payload_size;
+	}
+	result.trailing_bytes = result.file_bytes - offset;
+	return result;
+}
+
+} // namespace duckdb
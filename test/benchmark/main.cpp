@@ -0,0 +1,392 @@
+//===--------------------------------------------------------------------===//
+// benchmark_table_inspector - Latency and memory of the inspector functions
+//===--------------------------------------------------------------------===//
+
+// Generates synthetic databases that stress the inspector functions, and times every function on each of them:
+// - many_tables: thousands of small tables, stressing per-table catalog and segment collection overhead
+// - wide_table: one table with hundreds of columns
+// - many_segments: a table stored in minimal row groups, with one segment per column and row group
+// Each function is run on a freshly opened database (cold: nothing cached) and again on the same connection (warm).
+// Reported per run: wall time, peak resident set size, and the number and bytes of operator new allocations.
+//
+// Usage: benchmark_table_inspector [--dir PATH] [--scale N] [--repetitions N] [--filter SUBSTRING] [--csv]
+// Generated databases are kept in --dir and reused by later runs with the same scale.
+
+#include "table_inspector_extension.hpp"
+
+#include "duckdb.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/string_util.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sys/resource.h>
+
+namespace {
+
+std::atomic<uint64_t> allocation_count {0};
+std::atomic<uint64_t> allocated_bytes {0};
+
+void *CountedAllocate(std::size_t size) {
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+	// operator new can't allocate through itself
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+} // namespace
+
+// Counts every operator new of the process, including DuckDB's. Buffer manager memory is allocated through DuckDB's
+// Allocator instead and is covered by the peak RSS.
+void *operator new(std::size_t size) {
+	auto result = CountedAllocate(size);
+	if (!result) {
+		throw std::bad_alloc();
+	}
+	return result;
+}
+
+void *operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+	return CountedAllocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+	return CountedAllocate(size);
+}
+
+void operator delete(void *ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+namespace duckdb {
+
+namespace {
+
+constexpr idx_t MANY_TABLES_COUNT = 2000;
+constexpr idx_t MANY_TABLES_ROWS = 1000;
+constexpr idx_t WIDE_TABLE_COLUMNS = 500;
+constexpr idx_t WIDE_TABLE_ROWS = 100000;
+// Smallest row group size DuckDB accepts: one vector
+constexpr idx_t MANY_SEGMENTS_ROW_GROUP_SIZE = 2048;
+// 20000 row groups of 50 columns, 1M segments at scale 1. Booleans keep the file small: a segment takes ~256 bytes.
+constexpr idx_t MANY_SEGMENTS_COLUMNS = 50;
+constexpr idx_t MANY_SEGMENTS_ROWS = 20000 * MANY_SEGMENTS_ROW_GROUP_SIZE;
+constexpr double BYTES_PER_MB = 1024.0 * 1024.0;
+
+struct BenchmarkOptions {
+	string directory = "benchmark_data";
+	idx_t scale = 1;
+	idx_t repetitions = 3;
+	string filter;
+	bool csv = false;
+};
+
+// A generated database and the column inspect_column() is timed on
+struct Dataset {
+	string name;
+	string table_name;
+	string column_name;
+	// ATTACH options to create the database with
+	string attach_options;
+	// Statements creating the contents of the database, run in order against the attached database
+	vector<string> statements;
+};
+
+struct Measurement {
+	double wall_ms = 0;
+	double peak_rss_mb = 0;
+	uint64_t allocations = 0;
+	double allocated_mb = 0;
+};
+
+// Resets the peak RSS of the process, so the next ReadPeakRssMb() reports the peak of one run. Only Linux can
+// reset it; elsewhere the peak of the whole process so far is reported.
+void ResetPeakRss() {
+	std::ofstream clear_refs("/proc/self/clear_refs");
+	if (clear_refs) {
+		clear_refs << "5";
+	}
+}
+
+double ReadPeakRssMb() {
+	std::ifstream status("/proc/self/status");
+	string line;
+	while (std::getline(status, line)) {
+		if (StringUtil::StartsWith(line, "VmHWM:")) {
+			// "VmHWM:    123456 kB"
+			return static_cast<double>(std::stoull(line.substr(6))) / 1024.0;
+		}
+	}
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	// ru_maxrss is in kilobytes on Linux and in bytes on macOS
+#ifdef __APPLE__
+	return static_cast<double>(usage.ru_maxrss) / BYTES_PER_MB;
+#else
+	return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#endif
+}
+
+void CheckResult(const MaterializedQueryResult &result, const string &query) {
+	if (result.HasError()) {
+		throw std::runtime_error(StringUtil::Format("Query failed: %s\n%s", query, result.GetError()));
+	}
+}
+
+Measurement Measure(Connection &con, const string &query) {
+	Measurement result;
+	ResetPeakRss();
+	const auto allocations_before = allocation_count.load();
+	const auto bytes_before = allocated_bytes.load();
+	const auto start = std::chrono::steady_clock::now();
+
+	auto query_result = con.Query(query);
+
+	const auto end = std::chrono::steady_clock::now();
+	CheckResult(*query_result, query);
+	result.wall_ms = std::chrono::duration<double, std::milli>(end - start).count();
+	result.peak_rss_mb = ReadPeakRssMb();
+	result.allocations = allocation_count.load() - allocations_before;
+	result.allocated_mb = static_cast<double>(allocated_bytes.load() - bytes_before) / BYTES_PER_MB;
+	return result;
+}
+
+vector<Dataset> BuildDatasets(idx_t scale) {
+	vector<Dataset> result;
+
+	Dataset many_tables;
+	many_tables.name = "many_tables";
+	many_tables.table_name = "t0";
+	many_tables.column_name = "id";
+	for (idx_t table_idx = 0; table_idx < MANY_TABLES_COUNT * scale; ++table_idx) {
+		many_tables.statements.push_back(StringUtil::Format(
+		    "CREATE TABLE t%llu AS SELECT i AS id, i * 2 AS value, 'name_' || i::VARCHAR AS name, i %% 7 = 0 AS flag "
+		    "FROM range(%llu) r(i)",
+		    table_idx, MANY_TABLES_ROWS));
+	}
+	result.push_back(std::move(many_tables));
+
+	Dataset wide_table;
+	wide_table.name = "wide_table";
+	wide_table.table_name = "wide";
+	wide_table.column_name = StringUtil::Format("c%llu", WIDE_TABLE_COLUMNS / 2);
+	vector<string> wide_columns;
+	for (idx_t column_idx = 0; column_idx < WIDE_TABLE_COLUMNS; ++column_idx) {
+		// Alternate types, so the table has both fixed-size and string segments
+		if (column_idx % 4 == 3) {
+			wide_columns.push_back(StringUtil::Format("(i + %llu)::VARCHAR AS c%llu", column_idx, column_idx));
+		} else {
+			wide_columns.push_back(StringUtil::Format("i * %llu AS c%llu", column_idx + 1, column_idx));
+		}
+	}
+	wide_table.statements.push_back(StringUtil::Format("CREATE TABLE wide AS SELECT %s FROM range(%llu) r(i)",
+	                                                   StringUtil::Join(wide_columns, ", "),
+	                                                   WIDE_TABLE_ROWS * scale));
+	result.push_back(std::move(wide_table));
+
+	Dataset many_segments;
+	many_segments.name = "many_segments";
+	many_segments.table_name = "segments";
+	many_segments.column_name = "c0";
+	many_segments.attach_options = StringUtil::Format("(ROW_GROUP_SIZE %llu)", MANY_SEGMENTS_ROW_GROUP_SIZE);
+	vector<string> segment_columns;
+	for (idx_t column_idx = 0; column_idx < MANY_SEGMENTS_COLUMNS; ++column_idx) {
+		// Not constant, so every segment is stored in a block
+		segment_columns.push_back(StringUtil::Format("(i + %llu) %% 3 = 0 AS c%llu", column_idx, column_idx));
+	}
+	many_segments.statements.push_back(StringUtil::Format("CREATE TABLE segments AS SELECT %s FROM range(%llu) r(i)",
+	                                                      StringUtil::Join(segment_columns, ", "),
+	                                                      MANY_SEGMENTS_ROWS * scale));
+	result.push_back(std::move(many_segments));
+
+	return result;
+}
+
+string DatabasePath(const BenchmarkOptions &options, const Dataset &dataset) {
+	return StringUtil::Format("%s/%s_scale%llu.duckdb", options.directory, dataset.name, options.scale);
+}
+
+string AttachStatement(const string &path, const string &options = string()) {
+	return StringUtil::Format("ATTACH '%s' AS bench %s", path, options);
+}
+
+void OpenDatabase(DuckDB &db) {
+	db.LoadStaticExtension<TableInspectorExtension>();
+}
+
+// Creates the database of a dataset unless an earlier run already did. Databases are written to a temporary path
+// and renamed when complete, so an interrupted generation is not reused.
+void GenerateDataset(const BenchmarkOptions &options, const Dataset &dataset) {
+	const auto path = DatabasePath(options, dataset);
+	auto fs = FileSystem::CreateLocal();
+	if (fs->FileExists(path)) {
+		return;
+	}
+	if (!fs->DirectoryExists(options.directory)) {
+		fs->CreateDirectory(options.directory);
+	}
+	const auto temp_path = path + ".tmp";
+	fs->TryRemoveFile(temp_path);
+	fs->TryRemoveFile(temp_path + ".wal");
+
+	fprintf(stderr, "Generating %s...\n", path.c_str());
+	DuckDB db(nullptr);
+	Connection con(db);
+	CheckResult(*con.Query(AttachStatement(temp_path, dataset.attach_options)), "ATTACH");
+	CheckResult(*con.Query("USE bench"), "USE");
+	CheckResult(*con.Query("BEGIN"), "BEGIN");
+	for (const auto &statement : dataset.statements) {
+		CheckResult(*con.Query(statement), statement);
+	}
+	CheckResult(*con.Query("COMMIT"), "COMMIT");
+	CheckResult(*con.Query("USE memory"), "USE");
+	CheckResult(*con.Query("DETACH bench"), "DETACH");
+	fs->MoveFile(temp_path, path);
+}
+
+vector<std::pair<string, string>> BuildQueries(const Dataset &dataset) {
+	// Results are aggregated, so only the inspection is timed, not the output
+	return {
+	    {"inspect_database", "SELECT COUNT(*) FROM inspect_database('bench')"},
+	    {"inspect_column", StringUtil::Format("SELECT COUNT(*) FROM inspect_column('bench', '%s', '%s')",
+	                                          dataset.table_name, dataset.column_name)},
+	    {"inspect_block_usage", "SELECT COUNT(*) FROM inspect_block_usage('bench')"},
+	    {"inspect_storage", "SELECT COUNT(*) FROM inspect_storage()"},
+	};
+}
+
+double Median(vector<double> values) {
+	std::sort(values.begin(), values.end());
+	const auto middle = values.size() / 2;
+	return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+void PrintHeader(const BenchmarkOptions &options) {
+	if (options.csv) {
+		printf("dataset,function,run,wall_ms_median,wall_ms_min,peak_rss_mb,allocations,allocated_mb\n");
+		return;
+	}
+	printf("%-14s %-20s %-5s %14s %12s %12s %12s %13s\n", "dataset", "function", "run", "wall_ms_median",
+	       "wall_ms_min", "peak_rss_mb", "allocations", "allocated_mb");
+}
+
+// Reports the median and minimum wall time of the repetitions, and the largest memory figures
+void PrintMeasurements(const BenchmarkOptions &options, const string &dataset, const string &function,
+                       const string &run, const vector<Measurement> &measurements) {
+	vector<double> wall_times;
+	Measurement worst;
+	for (const auto &measurement : measurements) {
+		wall_times.push_back(measurement.wall_ms);
+		worst.peak_rss_mb = MaxValue(worst.peak_rss_mb, measurement.peak_rss_mb);
+		worst.allocations = MaxValue(worst.allocations, measurement.allocations);
+		worst.allocated_mb = MaxValue(worst.allocated_mb, measurement.allocated_mb);
+	}
+	const auto median = Median(wall_times);
+	const auto min = *std::min_element(wall_times.begin(), wall_times.end());
+	if (options.csv) {
+		printf("%s,%s,%s,%.3f,%.3f,%.1f,%llu,%.1f\n", dataset.c_str(), function.c_str(), run.c_str(), median, min,
+		       worst.peak_rss_mb, static_cast<unsigned long long>(worst.allocations), worst.allocated_mb);
+	} else {
+		printf("%-14s %-20s %-5s %14.3f %12.3f %12.1f %12llu %13.1f\n", dataset.c_str(), function.c_str(),
+		       run.c_str(), median, min, worst.peak_rss_mb, static_cast<unsigned long long>(worst.allocations),
+		       worst.allocated_mb);
+	}
+	fflush(stdout);
+}
+
+void RunDataset(const BenchmarkOptions &options, const Dataset &dataset) {
+	const auto path = DatabasePath(options, dataset);
+	for (const auto &query : BuildQueries(dataset)) {
+		vector<Measurement> cold;
+		vector<Measurement> warm;
+		for (idx_t repetition = 0; repetition < options.repetitions; ++repetition) {
+			// A new instance per repetition, so the segment snapshot and result caches start out empty
+			DuckDB db(nullptr);
+			OpenDatabase(db);
+			Connection con(db);
+			CheckResult(*con.Query(AttachStatement(path)), "ATTACH");
+			cold.push_back(Measure(con, query.second));
+			warm.push_back(Measure(con, query.second));
+		}
+		PrintMeasurements(options, dataset.name, query.first, "cold", cold);
+		PrintMeasurements(options, dataset.name, query.first, "warm", warm);
+	}
+}
+
+idx_t ParsePositive(const string &flag, const string &value) {
+	const auto result = std::stoll(value);
+	if (result <= 0) {
+		throw std::invalid_argument(flag + " must be positive");
+	}
+	return static_cast<idx_t>(result);
+}
+
+BenchmarkOptions ParseOptions(int argc, char *argv[]) {
+	BenchmarkOptions result;
+	for (int arg_idx = 1; arg_idx < argc; ++arg_idx) {
+		const string arg = argv[arg_idx];
+		if (arg == "--csv") {
+			result.csv = true;
+			continue;
+		}
+		if (arg_idx + 1 >= argc) {
+			throw std::invalid_argument("Unknown option or missing value: " + arg);
+		}
+		const string value = argv[++arg_idx];
+		if (arg == "--dir") {
+			result.directory = value;
+		} else if (arg == "--scale") {
+			result.scale = ParsePositive(arg, value);
+		} else if (arg == "--repetitions") {
+			result.repetitions = ParsePositive(arg, value);
+		} else if (arg == "--filter") {
+			result.filter = value;
+		} else {
+			throw std::invalid_argument("Unknown option: " + arg);
+		}
+	}
+	return result;
+}
+
+} // namespace
+
+} // namespace duckdb
+
+int main(int argc, char *argv[]) {
+	try {
+		const auto options = duckdb::ParseOptions(argc, argv);
+		duckdb::PrintHeader(options);
+		for (const auto &dataset : duckdb::BuildDatasets(options.scale)) {
+			if (!options.filter.empty() && dataset.name.find(options.filter) == std::string::npos) {
+				continue;
+			}
+			duckdb::GenerateDataset(options, dataset);
+			duckdb::RunDataset(options, dataset);
+		}
+	} catch (std::exception &ex) {
+		fprintf(stderr, "%s\n", ex.what());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,95 @@
+#include "catch/catch.hpp"
+
+#include "block_bitmap.hpp"
+
+using namespace duckdb; // NOLINT
+
+TEST_CASE("BlockBitmap tracks unique block IDs", "[block_bitmap]") {
+	BlockBitmap bitmap(100);
+	REQUIRE(bitmap.Count() == 0);
+	REQUIRE(bitmap.Capacity() >= 100);
+
+	// Duplicates are only counted once.
+	REQUIRE(bitmap.Set(3));
+	REQUIRE(bitmap.Set(64));
+	REQUIRE_FALSE(bitmap.Set(3));
+	REQUIRE(bitmap.Count() == 2);
+	REQUIRE(bitmap.Test(3));
+	REQUIRE(bitmap.Test(64));
+	REQUIRE_FALSE(bitmap.Test(4));
+
+	// Out of range lookups are not set.
+	REQUIRE_FALSE(bitmap.Test(-1));
+	REQUIRE_FALSE(bitmap.Test(100000));
+}
+
+TEST_CASE("BlockBitmap grows beyond its initial capacity", "[block_bitmap]") {
+	BlockBitmap bitmap;
+	REQUIRE(bitmap.Capacity() == 0);
+
+	REQUIRE(bitmap.Set(1000));
+	REQUIRE(bitmap.Capacity() > 1000);
+	REQUIRE(bitmap.Test(1000));
+	REQUIRE(bitmap.Count() == 1);
+}
+
+TEST_CASE("BlockBitmap clear keeps capacity", "[block_bitmap]") {
+	BlockBitmap bitmap(256);
+	bitmap.Set(10);
+	bitmap.Set(200);
+	const auto capacity = bitmap.Capacity();
+
+	bitmap.Clear();
+	REQUIRE(bitmap.Count() == 0);
+	REQUIRE_FALSE(bitmap.Test(10));
+	REQUIRE_FALSE(bitmap.Test(200));
+	REQUIRE(bitmap.Capacity() == capacity);
+
+	// Reuse after clear.
+	REQUIRE(bitmap.Set(10));
+	REQUIRE(bitmap.Count() == 1);
+}
+
+TEST_CASE("BlockBitmap union and intersection", "[block_bitmap]") {
+	BlockBitmap lhs(128);
+	BlockBitmap rhs(128);
+	lhs.Set(1);
+	lhs.Set(2);
+	lhs.Set(70);
+	rhs.Set(2);
+	rhs.Set(70);
+	rhs.Set(500);
+
+	REQUIRE(lhs.IntersectionCount(rhs) == 2);
+	REQUIRE(rhs.IntersectionCount(lhs) == 2);
+
+	BlockBitmap union_result(128);
+	union_result.Union(lhs);
+	union_result.Union(rhs);
+	REQUIRE(union_result.Count() == 4);
+	REQUIRE(union_result.Test(500));
+
+	lhs.Intersect(rhs);
+	REQUIRE(lhs.Count() == 2);
+	REQUIRE_FALSE(lhs.Test(1));
+	REQUIRE(lhs.Test(2));
+	REQUIRE(lhs.Test(70));
+}
+
+TEST_CASE("BlockBitmap finds runs of set and unset blocks", "[block_bitmap]") {
+	BlockBitmap bitmap(200);
+	for (block_id_t block_id = 10; block_id < 70; ++block_id) {
+		bitmap.Set(block_id);
+	}
+	bitmap.Set(150);
+
+	REQUIRE(bitmap.FindNext(0, 200, true) == 10);
+	REQUIRE(bitmap.FindNext(10, 200, false) == 70);
+	REQUIRE(bitmap.FindNext(70, 200, true) == 150);
+	REQUIRE(bitmap.FindNext(151, 200, true) == 200);
+	REQUIRE(bitmap.FindNext(0, 5, true) == 5);
+
+	// Blocks beyond the capacity are unset.
+	REQUIRE(bitmap.FindNext(151, 1000, false) == 151);
+	REQUIRE(bitmap.FindNext(300, 1000, true) == 1000);
+}
@@ -0,0 +1,22 @@
+#include "catch/catch.hpp"
+
+#include "inspection_deadline.hpp"
+
+using namespace duckdb; // NOLINT
+
+TEST_CASE("InspectionDeadline passes after its timeout", "[inspection_deadline]") {
+	// Without a timeout the deadline never passes.
+	InspectionDeadline unbounded;
+	REQUIRE(!unbounded.HasTimeout());
+	REQUIRE(!unbounded.Passed());
+	REQUIRE(!InspectionDeadline::Start(optional_idx()).Passed());
+
+	// A zero timeout has passed right away.
+	const auto expired = InspectionDeadline::Start(0);
+	REQUIRE(expired.HasTimeout());
+	REQUIRE(expired.Passed());
+
+	const auto pending = InspectionDeadline::Start(3600000);
+	REQUIRE(pending.HasTimeout());
+	REQUIRE(!pending.Passed());
+}
@@ -0,0 +1,47 @@
+#include "catch/catch.hpp"
+
+#include "inspection_profile.hpp"
+
+using namespace duckdb; // NOLINT
+
+TEST_CASE("InspectionProfile sums phase times and counters", "[inspection_profile]") {
+	InspectionProfile profile("inspect_database", "db");
+	profile.AddTime(InspectionPhase::SEGMENT_COLLECTION, 1500000);
+	profile.AddTime(InspectionPhase::SEGMENT_COLLECTION, 500000);
+	profile.Add(InspectionCounter::TABLES_VISITED, 2);
+	profile.Add(InspectionCounter::TABLES_VISITED, 1);
+	{
+		ScopedPhaseTimer timer(&profile, InspectionPhase::INDEX_WALK);
+	}
+	// Without a profile the timer does nothing.
+	{
+		ScopedPhaseTimer timer(nullptr, InspectionPhase::INDEX_WALK);
+	}
+	profile.Finish();
+
+	// Wall time first, then every phase and counter.
+	const auto metrics = profile.GetMetrics();
+	REQUIRE(metrics.size() == 1 + INSPECTION_PHASE_COUNT + INSPECTION_COUNTER_COUNT);
+	REQUIRE(metrics[0].name == "wall_time");
+	REQUIRE(metrics[0].value >= 0);
+	for (const auto &metric : metrics) {
+		if (metric.name == "segment_collection") {
+			REQUIRE(metric.value == Approx(2.0));
+			REQUIRE(string(metric.unit) == "ms");
+		} else if (metric.name == "tables_visited") {
+			REQUIRE(metric.value == 3);
+			REQUIRE(string(metric.unit) == "count");
+		} else if (metric.name == "index_walk") {
+			REQUIRE(metric.value >= 0);
+		} else if (metric.name != "wall_time") {
+			REQUIRE(metric.value == 0);
+		}
+	}
+
+	// The profiler output leaves out the wall time, the operator timing covers it.
+	const auto info = profile.ToProfilerInfo();
+	REQUIRE(info.size() == INSPECTION_PHASE_COUNT + INSPECTION_COUNTER_COUNT);
+	REQUIRE(info.find("wall_time") == info.end());
+	REQUIRE(info.find("tables_visited")->second == "3");
+	REQUIRE(info.find("segment_collection")->second == "2.000 ms");
+}
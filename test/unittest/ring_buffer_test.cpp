@@ -0,0 +1,46 @@
+#include "catch/catch.hpp"
+
+#include "ring_buffer.hpp"
+
+using namespace duckdb; // NOLINT
+
+TEST_CASE("RingBuffer keeps elements oldest first", "[ring_buffer]") {
+	RingBuffer<idx_t> buffer(3);
+	REQUIRE(buffer.Capacity() == 3);
+	REQUIRE(buffer.Size() == 0);
+	REQUIRE(buffer.ToVector().empty());
+
+	buffer.Push(1);
+	buffer.Push(2);
+	REQUIRE(buffer.Size() == 2);
+	REQUIRE(!buffer.IsFull());
+	REQUIRE(buffer[0] == 1);
+	REQUIRE(buffer[1] == 2);
+}
+
+TEST_CASE("RingBuffer overwrites the oldest element once full", "[ring_buffer]") {
+	RingBuffer<idx_t> buffer(3);
+	for (idx_t i = 1; i <= 7; ++i) {
+		buffer.Push(i);
+	}
+	REQUIRE(buffer.IsFull());
+	REQUIRE(buffer.Size() == 3);
+	REQUIRE(buffer.DroppedCount() == 4);
+	REQUIRE(buffer.ToVector() == vector<idx_t> {5, 6, 7});
+
+	// Clearing keeps the capacity, and wraps around from the start again.
+	buffer.Clear();
+	REQUIRE(buffer.Size() == 0);
+	buffer.Push(8);
+	REQUIRE(buffer.ToVector() == vector<idx_t> {8});
+	REQUIRE(buffer.Capacity() == 3);
+}
+
+TEST_CASE("RingBuffer moves non-trivial elements", "[ring_buffer]") {
+	RingBuffer<string> buffer(2);
+	buffer.Push("a");
+	buffer.Push("b");
+	buffer.Push("c");
+	REQUIRE(buffer[0] == "b");
+	REQUIRE(buffer[1] == "c");
+}
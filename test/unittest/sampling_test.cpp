@@ -0,0 +1,119 @@
+#include "catch/catch.hpp"
+
+#include "sampling.hpp"
+
+#include <cmath>
+
+using namespace duckdb; // NOLINT
+
+TEST_CASE("RowGroupSampling sizes the sample", "[sampling]") {
+	RowGroupSampling sampling;
+	REQUIRE(sampling.SampleSize(10) == 10);
+
+	// Rounds up, and samples at least one row group of a non-empty table.
+	sampling.fraction = 0.25;
+	REQUIRE(sampling.SampleSize(10) == 3);
+	REQUIRE(sampling.SampleSize(1) == 1);
+	REQUIRE(sampling.SampleSize(0) == 0);
+
+	// max_row_groups caps the fraction.
+	sampling.max_row_groups = 2;
+	REQUIRE(sampling.SampleSize(10) == 2);
+
+	// max_row_groups alone.
+	RowGroupSampling capped;
+	capped.max_row_groups = 4;
+	REQUIRE(capped.SampleSize(100) == 4);
+	REQUIRE(capped.SampleSize(3) == 3);
+}
+
+TEST_CASE("RowGroupSampling picks one row group per stratum", "[sampling]") {
+	RowGroupSampling sampling;
+	sampling.max_row_groups = 3;
+
+	const auto sample = sampling.SelectRowGroups(10, 42);
+	REQUIRE(sample.size() == 3);
+	// Strata [0, 3), [3, 6), [6, 10).
+	REQUIRE(sample[0].row_group_index < 3);
+	REQUIRE(sample[1].row_group_index >= 3);
+	REQUIRE(sample[1].row_group_index < 6);
+	REQUIRE(sample[2].row_group_index >= 6);
+	REQUIRE(sample[2].row_group_index < 10);
+	REQUIRE(sample[0].weight + sample[1].weight + sample[2].weight == 10);
+
+	// The same seed gives the same sample.
+	const auto repeated = sampling.SelectRowGroups(10, 42);
+	for (idx_t i = 0; i < sample.size(); ++i) {
+		REQUIRE(repeated[i].row_group_index == sample[i].row_group_index);
+	}
+
+	// Sampling every row group selects all of them.
+	sampling.max_row_groups = 10;
+	const auto full = sampling.SelectRowGroups(10, 42);
+	for (idx_t i = 0; i < full.size(); ++i) {
+		REQUIRE(full[i].row_group_index == i);
+		REQUIRE(full[i].weight == 1);
+	}
+}
+
+TEST_CASE("ExtrapolateTotal estimates totals with a confidence interval", "[sampling]") {
+	// Two of four row groups, each standing for two.
+	vector<SampledRowGroup> sample {{0, 2}, {2, 2}};
+	auto estimate = ExtrapolateTotal(sample, {100, 300}, 4);
+	REQUIRE(estimate.estimate == Approx(800));
+	REQUIRE(estimate.sampled_total == Approx(400));
+	REQUIRE(estimate.has_variance);
+	// s^2 = 20000, variance = 4^2 * (1 - 2/4) * 20000 / 2.
+	REQUIRE(estimate.variance == Approx(80000));
+	REQUIRE(estimate.High() == Approx(800 + 1.96 * std::sqrt(80000.0)));
+	// The sampled values bound the total from below.
+	REQUIRE(estimate.Low() == Approx(400));
+
+	// Equal values have no spread.
+	estimate = ExtrapolateTotal(sample, {200, 200}, 4);
+	REQUIRE(estimate.Low() == Approx(800));
+	REQUIRE(estimate.High() == Approx(800));
+
+	// A fully inspected table is exact.
+	estimate = ExtrapolateTotal({{0, 1}, {1, 1}}, {100, 300}, 2);
+	REQUIRE(estimate.estimate == Approx(400));
+	REQUIRE(estimate.variance == 0);
+
+	// A single sampled row group has no interval.
+	estimate = ExtrapolateTotal({{3, 8}}, {50}, 8);
+	REQUIRE(estimate.estimate == Approx(400));
+	REQUIRE(!estimate.has_variance);
+
+	// Combining tables sums estimates and variances.
+	auto combined = ExtrapolateTotal(sample, {100, 300}, 4);
+	combined.Add(ExtrapolateTotal(sample, {100, 300}, 4));
+	REQUIRE(combined.estimate == Approx(1600));
+	REQUIRE(combined.variance == Approx(160000));
+	combined.Add(ExtrapolateTotal({{3, 8}}, {50}, 8));
+	REQUIRE(!combined.has_variance);
+}
+
+TEST_CASE("CalculateRowGroupSizes sums segment sizes per row group", "[sampling]") {
+	vector<ColumnSegmentInfo> segments(3);
+	// Two segments sharing block 1, in row groups 0 and 1.
+	segments[0].persistent = true;
+	segments[0].block_id = 1;
+	segments[0].block_offset = 0;
+	segments[0].row_group_index = 0;
+	segments[1].persistent = true;
+	segments[1].block_id = 1;
+	segments[1].block_offset = 1000;
+	segments[1].row_group_index = 1;
+	// A large segment in row group 1 spilling into an additional block.
+	segments[2].persistent = true;
+	segments[2].block_id = 2;
+	segments[2].block_offset = 0;
+	segments[2].row_group_index = 1;
+	segments[2].additional_blocks = {3};
+
+	REQUIRE(CountRowGroups(segments) == 2);
+	const auto sizes = CalculateRowGroupSizes(segments, 4096);
+	REQUIRE(sizes.size() == 2);
+	REQUIRE(sizes[0] == 1000);
+	REQUIRE(sizes[1] == (4096 - 1000) + 4096 * 2);
+}
@@ -23,3 +23,178 @@ TEST_CASE("FormatPercentage formats block percentages", "[util]") {
 	REQUIRE(FormatPercentage(1, 3) == "33.3%");
 	REQUIRE(FormatPercentage(2, 3) == "66.7%");
 }
+
+TEST_CASE("CountUniqueBlocks counts persistent blocks once", "[util]") {
+	vector<ColumnSegmentInfo> segments(4);
+	// Two segments sharing block 1.
+	segments[0].persistent = true;
+	segments[0].block_id = 1;
+	segments[1].persistent = true;
+	segments[1].block_id = 1;
+	// A large segment spanning additional blocks.
+	segments[2].persistent = true;
+	segments[2].block_id = 2;
+	segments[2].additional_blocks = {3, 4};
+	// Transient segments are ignored.
+	segments[3].persistent = false;
+	segments[3].block_id = 5;
+
+	BlockBitmap blocks;
+	REQUIRE(CountUniqueBlocks(segments, blocks) == 4);
+
+	// The bitmap is scratch space, reusing it doesn't carry blocks over.
+	segments.resize(1);
+	REQUIRE(CountUniqueBlocks(segments, blocks) == 1);
+}
+
+TEST_CASE("RadixSortSegmentOffsets sorts by block and offset", "[util]") {
+	vector<SegmentOffset> offsets;
+	offsets.push_back(SegmentOffset {300, 70000, 0});
+	offsets.push_back(SegmentOffset {2, 10, 1});
+	offsets.push_back(SegmentOffset {300, 5, 2});
+	offsets.push_back(SegmentOffset {2, 0, 3});
+	offsets.push_back(SegmentOffset {0, 4096, 4});
+
+	RadixSortSegmentOffsets(offsets);
+
+	vector<idx_t> order;
+	for (const auto &entry : offsets) {
+		order.push_back(entry.segment_idx);
+	}
+	REQUIRE(order == vector<idx_t> {4, 3, 1, 2, 0});
+}
+
+TEST_CASE("CalculateSegmentSizes uses the next offset in the same block", "[util]") {
+	constexpr idx_t BLOCK_ALLOC_SIZE = 1000;
+
+	vector<ColumnSegmentInfo> segments(5);
+	for (auto &seg : segments) {
+		seg.persistent = true;
+	}
+	// Block 1 holds three segments, listed out of order.
+	segments[0].block_id = 1;
+	segments[0].block_offset = 300;
+	segments[1].block_id = 1;
+	segments[1].block_offset = 0;
+	segments[2].block_id = 1;
+	segments[2].block_offset = 100;
+	// Block 2 holds a single segment.
+	segments[3].block_id = 2;
+	segments[3].block_offset = 0;
+	// Transient segment.
+	segments[4].persistent = false;
+	segments[4].block_id = 1;
+	segments[4].block_offset = 200;
+
+	const auto sizes = CalculateSegmentSizes(segments, BLOCK_ALLOC_SIZE);
+	REQUIRE(sizes == vector<idx_t> {700, 100, 200, 1000, 0});
+}
+
+TEST_CASE("AttributeSharedBlocks splits shared blocks at segment offsets", "[util]") {
+	constexpr idx_t BLOCK_ALLOC_SIZE = 1000;
+
+	// Owner 0 has block 1 to itself, plus an additional block 5.
+	vector<ColumnSegmentInfo> first(3);
+	for (auto &seg : first) {
+		seg.persistent = true;
+	}
+	first[0].block_id = 1;
+	first[0].block_offset = 0;
+	first[0].additional_blocks = {5};
+	first[1].block_id = 1;
+	first[1].block_offset = 500;
+	// Block 2 is shared with owner 1.
+	first[2].block_id = 2;
+	first[2].block_offset = 0;
+
+	vector<ColumnSegmentInfo> second(2);
+	for (auto &seg : second) {
+		seg.persistent = true;
+	}
+	second[0].block_id = 2;
+	second[0].block_offset = 400;
+	// Transient segments are ignored.
+	second[1].persistent = false;
+	second[1].block_id = 3;
+
+	vector<reference<const vector<ColumnSegmentInfo>>> owners {first, second};
+	const auto result = AttributeSharedBlocks(owners, BLOCK_ALLOC_SIZE);
+	REQUIRE(result.size() == 2);
+	REQUIRE(result[0].exclusive_bytes == 2000);
+	REQUIRE(result[0].shared_bytes == 400);
+	REQUIRE(result[1].exclusive_bytes == 0);
+	REQUIRE(result[1].shared_bytes == 600);
+
+	// All referenced blocks are attributed exactly once.
+	REQUIRE(result[0].exclusive_bytes + result[0].shared_bytes + result[1].exclusive_bytes + result[1].shared_bytes ==
+	        3 * BLOCK_ALLOC_SIZE);
+}
+
+TEST_CASE("CollectFreeExtents finds runs of free blocks", "[util]") {
+	BlockBitmap free_blocks(100);
+	// Extents [2, 5), [64, 66) and a trailing extent [95, 100).
+	for (block_id_t block_id : {2, 3, 4, 64, 65, 95, 96, 97, 98, 99}) {
+		free_blocks.Set(block_id);
+	}
+
+	const auto extents = CollectFreeExtents(free_blocks, 100);
+	REQUIRE(extents.size() == 3);
+	REQUIRE(extents[0].start_block == 2);
+	REQUIRE(extents[0].block_count == 3);
+	REQUIRE(extents[1].start_block == 64);
+	REQUIRE(extents[1].block_count == 2);
+	REQUIRE(extents[2].start_block == 95);
+	REQUIRE(extents[2].block_count == 5);
+
+	// No free blocks.
+	REQUIRE(CollectFreeExtents(BlockBitmap(100), 100).empty());
+}
+
+TEST_CASE("GetExtentSizeBucket groups lengths by powers of two", "[util]") {
+	REQUIRE(GetExtentSizeBucket(1) == 0);
+	REQUIRE(GetExtentSizeBucket(2) == 1);
+	REQUIRE(GetExtentSizeBucket(3) == 1);
+	REQUIRE(GetExtentSizeBucket(4) == 2);
+	REQUIRE(GetExtentSizeBucket(1023) == 9);
+	REQUIRE(GetExtentSizeBucket(1024) == 10);
+}
+
+TEST_CASE("ParseMaxStringLength reads string segment statistics", "[util]") {
+	REQUIRE(ParseMaxStringLength("[Min: a, Max: zz, Has Unicode: false, Max String Length: 12][Has Null: false, Has No "
+	                             "Null: true]")
+	            .GetIndex() == 12);
+
+	// Min and max values containing the marker.
+	REQUIRE(ParseMaxStringLength("[Min: Max String Length: 99, Max: x, Has Unicode: false, Max String Length: 3]")
+	            .GetIndex() == 3);
+
+	// Unknown length and non-string statistics.
+	REQUIRE(!ParseMaxStringLength("[Min: a, Max: z, Has Unicode: false, Max String Length: ?]").IsValid());
+	REQUIRE(!ParseMaxStringLength("[Min: 0, Max: 99][Has Null: false, Has No Null: true]").IsValid());
+}
+
+TEST_CASE("ParseSegmentMinMax reads segment bounds", "[util]") {
+	string min;
+	string max;
+	REQUIRE(ParseSegmentMinMax("[Min: -5, Max: 122879][Has Null: false, Has No Null: true]", min, max));
+	REQUIRE(min == "-5");
+	REQUIRE(max == "122879");
+
+	// String bounds are followed by the string statistics.
+	REQUIRE(ParseSegmentMinMax("[Min: apple, Max: banana, Has Unicode: false, Max String Length: 6]", min, max));
+	REQUIRE(min == "apple");
+	REQUIRE(max == "banana");
+
+	REQUIRE(ParseSegmentMinMax("[Min: 2024-01-01 00:00:00, Max: 2024-12-31 23:59:59][Has Null: true]", min, max));
+	REQUIRE(min == "2024-01-01 00:00:00");
+	REQUIRE(max == "2024-12-31 23:59:59");
+
+	// A string bound containing the max marker makes the bounds ambiguous.
+	REQUIRE(!ParseSegmentMinMax("[Min: a, Max: , Max: z, Has Unicode: false, Max String Length: 9]", min, max));
+	REQUIRE(!ParseSegmentMinMax("[Min: a, Max: z, Max: , Has Unicode: false, Max String Length: 9]", min, max));
+
+	// All-NULL segments and statistics without bounds.
+	REQUIRE(!ParseSegmentMinMax("[Min: NULL, Max: NULL][Has Null: true, Has No Null: false]", min, max));
+	REQUIRE(!ParseSegmentMinMax("[Has Null: false, Has No Null: true]", min, max));
+	REQUIRE(!ParseSegmentMinMax("", min, max));
+}
@@ -0,0 +1,108 @@
+#include "catch/catch.hpp"
+#include "test_helpers.hpp"
+
+#include "wal_reader.hpp"
+
+#include "duckdb/common/file_system.hpp"
+
+using namespace duckdb; // NOLINT
+
+namespace {
+
+// Appends the version marker that starts every WAL file, as written by WriteAheadLog::WriteVersion(): field 100 with
+// WAL_VERSION (98), field 101 with the version, and the end of the object, without size or checksum.
+void AppendVersionMarker(vector<data_t> &wal, uint8_t version = 2) {
+	const data_t marker[] = {0x64, 0x00, 98, 0x65, 0x00, version, 0xFF, 0xFF};
+	wal.insert(wal.end(), marker, marker + sizeof(marker));
+}
+
+// Appends an entry of the given type with a payload of payload_size bytes (at least the type prefix).
+void AppendEntry(vector<data_t> &wal, uint8_t entry_type, uint64_t payload_size) {
+	const auto start = wal.size();
+	wal.resize(start + 2 * sizeof(uint64_t) + payload_size, 0);
+	Store<uint64_t>(payload_size, wal.data() + start);
+	Store<uint16_t>(100, wal.data() + start + 2 * sizeof(uint64_t));
+	wal[start + 2 * sizeof(uint64_t) + sizeof(uint16_t)] = entry_type;
+}
+
+WalSummary ReadWal(const vector<data_t> &wal) {
+	auto fs = FileSystem::CreateLocal();
+	const auto path = TestCreatePath("wal_reader_test.wal");
+	if (fs->FileExists(path)) {
+		fs->RemoveFile(path);
+	}
+	{
+		auto handle = fs->OpenFile(path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE);
+		handle->Write(const_cast<data_ptr_t>(wal.data()), wal.size(), 0);
+		handle->Sync();
+	}
+	return ReadWalSummary(*fs, path);
+}
+
+} // namespace
+
+TEST_CASE("ReadWalSummary counts entries and commits", "[wal_reader]") {
+	vector<data_t> wal;
+	// Version marker, then two transactions: use table + insert + flush, use table + delete + flush
+	AppendVersionMarker(wal);
+	AppendEntry(wal, 25, 30);
+	AppendEntry(wal, 26, 1000);
+	AppendEntry(wal, 100, 3);
+	AppendEntry(wal, 25, 30);
+	AppendEntry(wal, 27, 100);
+	AppendEntry(wal, 100, 3);
+
+	auto summary = ReadWal(wal);
+	REQUIRE(summary.readable);
+	REQUIRE(summary.file_bytes == wal.size());
+	REQUIRE(summary.entry_count == 6);
+	REQUIRE(summary.commit_count == 2);
+	REQUIRE(summary.trailing_bytes == 0);
+
+	// An entry still being written is not counted.
+	const auto complete_size = wal.size();
+	AppendEntry(wal, 26, 1000);
+	wal.resize(wal.size() - 500);
+	summary = ReadWal(wal);
+	REQUIRE(summary.entry_count == 6);
+	REQUIRE(summary.trailing_bytes == wal.size() - complete_size);
+}
+
+TEST_CASE("ReadWalSummary reads the version marker", "[wal_reader]") {
+	// A log with only the version marker has no entries.
+	vector<data_t> wal;
+	AppendVersionMarker(wal);
+	auto summary = ReadWal(wal);
+	REQUIRE(summary.readable);
+	REQUIRE(summary.entry_count == 0);
+	REQUIRE(summary.trailing_bytes == 0);
+
+	// A marker that is still being written leaves the whole file trailing.
+	wal.resize(5);
+	summary = ReadWal(wal);
+	REQUIRE(summary.readable);
+	REQUIRE(summary.entry_count == 0);
+	REQUIRE(summary.trailing_bytes == 5);
+
+	// Encrypted logs have another version and their entries can't be counted.
+	wal.clear();
+	AppendVersionMarker(wal, 3);
+	AppendEntry(wal, 100, 3);
+	summary = ReadWal(wal);
+	REQUIRE(!summary.readable);
+	REQUIRE(summary.entry_count == 0);
+}
+
+TEST_CASE("ReadWalSummary handles missing and unknown files", "[wal_reader]") {
+	auto fs = FileSystem::CreateLocal();
+	const auto missing = ReadWalSummary(*fs, TestCreatePath("wal_reader_missing.wal"));
+	REQUIRE(missing.readable);
+	REQUIRE(missing.file_bytes == 0);
+	REQUIRE(missing.entry_count == 0);
+
+	vector<data_t> garbage(64, 0xAB);
+	Store<uint64_t>(8, garbage.data());
+	const auto unknown = ReadWal(garbage);
+	REQUIRE(!unknown.readable);
+	REQUIRE(unknown.entry_count == 0);
+}